@@ -0,0 +1,278 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <quicktle/archivereader.h>
+#include <quicktle/bulkreader.h>
+#include <quicktle/catalog.h>
+#include <quicktle/generator.h>
+#include <quicktle/historyarchive.h>
+#include <quicktle/snapshot.h>
+#include <quicktle/stream.h>
+#include "catalog.h"
+
+using namespace quicktle;
+
+//! Benchmark catalog, read from the text
+inline const Catalog& benchParsedCatalog()
+{
+    static Catalog catalog;
+    if (catalog.size())
+        return catalog;
+
+    std::istringstream source(benchText(ThreeLines));
+    Stream tle(source, ThreeLines);
+    while (tle)
+        tle >> catalog;
+
+    return catalog;
+}
+//------------------------------------------------------------------------------
+
+//
+//---- BENCHMARKS --------------------------------------------------------------
+
+//! Cold start from the text: reading and parsing of all records
+static void BM_CatalogRead(benchmark::State &state)
+{
+    const std::string text = benchText(ThreeLines);
+    for (auto _ : state)
+    {
+        std::istringstream source(text);
+        Stream tle(source, ThreeLines);
+        tle.enforceParsing(true);
+        Catalog catalog;
+        while (tle)
+            tle >> catalog;
+        benchmark::DoNotOptimize(catalog.size());
+    }
+    state.SetItemsProcessed(state.iterations() * BENCH_CATALOG_SIZE);
+}
+BENCHMARK(BM_CatalogRead);
+//------------------------------------------------------------------------------
+
+//! Cold start from the snapshot: the records are used without parsing
+static void BM_SnapshotAttach(benchmark::State &state)
+{
+    std::ostringstream image;
+    Snapshot::write(benchParsedCatalog(), image);
+    const std::string data = image.str();
+    Node node;
+    for (auto _ : state)
+    {
+        Snapshot snapshot;
+        snapshot.attach(data.data(), data.size());
+        snapshot.nearestNode("01000", 0, node);
+        benchmark::DoNotOptimize(node.n());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SnapshotAttach);
+//------------------------------------------------------------------------------
+
+static void BM_SnapshotLoad(benchmark::State &state)
+{
+    std::ostringstream image;
+    Snapshot::write(benchParsedCatalog(), image);
+    const std::string data = image.str();
+    Snapshot snapshot;
+    snapshot.attach(data.data(), data.size());
+    for (auto _ : state)
+    {
+        Catalog catalog;
+        snapshot.load(catalog);
+        benchmark::DoNotOptimize(catalog.size());
+    }
+    state.SetItemsProcessed(state.iterations() * snapshot.recordsCount());
+}
+BENCHMARK(BM_SnapshotLoad);
+//------------------------------------------------------------------------------
+
+//! Daily update: the next epoch of every satellite is merged
+static void BM_CatalogMerge(benchmark::State &state)
+{
+    Generator generator(BENCH_SEED);
+    generator.setSatellitesCount(BENCH_CATALOG_SIZE);
+    generator.setEpochsCount(2);
+    std::string delta;
+    std::string line1, line2, line3;
+    for (std::size_t i = 0; i < BENCH_CATALOG_SIZE; ++i)
+    {
+        generator.record(i, 1, line1, line2, line3);
+        delta += line2 + "\n" + line3 + "\n";
+    }
+
+    std::vector<std::string> changed;
+    Catalog catalog;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        catalog = benchParsedCatalog();
+        std::istringstream source(delta);
+        Stream tle(source);
+        state.ResumeTiming();
+        catalog.merge(tle, &changed);
+    }
+    state.SetItemsProcessed(state.iterations() * BENCH_CATALOG_SIZE);
+}
+BENCHMARK(BM_CatalogMerge);
+//------------------------------------------------------------------------------
+
+//! History of one satellite from the archive of 64 deliveries
+static void BM_ArchiveReaderRead(benchmark::State &state)
+{
+    const std::string archiveName = "bench_archive.tle";
+    Generator generator(BENCH_SEED);
+    generator.setSatellitesCount(BENCH_CATALOG_SIZE);
+    generator.setEpochsCount(64);
+    generator.setFileType(ThreeLines);
+    generator.write(archiveName);
+    std::remove(ArchiveIndex::fileName(archiveName).c_str());
+
+    ArchiveReader reader;
+    reader.open(archiveName, ThreeLines);
+    std::size_t count = 0;
+    std::size_t k = 0;
+    for (auto _ : state)
+    {
+        DataSet dataSet;
+        const BenchRecord &record = benchCatalog()[k++ % BENCH_CATALOG_SIZE];
+        count += reader.read(record.line2.substr(2, 5), 0, 1e10, dataSet);
+    }
+    state.SetItemsProcessed(count);
+
+    reader.close();
+    std::remove(ArchiveIndex::fileName(archiveName).c_str());
+    std::remove(archiveName.c_str());
+}
+BENCHMARK(BM_ArchiveReaderRead);
+//------------------------------------------------------------------------------
+
+/*
+  Decoding of the history archive of 64 deliveries: 0 - Node objects,
+  1 - element columns. Compare with BM_CatalogRead (text parsing).
+*/
+static void BM_HistoryRead(benchmark::State &state)
+{
+    const std::string fileName = "bench_history.qth";
+    Generator generator(BENCH_SEED);
+    generator.setSatellitesCount(BENCH_CATALOG_SIZE);
+    generator.setEpochsCount(64);
+    generator.setFileType(ThreeLines);
+    HistoryWriter writer;
+    writer.open(fileName);
+    for (std::size_t satellite = 0; satellite < BENCH_CATALOG_SIZE;
+         ++satellite)
+    {
+        for (std::size_t epoch = 0; epoch < 64; ++epoch)
+            writer.append(generator.node(satellite, epoch));
+    }
+    writer.close();
+
+    HistoryReader reader;
+    reader.open(fileName);
+    const bool columnsOnly = state.range(0);
+    std::size_t count = 0;
+    std::size_t k = 0;
+    for (auto _ : state)
+    {
+        const std::size_t satellite = k++ % reader.satellitesCount();
+        if (columnsOnly)
+        {
+            HistoryBlock::Columns columns;
+            reader.read(satellite, columns);
+            count += columns.size();
+        }
+        else
+        {
+            DataSet dataSet;
+            reader.read(satellite, dataSet);
+            count += dataSet.size();
+        }
+    }
+    state.SetItemsProcessed(count);
+
+    reader.close();
+    std::remove(fileName.c_str());
+}
+BENCHMARK(BM_HistoryRead)->Arg(0)->Arg(1);
+//------------------------------------------------------------------------------
+
+/*
+  Loading of 1024 files with one satellite each: 0 - sequential
+  std::ifstream and Stream, 1 - BulkReader with pread(),
+  2 - BulkReader with io_uring.
+*/
+static void BM_BulkRead(benchmark::State &state)
+{
+    std::vector<std::string> fileNames;
+    for (std::size_t satellite = 0; satellite < 1024; ++satellite)
+    {
+        Generator generator(BENCH_SEED + satellite);
+        generator.setSatellitesCount(1);
+        generator.setEpochsCount(4);
+        generator.setFirstSatelliteNumber(satellite + 1);
+        generator.setFileType(ThreeLines);
+        std::ostringstream name;
+        name << "bench_bulk_" << satellite << ".tle";
+        fileNames.push_back(name.str());
+        generator.write(name.str());
+    }
+
+    const BulkReader::Method method = (state.range(0) == 1)
+                                    ? BulkReader::Pread
+                                    : BulkReader::IoUring;
+    if (state.range(0) == 2 && !BulkReader::ioUringAvailable())
+        state.SkipWithError("io_uring is unavailable");
+
+    std::size_t count = 0;
+    for (auto _ : state)
+    {
+        Catalog catalog;
+        if (state.range(0))
+        {
+            BulkReader reader(ThreeLines);
+            reader.setMethod(method);
+            reader.read(fileNames, catalog);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < fileNames.size(); ++i)
+            {
+                std::ifstream file(fileNames[i].c_str());
+                Stream tle(file, ThreeLines);
+                tle.enforceParsing(true);
+                while (tle)
+                    tle >> catalog;
+            }
+        }
+        count += catalog.nodesCount();
+    }
+    state.SetItemsProcessed(count);
+
+    for (std::size_t i = 0; i < fileNames.size(); ++i)
+        std::remove(fileNames[i].c_str());
+}
+BENCHMARK(BM_BulkRead)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+//------------------------------------------------------------------------------
@@ -0,0 +1,118 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <ctime>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <quicktle/dataset.h>
+#include "catalog.h"
+
+using namespace quicktle;
+
+//! History of one satellite: range(0) nodes with the step of 6 hours
+static std::vector<Node> benchHistory(std::size_t size)
+{
+    const std::vector<BenchRecord> &catalog = benchCatalog();
+    Node node(catalog[0].line2, catalog[0].line3, true);
+    const double start = node.preciseEpoch();
+
+    std::vector<Node> history;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        node.setPreciseEpoch(start + i * 6 * 3600.);
+        history.push_back(node);
+    }
+
+    return history;
+}
+
+//
+//---- BENCHMARKS --------------------------------------------------------------
+
+static void BM_DataSetAppend(benchmark::State &state)
+{
+    std::vector<Node> history = benchHistory(state.range(0));
+    if (state.range(1))
+    {
+        std::mt19937 random(20150101);
+        std::shuffle(history.begin(), history.end(), random);
+    }
+
+    for (auto _ : state)
+    {
+        DataSet dataSet;
+        for (std::size_t i = 0; i < history.size(); ++i)
+            dataSet.append(history[i]);
+        benchmark::DoNotOptimize(dataSet.size());
+    }
+    state.SetItemsProcessed(state.iterations() * history.size());
+}
+BENCHMARK(BM_DataSetAppend)->Args({1 << 10, 0})->Args({1 << 10, 1})
+                           ->Args({1 << 14, 0});
+//------------------------------------------------------------------------------
+
+static void BM_DataSetNearestNode(benchmark::State &state)
+{
+    const std::vector<Node> history = benchHistory(state.range(0));
+    DataSet dataSet;
+    for (std::size_t i = 0; i < history.size(); ++i)
+        dataSet.append(history[i]);
+
+    const std::time_t first = history.front().epoch();
+    const std::time_t span = history.back().epoch() - first;
+    std::time_t t = first;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(&dataSet.nearestNode(t));
+        t = first + (t - first + 7919) % span;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DataSetNearestNode)->Range(1 << 6, 1 << 16);
+//------------------------------------------------------------------------------
+
+/*
+  Search in the compressed history of 16384 nodes: 0 - in the recent
+  decoded window, 1 - in the whole history (the blocks are decoded).
+*/
+static void BM_DataSetNearestCompressed(benchmark::State &state)
+{
+    const std::vector<Node> history = benchHistory(1 << 14);
+    DataSet dataSet;
+    dataSet.setCompression(256, 256);
+    for (std::size_t i = 0; i < history.size(); ++i)
+        dataSet.append(history[i]);
+
+    const std::time_t last = history.back().epoch();
+    const std::time_t span = state.range(0)
+                           ? last - history.front().epoch()
+                           : 256 * 6 * 3600;
+    std::time_t t = last;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(&dataSet.nearestNode(t));
+        t = last - (last - t + 7919) % span;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DataSetNearestCompressed)->Arg(0)->Arg(1);
+//------------------------------------------------------------------------------
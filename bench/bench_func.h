@@ -0,0 +1,126 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <string>
+#include <benchmark/benchmark.h>
+#include <quicktle/func.h>
+#include <quicktle/node.h>
+#include "catalog.h"
+
+using namespace quicktle;
+
+//! Provides access to the protected Node::checkLine() method
+class NodeAccess: public Node
+{
+public:
+    using Node::checkLine;
+};
+
+//
+//---- BENCHMARKS --------------------------------------------------------------
+
+static void BM_checkLine(benchmark::State &state)
+{
+    const std::vector<BenchRecord> &catalog = benchCatalog();
+    NodeAccess node;
+    std::size_t k = 0;
+    for (auto _ : state)
+    {
+        const BenchRecord &record = catalog[k++ % catalog.size()];
+        benchmark::DoNotOptimize(node.checkLine(record.line2));
+        benchmark::DoNotOptimize(node.checkLine(record.line3));
+    }
+    state.SetItemsProcessed(2 * state.iterations());
+}
+BENCHMARK(BM_checkLine);
+//------------------------------------------------------------------------------
+
+static void BM_checksum(benchmark::State &state)
+{
+    const std::vector<BenchRecord> &catalog = benchCatalog();
+    std::size_t k = 0;
+    for (auto _ : state)
+    {
+        const BenchRecord &record = catalog[k++ % catalog.size()];
+        benchmark::DoNotOptimize(checksum(record.line2));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_checksum);
+//------------------------------------------------------------------------------
+
+static void BM_parseDouble(benchmark::State &state)
+{
+    const std::vector<BenchRecord> &catalog = benchCatalog();
+    std::size_t k = 0;
+    for (auto _ : state)
+    {
+        const BenchRecord &record = catalog[k++ % catalog.size()];
+        Node::ErrorCode error = Node::NoError;
+        benchmark::DoNotOptimize(parseDouble(record.line3, 52, 11, error));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_parseDouble);
+//------------------------------------------------------------------------------
+
+static void BM_string2date(benchmark::State &state)
+{
+    const std::vector<BenchRecord> &catalog = benchCatalog();
+    std::size_t k = 0;
+    for (auto _ : state)
+    {
+        const BenchRecord &record = catalog[k++ % catalog.size()];
+        Node::ErrorCode error = Node::NoError;
+        benchmark::DoNotOptimize(string2date(record.line2.substr(18, 14),
+                                             error));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_string2date);
+//------------------------------------------------------------------------------
+
+static void BM_double2string(benchmark::State &state)
+{
+    double value = 15.72125391;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(double2string(value, 11, 8,
+                                               false, false, false));
+        value += 1e-8;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_double2string);
+//------------------------------------------------------------------------------
+
+static void BM_date2string(benchmark::State &state)
+{
+    Node::ErrorCode error = Node::NoError;
+    double date = string2date("24123.51234567", error);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(date2string(date, 14));
+        date += 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_date2string);
+//------------------------------------------------------------------------------
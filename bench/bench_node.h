@@ -0,0 +1,207 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <quicktle/node.h>
+#include <quicktle/nodeview.h>
+#include "catalog.h"
+
+using namespace quicktle;
+
+//! Parsed copies of the benchmark catalog
+static const std::vector<Node>& benchNodes()
+{
+    static std::vector<Node> nodes;
+    if (!nodes.empty())
+        return nodes;
+
+    const std::vector<BenchRecord> &catalog = benchCatalog();
+    for (std::size_t i = 0; i < catalog.size(); ++i)
+        nodes.push_back(Node(catalog[i].line1, catalog[i].line2,
+                             catalog[i].line3, true));
+
+    return nodes;
+}
+
+//
+//---- BENCHMARKS --------------------------------------------------------------
+
+static void BM_NodeAssign(benchmark::State &state)
+{
+    const std::vector<BenchRecord> &catalog = benchCatalog();
+    const bool forceParsing = state.range(0);
+    std::size_t k = 0;
+    for (auto _ : state)
+    {
+        const BenchRecord &record = catalog[k++ % catalog.size()];
+        Node node(record.line1, record.line2, record.line3, forceParsing);
+        benchmark::DoNotOptimize(node.lastError());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NodeAssign)->Arg(0)->Arg(1);
+//------------------------------------------------------------------------------
+
+/*
+  The first call of a getter parses the field (lazy initialization),
+  so the node is assigned in every iteration: subtract BM_NodeAssign/0
+  to get the cost of parsing itself.
+*/
+template <typename T>
+static void BM_NodeParse(benchmark::State &state, T (Node::*getter)() const)
+{
+    const std::vector<BenchRecord> &catalog = benchCatalog();
+    std::size_t k = 0;
+    for (auto _ : state)
+    {
+        const BenchRecord &record = catalog[k++ % catalog.size()];
+        Node node(record.line1, record.line2, record.line3);
+        benchmark::DoNotOptimize((node.*getter)());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_NodeParse, satelliteNumber, &Node::satelliteNumber);
+BENCHMARK_CAPTURE(BM_NodeParse, satelliteName, &Node::satelliteName);
+BENCHMARK_CAPTURE(BM_NodeParse, designator, &Node::designator);
+BENCHMARK_CAPTURE(BM_NodeParse, n, &Node::n);
+BENCHMARK_CAPTURE(BM_NodeParse, dn, &Node::dn);
+BENCHMARK_CAPTURE(BM_NodeParse, d2n, &Node::d2n);
+BENCHMARK_CAPTURE(BM_NodeParse, i, &Node::i);
+BENCHMARK_CAPTURE(BM_NodeParse, Omega, &Node::Omega);
+BENCHMARK_CAPTURE(BM_NodeParse, omega, &Node::omega);
+BENCHMARK_CAPTURE(BM_NodeParse, M, &Node::M);
+BENCHMARK_CAPTURE(BM_NodeParse, bstar, &Node::bstar);
+BENCHMARK_CAPTURE(BM_NodeParse, e, &Node::e);
+BENCHMARK_CAPTURE(BM_NodeParse, classification, &Node::classification);
+BENCHMARK_CAPTURE(BM_NodeParse, ephemerisType, &Node::ephemerisType);
+BENCHMARK_CAPTURE(BM_NodeParse, preciseEpoch, &Node::preciseEpoch);
+BENCHMARK_CAPTURE(BM_NodeParse, elementNumber, &Node::elementNumber);
+BENCHMARK_CAPTURE(BM_NodeParse, revolutionNumber, &Node::revolutionNumber);
+//------------------------------------------------------------------------------
+
+//! Getters of already parsed nodes
+template <typename T>
+static void BM_NodeGet(benchmark::State &state, T (Node::*getter)() const)
+{
+    const std::vector<Node> &nodes = benchNodes();
+    std::size_t k = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize((nodes[k++ % nodes.size()].*getter)());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_NodeGet, satelliteNumber, &Node::satelliteNumber);
+BENCHMARK_CAPTURE(BM_NodeGet, n, &Node::n);
+BENCHMARK_CAPTURE(BM_NodeGet, preciseEpoch, &Node::preciseEpoch);
+BENCHMARK_CAPTURE(BM_NodeGet, epoch, &Node::epoch);
+BENCHMARK_CAPTURE(BM_NodeGet, E, &Node::E);
+BENCHMARK_CAPTURE(BM_NodeGet, nu, &Node::nu);
+BENCHMARK_CAPTURE(BM_NodeGet, r, &Node::r);
+BENCHMARK_CAPTURE(BM_NodeGet, x, &Node::x);
+BENCHMARK_CAPTURE(BM_NodeGet, y, &Node::y);
+BENCHMARK_CAPTURE(BM_NodeGet, z, &Node::z);
+BENCHMARK_CAPTURE(BM_NodeGet, vx, &Node::vx);
+BENCHMARK_CAPTURE(BM_NodeGet, vy, &Node::vy);
+BENCHMARK_CAPTURE(BM_NodeGet, vz, &Node::vz);
+//------------------------------------------------------------------------------
+
+static void BM_secondString(benchmark::State &state)
+{
+    const std::vector<Node> &nodes = benchNodes();
+    std::size_t k = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(nodes[k++ % nodes.size()].secondString());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_secondString);
+//------------------------------------------------------------------------------
+
+static void BM_thirdString(benchmark::State &state)
+{
+    const std::vector<Node> &nodes = benchNodes();
+    std::size_t k = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(nodes[k++ % nodes.size()].thirdString());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_thirdString);
+//------------------------------------------------------------------------------
+
+static void BM_NodeOutput(benchmark::State &state)
+{
+    const std::vector<Node> &nodes = benchNodes();
+    std::ostringstream out;
+    std::size_t k = 0;
+    for (auto _ : state)
+    {
+        out << nodes[k++ % nodes.size()];
+        if (!(k % nodes.size()))
+            out.str(std::string());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NodeOutput);
+//------------------------------------------------------------------------------
+
+//! Output of modified nodes: the lines are regenerated from the parameters
+static void BM_NodeOutputModified(benchmark::State &state)
+{
+    std::vector<Node> nodes = benchNodes();
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+        nodes[i].set_n(nodes[i].n());
+
+    std::ostringstream out;
+    std::size_t k = 0;
+    for (auto _ : state)
+    {
+        out << nodes[k++ % nodes.size()];
+        if (!(k % nodes.size()))
+            out.str(std::string());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NodeOutputModified);
+//------------------------------------------------------------------------------
+
+//! Parsing in place: compare with BM_NodeParse, which copies the lines
+template <typename T>
+static void BM_NodeViewParse(benchmark::State &state,
+                             T (NodeView::*getter)() const)
+{
+    const std::vector<BenchRecord> &catalog = benchCatalog();
+    std::size_t k = 0;
+    for (auto _ : state)
+    {
+        const BenchRecord &record = catalog[k++ % catalog.size()];
+        NodeView view(record.line1.data(), record.line1.length(),
+                      record.line2.data(), record.line2.length(),
+                      record.line3.data(), record.line3.length());
+        benchmark::DoNotOptimize((view.*getter)());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_NodeViewParse, satelliteNumber,
+                  &NodeView::satelliteNumber);
+BENCHMARK_CAPTURE(BM_NodeViewParse, n, &NodeView::n);
+BENCHMARK_CAPTURE(BM_NodeViewParse, bstar, &NodeView::bstar);
+BENCHMARK_CAPTURE(BM_NodeViewParse, preciseEpoch, &NodeView::preciseEpoch);
+//------------------------------------------------------------------------------
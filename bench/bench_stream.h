@@ -0,0 +1,325 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <benchmark/benchmark.h>
+#include <quicktle/archiveindex.h>
+#include <quicktle/archivesorter.h>
+#include <quicktle/columnbatch.h>
+#include <quicktle/compressedinput.h>
+#include <quicktle/dataset.h>
+#include <quicktle/generator.h>
+#include <quicktle/pipelinedstream.h>
+#include <quicktle/recordfilter.h>
+#include <quicktle/stream.h>
+#include <quicktle/tolerantstream.h>
+#include <quicktle/validator.h>
+#include "catalog.h"
+
+#ifdef QUICKTLE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace quicktle;
+
+//
+//---- BENCHMARKS --------------------------------------------------------------
+
+/*
+  Read the whole catalog: range(0) is the file type,
+  range(1) is the parsing mode.
+*/
+static void BM_StreamRead(benchmark::State &state)
+{
+    const FileType fileType = static_cast<FileType>(state.range(0));
+    const std::string text = benchText(fileType);
+    std::size_t count = 0;
+    for (auto _ : state)
+    {
+        std::istringstream source(text);
+        Stream tle(source, fileType);
+        tle.enforceParsing(state.range(1));
+        Node node;
+        while (tle)
+        {
+            tle >> node;
+            ++count;
+        }
+    }
+    state.SetItemsProcessed(count);
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_StreamRead)->Args({TwoLines, 0})->Args({ThreeLines, 0})
+                        ->Args({ThreeLines, 1});
+//------------------------------------------------------------------------------
+
+//! The same as BM_StreamRead, the input is read ahead by the helper thread
+static void BM_PipelinedRead(benchmark::State &state)
+{
+    const FileType fileType = static_cast<FileType>(state.range(0));
+    const std::string text = benchText(fileType);
+    std::size_t count = 0;
+    for (auto _ : state)
+    {
+        std::istringstream source(text);
+        PipelinedStream tle(source, fileType);
+        tle.enforceParsing(state.range(1));
+        Node node;
+        while (tle)
+        {
+            tle >> node;
+            ++count;
+        }
+    }
+    state.SetItemsProcessed(count);
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_PipelinedRead)->Args({TwoLines, 0})->Args({ThreeLines, 0})
+                           ->Args({ThreeLines, 1})->UseRealTime();
+//------------------------------------------------------------------------------
+
+/*
+  The same as BM_StreamRead, the format of every record is detected
+  and the records are checked before the Node objects are made.
+*/
+static void BM_TolerantRead(benchmark::State &state)
+{
+    const FileType fileType = static_cast<FileType>(state.range(0));
+    const std::string text = benchText(fileType);
+    std::size_t count = 0;
+    for (auto _ : state)
+    {
+        std::istringstream source(text);
+        TolerantStream tle(source);
+        tle.enforceParsing(state.range(1));
+        Node node;
+        while (tle)
+        {
+            tle >> node;
+            ++count;
+        }
+    }
+    state.SetItemsProcessed(count);
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_TolerantRead)->Args({TwoLines, 0})->Args({ThreeLines, 0})
+                          ->Args({ThreeLines, 1});
+//------------------------------------------------------------------------------
+
+/*
+  Read and parse the records, which pass the filter: range(0) is 0 for
+  no filter, 1 for the mean motion above 11 revs per day, 2 for 10
+  satellites.
+*/
+static void BM_TolerantReadFiltered(benchmark::State &state)
+{
+    const std::string text = benchText(ThreeLines);
+    RecordFilter filter;
+    if (state.range(0) == 1)
+    {
+        filter.addRange(RecordFilter::MeanMotion, 11 * 2 * M_PI / 86400, 1);
+    }
+    else if (state.range(0) == 2)
+    {
+        const std::vector<BenchRecord> &catalog = benchCatalog();
+        for (std::size_t i = 0; i < catalog.size(); i += catalog.size() / 10)
+            filter.addSatellite(catalog[i].line2.substr(2, 5));
+    }
+
+    std::size_t count = 0;
+    for (auto _ : state)
+    {
+        std::istringstream source(text);
+        TolerantStream tle(source);
+        tle.setFilter(filter);
+        tle.enforceParsing(true);
+        Node node;
+        while (tle)
+        {
+            tle >> node;
+            ++count;
+        }
+    }
+    state.SetItemsProcessed(count);
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_TolerantReadFiltered)->Arg(0)->Arg(1)->Arg(2);
+//------------------------------------------------------------------------------
+
+/*
+  Read only the epoch, the mean motion and the eccentricity into
+  the columns, compare with BM_TolerantRead/1/1.
+*/
+static void BM_ProjectedRead(benchmark::State &state)
+{
+    const std::string text = benchText(ThreeLines);
+    std::size_t count = 0;
+    for (auto _ : state)
+    {
+        std::istringstream source(text);
+        TolerantStream tle(source);
+        ColumnBatch batch;
+        batch.addField(ColumnBatch::Epoch);
+        batch.addField(ColumnBatch::MeanMotion);
+        batch.addField(ColumnBatch::Eccentricity);
+        while (tle)
+            tle >> batch;
+        count += batch.size();
+    }
+    state.SetItemsProcessed(count);
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ProjectedRead);
+//------------------------------------------------------------------------------
+
+static void BM_StreamReadDataSet(benchmark::State &state)
+{
+    const std::string text = benchText(TwoLines);
+    std::size_t count = 0;
+    for (auto _ : state)
+    {
+        std::istringstream source(text);
+        Stream tle(source, TwoLines);
+        DataSet dataSet;
+        while (tle)
+            tle >> dataSet;
+        count += dataSet.size();
+    }
+    state.SetItemsProcessed(count);
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_StreamReadDataSet);
+//------------------------------------------------------------------------------
+
+#ifdef QUICKTLE_ZLIB
+/*
+  Read and parse the gzip compressed catalog: range(0) is 1 if the data
+  are decompressed by the helper thread. Compare with BM_StreamRead/1/1.
+*/
+static void BM_CompressedRead(benchmark::State &state)
+{
+    const std::string text = benchText(ThreeLines);
+    z_stream stream = z_stream();
+    deflateInit2(&stream, 6, Z_DEFLATED, 16 + MAX_WBITS, 8,
+                 Z_DEFAULT_STRATEGY);
+    std::string data(deflateBound(&stream, text.size()), '\0');
+    stream.next_in = (Bytef*)text.data();
+    stream.avail_in = text.size();
+    stream.next_out = (Bytef*)&data[0];
+    stream.avail_out = data.size();
+    deflate(&stream, Z_FINISH);
+    data.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    std::size_t count = 0;
+    for (auto _ : state)
+    {
+        std::istringstream source(data);
+        CompressedInput input;
+        input.setThreaded(state.range(0));
+        input.open(source, CompressedInput::Gzip);
+        Stream tle(input, ThreeLines);
+        tle.enforceParsing(true);
+        Node node;
+        while (tle)
+        {
+            tle >> node;
+            ++count;
+        }
+    }
+    state.SetItemsProcessed(count);
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_CompressedRead)->Arg(0)->Arg(1)->UseRealTime();
+//------------------------------------------------------------------------------
+#endif
+
+static void BM_ValidatorScan(benchmark::State &state)
+{
+    const std::string text = benchText(ThreeLines);
+    Validator validator(ThreeLines);
+    std::size_t count = 0;
+    for (auto _ : state)
+    {
+        validator.scan(text.data(), text.size());
+        count += validator.recordsCount();
+    }
+    state.SetItemsProcessed(count);
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ValidatorScan);
+//------------------------------------------------------------------------------
+
+//! Projected scan: compare with BM_StreamReadDataSet
+static void BM_ArchiveIndexScan(benchmark::State &state)
+{
+    const std::string text = benchText(ThreeLines);
+    ArchiveIndex index(ThreeLines);
+    std::size_t count = 0;
+    for (auto _ : state)
+        count += index.scan(text.data(), text.size());
+    state.SetItemsProcessed(count);
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ArchiveIndexScan);
+//------------------------------------------------------------------------------
+
+//! Sorting of 16 deliveries, the argument is the memory limit [MiB]
+static void BM_ArchiveSorterSort(benchmark::State &state)
+{
+    Generator generator(BENCH_SEED);
+    generator.setSatellitesCount(BENCH_CATALOG_SIZE);
+    generator.setEpochsCount(16);
+    generator.setFileType(ThreeLines);
+    std::ostringstream text;
+    const std::size_t count = generator.write(text);
+
+    ArchiveSorter sorter(ThreeLines);
+    sorter.setMemoryLimit(state.range(0) << 20);
+    for (auto _ : state)
+    {
+        std::istringstream input(text.str());
+        std::ostringstream output;
+        sorter.sort(input, output);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["runs"] = sorter.runsCount();
+}
+BENCHMARK(BM_ArchiveSorterSort)->Arg(1)->Arg(256);
+//------------------------------------------------------------------------------
+
+static void BM_GeneratorWrite(benchmark::State &state)
+{
+    Generator generator(BENCH_SEED);
+    generator.setSatellitesCount(BENCH_CATALOG_SIZE);
+    generator.setFileType(ThreeLines);
+    std::size_t count = 0;
+    for (auto _ : state)
+    {
+        std::ostringstream out;
+        count += generator.write(out);
+        benchmark::DoNotOptimize(out.tellp());
+    }
+    state.SetItemsProcessed(count);
+}
+BENCHMARK(BM_GeneratorWrite);
+//------------------------------------------------------------------------------
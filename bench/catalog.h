@@ -0,0 +1,80 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+/*
+  Catalog for benchmarks: the mix of LEO, MEO, GEO and HEO objects,
+  produced by quicktle::Generator.
+*/
+
+#ifndef BENCH_CATALOG_H
+#define BENCH_CATALOG_H
+
+#include <string>
+#include <vector>
+#include <quicktle/generator.h>
+#include <quicktle/node.h>
+
+#define BENCH_CATALOG_SIZE 4096
+#define BENCH_SEED 20150101
+
+struct BenchRecord
+{
+    std::string line1;
+    std::string line2;
+    std::string line3;
+};
+
+inline const std::vector<BenchRecord>& benchCatalog()
+{
+    static std::vector<BenchRecord> catalog;
+    if (!catalog.empty())
+        return catalog;
+
+    quicktle::Generator generator(BENCH_SEED);
+    generator.setSatellitesCount(BENCH_CATALOG_SIZE);
+    generator.setFileType(quicktle::ThreeLines);
+    for (std::size_t index = 0; index < BENCH_CATALOG_SIZE; ++index)
+    {
+        BenchRecord record;
+        generator.record(index, 0, record.line1, record.line2, record.line3);
+        catalog.push_back(record);
+    }
+
+    return catalog;
+}
+//------------------------------------------------------------------------------
+
+inline std::string benchText(quicktle::FileType fileType)
+{
+    const std::vector<BenchRecord> &catalog = benchCatalog();
+    std::string text;
+    for (std::size_t i = 0; i < catalog.size(); ++i)
+    {
+        if (fileType == quicktle::ThreeLines)
+            text += catalog[i].line1 + "\n";
+        text += catalog[i].line2 + "\n";
+        text += catalog[i].line3 + "\n";
+    }
+
+    return text;
+}
+//------------------------------------------------------------------------------
+
+#endif // BENCH_CATALOG_H
@@ -0,0 +1,230 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+/*
+  Minimal JSON reader and writer, sufficient for Google Benchmark
+  reports and the baseline file of the regression harness.
+*/
+
+#ifndef BENCH_JSON_H
+#define BENCH_JSON_H
+
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct JsonValue
+{
+    enum Type
+    {
+        Null,
+        Boolean,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    JsonValue() : type(Null), number(0) {}
+
+    //! Find the member of the object by the key; 0 if it is absent
+    const JsonValue* find(const std::string &key) const
+    {
+        for (std::size_t i = 0; i < members.size(); ++i)
+        {
+            if (members[i].first == key)
+                return &members[i].second;
+        }
+
+        return 0;
+    }
+
+    Type type;
+    double number;                //!< Number or boolean value
+    std::string string;
+    std::vector<JsonValue> items; //!< Array items
+    std::vector<std::pair<std::string, JsonValue> > members;
+};
+
+class JsonParser
+{
+public:
+    explicit JsonParser(const std::string &text) : m_text(text), m_pos(0) {}
+
+    //! Parse the whole text. Returns false if the text is not valid JSON.
+    bool parse(JsonValue &value)
+    {
+        if (!parseValue(value))
+            return false;
+
+        skipSpaces();
+        return m_pos == m_text.size();
+    }
+
+private:
+    void skipSpaces()
+    {
+        while (m_pos < m_text.size() && isspace(m_text[m_pos]))
+            ++m_pos;
+    }
+
+    bool expect(char c)
+    {
+        skipSpaces();
+        if (m_pos >= m_text.size() || m_text[m_pos] != c)
+            return false;
+
+        ++m_pos;
+        return true;
+    }
+
+    bool parseValue(JsonValue &value)
+    {
+        skipSpaces();
+        if (m_pos >= m_text.size())
+            return false;
+
+        const char c = m_text[m_pos];
+        if (c == '{')
+            return parseObject(value);
+        if (c == '[')
+            return parseArray(value);
+        if (c == '"')
+        {
+            value.type = JsonValue::String;
+            return parseString(value.string);
+        }
+        if (!m_text.compare(m_pos, 4, "true")
+            || !m_text.compare(m_pos, 5, "false"))
+        {
+            value.type = JsonValue::Boolean;
+            value.number = (c == 't');
+            m_pos += (c == 't') ? 4 : 5;
+            return true;
+        }
+        if (!m_text.compare(m_pos, 4, "null"))
+        {
+            value.type = JsonValue::Null;
+            m_pos += 4;
+            return true;
+        }
+
+        const char *start = m_text.c_str() + m_pos;
+        char *end = 0;
+        value.number = strtod(start, &end);
+        if (end == start)
+            return false;
+
+        value.type = JsonValue::Number;
+        m_pos += end - start;
+        return true;
+    }
+
+    bool parseString(std::string &str)
+    {
+        if (!expect('"'))
+            return false;
+
+        str.clear();
+        while (m_pos < m_text.size() && m_text[m_pos] != '"')
+        {
+            char c = m_text[m_pos++];
+            if (c == '\\' && m_pos < m_text.size())
+            {
+                c = m_text[m_pos++];
+                if (c == 'n')
+                    c = '\n';
+                else if (c == 't')
+                    c = '\t';
+                else if (c == 'u')
+                {
+                    // Non-ASCII symbols are not expected in the reports
+                    m_pos += 4;
+                    c = '?';
+                }
+            }
+            str += c;
+        }
+
+        return expect('"');
+    }
+
+    bool parseArray(JsonValue &value)
+    {
+        value.type = JsonValue::Array;
+        expect('[');
+        if (expect(']'))
+            return true;
+
+        do
+        {
+            value.items.push_back(JsonValue());
+            if (!parseValue(value.items.back()))
+                return false;
+        }
+        while (expect(','));
+
+        return expect(']');
+    }
+
+    bool parseObject(JsonValue &value)
+    {
+        value.type = JsonValue::Object;
+        expect('{');
+        if (expect('}'))
+            return true;
+
+        do
+        {
+            value.members.push_back(std::make_pair(std::string(),
+                                                   JsonValue()));
+            if (!parseString(value.members.back().first) || !expect(':')
+                || !parseValue(value.members.back().second))
+            {
+                return false;
+            }
+        }
+        while (expect(','));
+
+        return expect('}');
+    }
+
+    const std::string &m_text;
+    std::size_t m_pos;
+};
+
+//! Quote the string for JSON output
+inline std::string jsonString(const std::string &str)
+{
+    std::string res = "\"";
+    for (std::size_t i = 0; i < str.size(); ++i)
+    {
+        if (str[i] == '"' || str[i] == '\\')
+            res += '\\';
+        res += str[i];
+    }
+
+    return res + "\"";
+}
+
+#endif // BENCH_JSON_H
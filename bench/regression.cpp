@@ -0,0 +1,381 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+/*
+  Benchmark regression harness.
+
+  Runs the benchmark executable with repetitions, takes the median
+  CPU time of each benchmark and compares it with the baseline:
+
+      benchregression --benchmark <executable> --baseline <baseline.json>
+                      [--filter <regex>] [--repetitions <n>]
+                      [--min-time <seconds>] [--tolerance <ratio>]
+                      [--update]
+
+  The baseline file has the following structure:
+
+      {
+        "tolerance": 0.25,
+        "benchmarks": {
+          "BM_checkLine": { "median_ns": 1718.2 },
+          "BM_StreamRead/0/0": { "median_ns": 11453487, "tolerance": 0.4 }
+        }
+      }
+
+  "tolerance" is the allowed relative slowdown: the default one for all
+  benchmarks and, optionally, the specific one for a benchmark.
+  With --update option the baseline is rewritten with the current medians
+  (the tolerances are kept). With --filter only the chosen benchmarks are
+  updated, the other entries of the baseline are kept. Without --filter
+  a benchmark of the baseline, which is absent in the current run, is
+  reported as missing. The program returns 1 if any benchmark is slower
+  than allowed or missing and 2 if the benchmarks can not be run or
+  compared.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "json.h"
+
+#define DEFAULT_TOLERANCE 0.25
+#define DEFAULT_REPETITIONS 5
+#define DEFAULT_MIN_TIME "0.05"
+
+using namespace std;
+
+struct Result
+{
+    string name;
+    double current;   // ns
+    double baseline;  // ns, 0 if the benchmark is absent in the baseline
+    double tolerance; // < 0 if it is not specified for this benchmark
+};
+
+static double nanoseconds(double value, const string &unit)
+{
+    if (unit == "us")
+        return value * 1e3;
+    if (unit == "ms")
+        return value * 1e6;
+    if (unit == "s")
+        return value * 1e9;
+
+    return value;
+}
+//------------------------------------------------------------------------------
+
+static bool readFile(const string &fileName, string &text)
+{
+    ifstream file(fileName.c_str());
+    if (!file)
+        return false;
+
+    stringstream buf;
+    buf << file.rdbuf();
+    text = buf.str();
+    return true;
+}
+//------------------------------------------------------------------------------
+
+static bool runBenchmarks(const string &command, string &output)
+{
+    FILE *pipe = popen(command.c_str(), "r");
+    if (!pipe)
+        return false;
+
+    char buf[4096];
+    size_t length;
+    while ((length = fread(buf, 1, sizeof(buf), pipe)) > 0)
+        output.append(buf, length);
+
+    return pclose(pipe) == 0;
+}
+//------------------------------------------------------------------------------
+
+static bool writeBaseline(const string &fileName, double tolerance,
+                          const vector<Result> &results)
+{
+    ofstream file(fileName.c_str());
+    file << "{\n  \"tolerance\": " << tolerance << ",\n"
+         << "  \"benchmarks\": {\n";
+    file.precision(10);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        file << "    " << jsonString(results[i].name)
+             << ": { \"median_ns\": " << results[i].current;
+        if (results[i].tolerance >= 0)
+            file << ", \"tolerance\": " << results[i].tolerance;
+        file << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  }\n}\n";
+
+    return file.good();
+}
+//------------------------------------------------------------------------------
+
+static void usage()
+{
+    cerr << "Usage: benchregression --benchmark <executable>"
+            " --baseline <file> [--filter <regex>] [--repetitions <n>]"
+            " [--min-time <seconds>] [--tolerance <ratio>] [--update]"
+         << endl;
+}
+//------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    string executable;
+    string baselineFile;
+    string filter;
+    string minTime = DEFAULT_MIN_TIME;
+    int repetitions = DEFAULT_REPETITIONS;
+    double tolerance = -1;
+    bool update = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const string arg = argv[i];
+        if (arg == "--update")
+        {
+            update = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            usage();
+            return 2;
+        }
+
+        const string value = argv[++i];
+        if (arg == "--benchmark")
+            executable = value;
+        else if (arg == "--baseline")
+            baselineFile = value;
+        else if (arg == "--filter")
+            filter = value;
+        else if (arg == "--repetitions")
+            repetitions = atoi(value.c_str());
+        else if (arg == "--min-time")
+            minTime = value;
+        else if (arg == "--tolerance")
+            tolerance = atof(value.c_str());
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    if (executable.empty() || baselineFile.empty() || repetitions < 1)
+    {
+        usage();
+        return 2;
+    }
+
+    // Baseline
+    JsonValue baseline;
+    string text;
+    if (readFile(baselineFile, text) && !JsonParser(text).parse(baseline))
+    {
+        cerr << "Invalid baseline file: " << baselineFile << endl;
+        return 2;
+    }
+    const JsonValue *value = baseline.find("tolerance");
+    if (tolerance < 0)
+        tolerance = value ? value->number : DEFAULT_TOLERANCE;
+    const JsonValue *benchmarks = baseline.find("benchmarks");
+
+    // Current results
+    stringstream command;
+    command << "\"" << executable << "\" --benchmark_format=json"
+            << " --benchmark_repetitions=" << repetitions
+            << " --benchmark_report_aggregates_only=true"
+            << " --benchmark_min_time=" << minTime;
+    if (!filter.empty())
+        command << " \"--benchmark_filter=" << filter << "\"";
+
+    string output;
+    JsonValue report;
+    if (!runBenchmarks(command.str(), output)
+        || !JsonParser(output).parse(report) || !report.find("benchmarks"))
+    {
+        cerr << "Can not run benchmarks: " << command.str() << endl;
+        return 2;
+    }
+
+    vector<Result> results;
+    vector<bool> found(benchmarks ? benchmarks->members.size() : 0, false);
+    const vector<JsonValue> &runs = report.find("benchmarks")->items;
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const JsonValue *aggregate = runs[i].find("aggregate_name");
+        const JsonValue *name = runs[i].find("run_name");
+        const JsonValue *time = runs[i].find("cpu_time");
+        const JsonValue *unit = runs[i].find("time_unit");
+        if (!name || !time || !unit
+            || (repetitions > 1
+                && (!aggregate || aggregate->string != "median")))
+        {
+            continue;
+        }
+
+        Result result;
+        result.name = name->string;
+        result.current = nanoseconds(time->number, unit->string);
+        result.baseline = 0;
+        result.tolerance = -1;
+
+        const JsonValue *entry = 0;
+        for (size_t j = 0; j < found.size() && !entry; ++j)
+        {
+            if (benchmarks->members[j].first == result.name)
+            {
+                entry = &benchmarks->members[j].second;
+                found[j] = true;
+            }
+        }
+        if (entry)
+        {
+            if ((value = entry->find("median_ns")))
+                result.baseline = value->number;
+            if ((value = entry->find("tolerance")))
+                result.tolerance = value->number;
+        }
+        results.push_back(result);
+    }
+
+    // The entries of the baseline, absent in the current run
+    vector<Result> missing;
+    for (size_t j = 0; j < found.size(); ++j)
+    {
+        if (found[j])
+            continue;
+
+        const JsonValue &entry = benchmarks->members[j].second;
+        Result result;
+        result.name = benchmarks->members[j].first;
+        result.baseline = 0;
+        result.tolerance = -1;
+        if ((value = entry.find("median_ns")))
+            result.baseline = value->number;
+        if ((value = entry.find("tolerance")))
+            result.tolerance = value->number;
+        result.current = result.baseline;
+        missing.push_back(result);
+    }
+
+    if (update)
+    {
+        // The order of the baseline is kept, the new benchmarks follow.
+        // The benchmarks, excluded by the filter, keep their medians.
+        vector<Result> merged;
+        for (size_t j = 0, k = 0; j < found.size(); ++j)
+        {
+            const string &name = benchmarks->members[j].first;
+            if (!found[j])
+            {
+                if (!filter.empty())
+                    merged.push_back(missing[k]);
+                ++k;
+                continue;
+            }
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                if (results[i].name == name)
+                    merged.push_back(results[i]);
+            }
+        }
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            if (!benchmarks || !benchmarks->find(results[i].name))
+                merged.push_back(results[i]);
+        }
+
+        if (!writeBaseline(baselineFile, tolerance, merged))
+        {
+            cerr << "Can not write baseline file: " << baselineFile << endl;
+            return 2;
+        }
+        cout << "Baseline is updated: " << baselineFile << endl;
+        return 0;
+    }
+
+    // Comparison
+    int regressions = 0;
+    printf("%-40s %14s %14s %8s %7s  %s\n", "Benchmark", "Baseline, ns",
+           "Current, ns", "Change", "Limit", "Status");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result &result = results[i];
+        const double limit = result.tolerance >= 0 ? result.tolerance
+                                                   : tolerance;
+        if (result.baseline <= 0)
+        {
+            printf("%-40s %14s %14.1f %8s %7s  %s\n", result.name.c_str(),
+                   "-", result.current, "-", "-", "new");
+            continue;
+        }
+
+        const double change = result.current / result.baseline - 1;
+        const char *status = "ok";
+        if (change > limit)
+        {
+            status = "SLOWER";
+            ++regressions;
+        }
+        else if (change < -limit)
+        {
+            status = "faster";
+        }
+
+        printf("%-40s %14.1f %14.1f %+7.1f%% %+6.0f%%  %s\n",
+               result.name.c_str(), result.baseline, result.current,
+               100 * change, 100 * limit, status);
+    }
+
+    // With the filter the absent benchmarks may be just excluded
+    int missingCount = 0;
+    for (size_t i = 0; filter.empty() && i < missing.size(); ++i)
+    {
+        printf("%-40s %14.1f %14s %8s %7s  %s\n", missing[i].name.c_str(),
+               missing[i].baseline, "-", "-", "-", "MISSING");
+        ++missingCount;
+    }
+
+    if (regressions)
+    {
+        printf("\n%d benchmark(s) are slower than allowed by %s\n",
+               regressions, baselineFile.c_str());
+    }
+    if (missingCount)
+    {
+        printf("\n%d benchmark(s) of %s are missing in the current run\n",
+               missingCount, baselineFile.c_str());
+    }
+    if (regressions || missingCount)
+        return 1;
+
+    return 0;
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,203 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file archiveindex.h
+    \brief File contains the definition of quicktle::ArchiveIndex class.
+*/
+
+#ifndef TLEARCHIVEINDEX_H
+#define TLEARCHIVEINDEX_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <quicktle/node.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Index of the records of a TLE text archive.
+
+    The scan reads only the satellite number and the epoch from the
+    line "1 ..." of each record and remembers the byte offset of the
+    record in the archive. The line "2 ..." is skipped without parsing,
+    no Node objects are created. The records with unreadable satellite
+    number or epoch are not indexed.
+
+    The entries are ordered by satellite number, then by epoch, so the
+    records of one satellite in the given period are found by binary
+    search, see find() and quicktle::ArchiveReader.
+
+    The index is saved into a sidecar file (see fileName()): a header
+    of 56 bytes (magic "QTLEINDX", version, file type, entries count,
+    archive size, archive modification time, archive fingerprint,
+    payload checksum, header checksum) and the entries of 24 bytes
+    (satellite number, epoch, offset). All numbers are little-endian.
+    The size, the time and the fingerprint (hash of the first and the
+    last 64 KiB) tell whether the archive has been changed after
+    the indexing.
+*/
+class ArchiveIndex
+{
+public:
+    //! Indexed record
+    struct Entry
+    {
+        char satelliteNumber[8];  //!< Zero-terminated satellite number
+        double epoch;             //!< Number of seconds from Jan 1, 1970
+        unsigned long long offset;//!< Offset of the record in the archive
+    };
+
+    /*!
+        \brief Constructor
+        \param fileType - TLE file type (2- or 3-lines)
+    */
+    explicit ArchiveIndex(const FileType fileType = TwoLines);
+    /*!
+        \brief Index the text in memory
+        \param data - pointer to the text
+        \param size - size of the text
+        \return Number of indexed records
+    */
+    std::size_t scan(const char *data, std::size_t size);
+    /*!
+        \brief Index the text of the input stream
+        \param stream - input stream
+        \return Number of indexed records
+    */
+    std::size_t scan(std::istream &stream);
+    /*!
+        \brief Index the file
+        \param fileName - name of the archive
+        \return True if the file has been read
+    */
+    bool scanFile(const std::string &fileName);
+    //! Get the file type of the archive
+    FileType fileType() const;
+    //! Get the number of indexed records
+    std::size_t size() const;
+    //! Get the indexed records
+    const std::vector<Entry>& entries() const;
+    /*!
+        \brief Find the records of the satellite in the period [t1, t2]
+        \param satelliteNumber - satellite number
+        \param t1 - start of the period (seconds from Jan 1, 1970)
+        \param t2 - end of the period (seconds from Jan 1, 1970)
+        \return Range [first, last) of the indices of the found entries
+    */
+    std::pair<std::size_t, std::size_t> find(
+                            const std::string &satelliteNumber,
+                            double t1, double t2) const;
+    //! Get the number of records, which have not been indexed
+    std::size_t skippedCount() const;
+    //! Get the size of the scanned text
+    unsigned long long archiveSize() const;
+    //! Get the hash of the first and the last 64 KiB of the scanned text
+    unsigned long archiveFingerprint() const;
+    /*!
+        \brief Get the modification time of the archive (seconds from
+               Jan 1, 1970), set by scanFile() or setArchiveTime()
+    */
+    long long archiveTime() const;
+    //! Set the modification time of the archive
+    void setArchiveTime(long long time);
+    /*!
+        \brief Write the index into the output stream
+        \param stream - output stream
+        \return True if the index has been written
+    */
+    bool write(std::ostream &stream) const;
+    /*!
+        \brief Write the index into the file
+        \param fileName - name of the index file
+        \return True if the index has been written
+    */
+    bool write(const std::string &fileName) const;
+    /*!
+        \brief Read the index from the input stream
+        \param stream - input stream
+        \return True if the index has been read and its checksums
+                are valid. Otherwise the index is empty.
+    */
+    bool read(std::istream &stream);
+    /*!
+        \brief Read the index from the file
+        \param fileName - name of the index file
+        \return True if the index has been read and its checksums
+                are valid. Otherwise the index is empty.
+    */
+    bool read(const std::string &fileName);
+    /*!
+        \brief Get the name of the sidecar index file
+        \param archiveName - name of the archive
+        \return Name of the index file: archive name with ".qtx" suffix
+    */
+    static std::string fileName(const std::string &archiveName);
+    /*!
+        \brief Calculate the fingerprint of the archive, the same as
+               archiveFingerprint() after the scan of this archive
+        \param archive - archive, it should be seekable
+        \return Fingerprint of the archive
+    */
+    static unsigned long fingerprint(std::istream &archive);
+    /*!
+        \brief Get the modification time of the file
+        \param fileName - name of the file
+        \return Seconds from Jan 1, 1970 or 0 if the file is absent
+    */
+    static long long fileTime(const std::string &fileName);
+    /*!
+        \brief Read the satellite number and the epoch from the line "1 ..."
+        \param line - pointer to the line
+        \param length - length of the line
+        \param entry - entry to keep the values, the offset is not changed
+        \return True if the values have been read
+    */
+    static bool parseEntry(const char *line, std::size_t length,
+                           Entry &entry);
+
+private:
+    void reset();
+    void feed(const char *data, std::size_t size);
+    void finish();
+    void addLine(const char *line, std::size_t length,
+                 unsigned long long offset);
+    void addEntry(const char *line, std::size_t length);
+
+    FileType m_fileType;
+    std::vector<Entry> m_entries;
+    std::string m_partialLine;
+    unsigned long long m_offset;
+    unsigned long long m_recordOffset;
+    std::size_t m_position;
+    std::size_t m_skippedCount;
+    long long m_archiveTime;
+    unsigned long m_fingerprint;
+    unsigned long m_headHash;     //!< Hash of the first bytes of the text
+    std::size_t m_headSize;       //!< Number of the hashed first bytes
+    std::string m_tail;           //!< Last bytes of the text
+};
+
+} // namespace quicktle
+
+#endif // TLEARCHIVEINDEX_H
@@ -0,0 +1,91 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file archivereader.h
+    \brief File contains the definition of quicktle::ArchiveReader class.
+*/
+
+#ifndef TLEARCHIVEREADER_H
+#define TLEARCHIVEREADER_H
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <quicktle/archiveindex.h>
+#include <quicktle/dataset.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Random access to the records of a TLE text archive.
+
+    The reader finds the records of the satellite in the sidecar index
+    (see quicktle::ArchiveIndex), seeks to them in the archive and
+    parses only these records.
+*/
+class ArchiveReader
+{
+public:
+    ArchiveReader(); //!< Default constructor.
+    /*!
+        \brief Open the archive and its index.
+        \param archiveName - name of the TLE archive
+        \param fileType - TLE file type (2- or 3-lines)
+        \return True if the archive has been opened
+
+        If the sidecar index is absent or does not correspond to the
+        archive (it has another size, file type, modification time or
+        fingerprint of the first and the last 64 KiB), the archive is
+        scanned and the index file is rewritten.
+    */
+    bool open(const std::string &archiveName,
+              const FileType fileType = TwoLines);
+    //! Close the archive
+    void close();
+    //! Check if the archive is opened
+    bool isOpen() const;
+    //! Get the index of the archive
+    const ArchiveIndex& index() const;
+    /*!
+        \brief Read the records of the satellite in the period [t1, t2]
+        \param satelliteNumber - satellite number
+        \param t1 - start of the period (seconds from Jan 1, 1970)
+        \param t2 - end of the period (seconds from Jan 1, 1970)
+        \param dataSet - data set, the read nodes are appended to
+        \return Number of appended nodes. The records with errors
+                are not appended.
+    */
+    std::size_t read(const std::string &satelliteNumber, double t1,
+                     double t2, DataSet &dataSet);
+
+private:
+    ArchiveReader(const ArchiveReader&);            //!< Copying is unavailable.
+    ArchiveReader& operator=(const ArchiveReader&); //!< Copying is unavailable.
+
+    bool readLine(std::string &line);
+
+    std::ifstream m_file;
+    ArchiveIndex m_index;
+};
+
+} // namespace quicktle
+
+#endif // TLEARCHIVEREADER_H
@@ -0,0 +1,165 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file archivesorter.h
+    \brief File contains the definition of quicktle::ArchiveSorter class.
+*/
+
+#ifndef TLEARCHIVESORTER_H
+#define TLEARCHIVESORTER_H
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <quicktle/archiveindex.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief External merge sort of TLE archives, which do not fit in memory.
+
+    The input is read by chunks of bounded size. Each chunk is sorted
+    by satellite number (numerically, see below) and epoch and written
+    into a temporary file (run); the chunks are sorted in parallel by
+    quicktle::ThreadPool.
+    Then the runs are merged: at most MERGE_WIDTH files are opened at
+    once, the wider merges are done in several passes. The records with
+    the same satellite number and epoch are written once: the first one
+    in the order of input is kept. The records with unreadable satellite
+    number or epoch are skipped. When the records are passed to
+    quicktle::Node objects, the records with invalid checksums are
+    skipped before the duplicates are dropped, so a broken copy does
+    not displace the valid one.
+
+    The satellite numbers are compared without the leading spaces and
+    zeros: the number with more digits is greater ("5" < "25544"), the
+    Alpha-5 numbers ("A0001") follow "99999".
+
+    The text of the records is copied without changes, only the
+    satellite number and the epoch of each record are parsed.
+*/
+class ArchiveSorter
+{
+public:
+    //! Function, receiving the sorted nodes
+    typedef std::function<void(const Node&)> Sink;
+
+    /*!
+        \brief Constructor
+        \param fileType - TLE file type (2- or 3-lines)
+    */
+    explicit ArchiveSorter(const FileType fileType = TwoLines);
+    /*!
+        \brief Set the maximal size of the records in memory.
+               Default value is 256 MiB.
+    */
+    void setMemoryLimit(std::size_t bytes);
+    /*!
+        \brief Set the directory for temporary files.
+               Default value is the current directory.
+    */
+    void setTemporaryDirectory(const std::string &directory);
+    /*!
+        \brief Set the number of threads, sorting the chunks.
+               If it is 0 (default value), the number of hardware
+               threads is used.
+    */
+    void setThreadsCount(std::size_t count);
+    /*!
+        \brief Sort the files and write the records into the output stream
+        \param inputNames - names of the input files
+        \param output - output stream
+        \return True if all files have been read and the output
+                has been written
+    */
+    bool sort(const std::vector<std::string> &inputNames,
+              std::ostream &output);
+    /*!
+        \brief Sort the files and write the records into the file
+        \param inputNames - names of the input files
+        \param outputName - name of the output file
+        \return True if all files have been read and the output
+                has been written
+    */
+    bool sort(const std::vector<std::string> &inputNames,
+              const std::string &outputName);
+    /*!
+        \brief Sort the files and pass the records to the function,
+               for example to fill a binary archive
+        \param inputNames - names of the input files
+        \param sink - function, called for each record in sorted order
+        \return True if all files have been read
+    */
+    bool sort(const std::vector<std::string> &inputNames, const Sink &sink);
+    /*!
+        \brief Sort the input stream and write the records into
+               the output stream
+        \param input - input stream
+        \param output - output stream
+        \return True if the input has been read and the output
+                has been written
+    */
+    bool sort(std::istream &input, std::ostream &output);
+    //! Get the number of written records
+    std::size_t recordsCount() const;
+    //! Get the number of dropped duplicates
+    std::size_t duplicatesCount() const;
+    //! Get the number of skipped records
+    std::size_t skippedCount() const;
+    //! Get the number of runs, written by the last sorting
+    std::size_t runsCount() const;
+
+private:
+    ArchiveSorter(const ArchiveSorter&);            //!< Copying is unavailable.
+    ArchiveSorter& operator=(const ArchiveSorter&); //!< Copying is unavailable.
+
+    struct Chunk;
+    struct Batch;
+    struct Run;
+    //! Function, receiving the lines of the sorted records
+    typedef std::function<bool(const std::string*)> RecordSink;
+
+    bool sortInputs(const std::vector<std::string> &inputNames,
+                    std::istream *input, bool validate,
+                    const RecordSink &sink);
+    bool read(std::istream &input, Batch &batch, bool validate);
+    bool flush(Batch &batch);
+    bool merge(const RecordSink &sink);
+    bool merge(std::size_t first, std::size_t last, const RecordSink &sink);
+    std::string runName() const;
+    void removeRuns();
+
+    FileType m_fileType;
+    std::size_t m_memoryLimit;
+    std::string m_directory;
+    std::size_t m_threadsCount;
+    std::vector<std::string> m_runs;
+    std::size_t m_runsCount;
+    std::size_t m_recordsCount;
+    std::size_t m_duplicatesCount;
+    std::size_t m_skippedCount;
+};
+
+} // namespace quicktle
+
+#endif // TLEARCHIVESORTER_H
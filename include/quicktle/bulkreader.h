@@ -0,0 +1,153 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file bulkreader.h
+    \brief File contains the definition of quicktle::BulkReader class.
+*/
+
+#ifndef TLEBULKREADER_H
+#define TLEBULKREADER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <quicktle/catalog.h>
+#include <quicktle/recordfilter.h>
+
+namespace quicktle
+{
+
+class ThreadPool;
+
+/*!
+    \brief Loader of many small TLE files into one catalog.
+
+    The files are read whole, many reads are kept in flight: on Linux
+    they are submitted by the calling thread to io_uring, otherwise
+    (or if io_uring is unavailable) each file is read by pread() in
+    a worker thread. The read files are parsed by the workers of
+    quicktle::ThreadPool. Every thread collects its nodes into its own
+    partial catalog without locking; at the end the nodes of every
+    satellite are gathered from the partial catalogs, sorted by epoch
+    and appended to the catalog, the satellites are merged in parallel.
+    The result is the same as if the files were read one by one in the
+    order of the list: of the nodes with equal epochs the last one is
+    kept. Empty lines and "\r" before "\n" are ignored. The records
+    may be filtered by quicktle::RecordFilter on the raw lines, before
+    the Node objects are made.
+*/
+class BulkReader
+{
+public:
+    //! Method of reading the files
+    enum Method
+    {
+        AutoDetect = 0, //!< io_uring if it is available, else pread()
+        IoUring,        //!< Linux io_uring
+        Pread           //!< pread() in the worker threads
+    };
+
+    /*!
+        \brief Constructor
+        \param fileType - TLE file type (2- or 3-lines)
+    */
+    explicit BulkReader(const FileType fileType = TwoLines);
+    /*!
+        \brief Set the number of parsing threads. If it is 0
+               (default value), the number of hardware threads is used.
+    */
+    void setThreadsCount(std::size_t count);
+    //! Set the maximal number of reads in flight. Default value is 64.
+    void setQueueDepth(std::size_t depth);
+    //! Set the method of reading. Default value is AutoDetect.
+    void setMethod(Method method);
+    //! Set the filter of the records. Default filter accepts everything.
+    void setFilter(const RecordFilter &filter);
+    /*!
+        \brief Check whether io_uring and its read operation (Linux 5.6)
+               are supported by the library and the kernel
+    */
+    static bool ioUringAvailable();
+    /*!
+        \brief Read the files and append their nodes to the catalog
+        \param fileNames - names of the files
+        \param catalog - catalog, the nodes are appended to
+        \return True if all files have been read
+    */
+    bool read(const std::vector<std::string> &fileNames, Catalog &catalog);
+    /*!
+        \brief Read all regular files of the directory (except the hidden
+               ones) in the order of their names
+        \param directory - name of the directory
+        \param catalog - catalog, the nodes are appended to
+        \return True if the directory and all its files have been read
+    */
+    bool readDirectory(const std::string &directory, Catalog &catalog);
+    /*!
+        \brief Get the sorted names of the regular files of the directory
+               (except the hidden ones)
+        \param directory - name of the directory
+        \param fileNames - names of the files, including the directory
+        \return True if the directory has been read
+    */
+    static bool listDirectory(const std::string &directory,
+                              std::vector<std::string> &fileNames);
+    /*!
+        \brief Get the method, used by the last reading. If io_uring fails
+               after some files have been read by it, the rest of the files
+               are read by pread(), IoUring is returned.
+    */
+    Method usedMethod() const;
+    //! Get the number of files, which could not be read
+    std::size_t failedCount() const;
+    //! Get the number of records, appended to the catalog
+    std::size_t recordsCount() const;
+    //! Get the number of records, rejected by the filter
+    std::size_t rejectedCount() const;
+
+private:
+    struct File;
+    struct Partial;
+
+    bool readByRing(std::vector<File> &files,
+                    std::vector<Partial> &partials, ThreadPool &pool);
+    void readByPread(std::vector<File> &files,
+                     std::vector<Partial> &partials, ThreadPool &pool);
+    void readAndParse(File &file, std::vector<Partial> &partials,
+                      const ThreadPool &pool) const;
+    void parse(File &file, std::vector<Partial> &partials,
+               const ThreadPool &pool) const;
+    void merge(std::vector<Partial> &partials, Catalog &catalog,
+               ThreadPool &pool);
+
+    FileType m_fileType;
+    std::size_t m_threadsCount;
+    std::size_t m_queueDepth;
+    Method m_method;
+    Method m_usedMethod;
+    RecordFilter m_filter;
+    std::size_t m_failedCount;
+    std::size_t m_recordsCount;
+    std::size_t m_rejectedCount;
+};
+
+} // namespace quicktle
+
+#endif // TLEBULKREADER_H
@@ -0,0 +1,109 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file catalog.h
+    \brief File contains the definition of quicktle::Catalog class.
+*/
+
+#ifndef TLECATALOG_H
+#define TLECATALOG_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <quicktle/dataset.h>
+
+namespace quicktle
+{
+
+class Stream;
+
+/*!
+    \brief Set of satellites: every satellite has its own DataSet.
+           The satellites are ordered by their numbers.
+*/
+class Catalog
+{
+public:
+    typedef std::map<std::string, DataSet> Container;
+    typedef Container::const_iterator ConstIterator;
+
+    /*!
+        \brief Append new node to the data set of its satellite
+        \param node - TLE-node
+        \return Reference to itself
+    */
+    Catalog& append(const Node &node);
+    /*!
+        \brief Remove the satellite from the catalog
+        \param satelliteNumber - satellite number
+        \return True if the satellite is found and removed
+    */
+    bool remove(const std::string &satelliteNumber);
+    /*!
+        \brief Merge the nodes of the delta stream into the catalog.
+               The nodes with errors are skipped.
+        \param delta - stream with new nodes
+        \param changed - buffer for the sorted numbers of changed
+                         satellites, may be 0
+        \return Number of merged nodes
+    */
+    std::size_t merge(Stream &delta, std::vector<std::string> *changed = 0);
+    /*!
+        \brief Merge the nodes of other catalog into this one
+        \param delta - catalog with new nodes
+        \param changed - buffer for the sorted numbers of changed
+                         satellites, may be 0
+        \return Number of merged nodes
+    */
+    std::size_t merge(const Catalog &delta,
+                      std::vector<std::string> *changed = 0);
+    //! Remove all satellites
+    void clear();
+    //! Get the number of satellites
+    std::size_t size() const;
+    //! Get the number of nodes of all satellites
+    std::size_t nodesCount() const;
+    /*!
+        \brief Find the data set of the satellite
+        \param satelliteNumber - satellite number
+        \return Pointer to the data set or 0 if there is no such satellite
+    */
+    const DataSet* find(const std::string &satelliteNumber) const;
+    /*!
+        \brief Get the data set of the satellite, the empty data set
+               is added if there is no such satellite. The data sets
+               of different satellites may be filled in parallel.
+        \param satelliteNumber - satellite number
+        \return Reference to the data set
+    */
+    DataSet& dataSet(const std::string &satelliteNumber);
+    //! Get the iterator to the first satellite
+    ConstIterator begin() const;
+    //! Get the iterator after the last satellite
+    ConstIterator end() const;
+
+private:
+    Container m_data;
+};
+
+} // namespace quicktle
+
+#endif // TLECATALOG_H
@@ -0,0 +1,141 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file cataloghandle.h
+    \brief File contains the definition of quicktle::CatalogHandle class.
+*/
+
+#ifndef TLECATALOGHANDLE_H
+#define TLECATALOGHANDLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <quicktle/catalog.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Versioned catalog for concurrent reading and updating.
+
+    The readers take the current immutable version of the catalog by
+    one atomic load. The writers build the new version aside and publish
+    it by one atomic exchange. The replaced versions are deleted, when
+    all readers, which could see them, have finished (epoch-based
+    reclamation: every reader announces the epoch it has started in).
+*/
+class CatalogHandle
+{
+public:
+    /*!
+        \brief Access to one version of the catalog. The version
+               is not deleted while the object exists.
+    */
+    class ReadGuard
+    {
+    public:
+        //! Move constructor
+        ReadGuard(ReadGuard &&guard);
+        //! Destructor. Releases the version.
+        ~ReadGuard();
+        //! Get the catalog
+        const Catalog& catalog() const
+        {
+            return *m_catalog;
+        }
+        //! Access the catalog
+        const Catalog* operator->() const
+        {
+            return m_catalog;
+        }
+
+    private:
+        friend class CatalogHandle;
+
+        ReadGuard(std::atomic<unsigned long long> *slot,
+                  const Catalog *catalog);
+        ReadGuard(const ReadGuard&);            //!< Copying is unavailable.
+        ReadGuard& operator=(const ReadGuard&); //!< Copying is unavailable.
+
+        std::atomic<unsigned long long> *m_slot;
+        const Catalog *m_catalog;
+    };
+
+    typedef std::function<void(Catalog&)> Update;
+
+    //! Constructor. The first version is an empty catalog.
+    CatalogHandle();
+    //! Constructor. The first version is the copy of \a catalog.
+    explicit CatalogHandle(const Catalog &catalog);
+    //! Destructor. There must be no readers.
+    ~CatalogHandle();
+    //! Get the current version of the catalog
+    ReadGuard read() const;
+    /*!
+        \brief Replace the current version of the catalog
+        \param catalog - new version
+    */
+    void publish(const Catalog &catalog);
+    /*!
+        \brief Make the new version from the copy of the current one
+        \param update - function, which modifies the copy
+    */
+    void update(const Update &update);
+    //! Get the number of published versions
+    unsigned long long version() const;
+    //! Get the number of replaced versions, which are not deleted yet
+    std::size_t retiredCount() const;
+    //! Delete the replaced versions, which are not read anymore
+    void reclaim();
+
+private:
+    CatalogHandle(const CatalogHandle&);            //!< Copying is unavailable.
+    CatalogHandle& operator=(const CatalogHandle&); //!< Copying is unavailable.
+
+    //! Epoch of the reader, padded to the cache line
+    struct Slot
+    {
+        std::atomic<unsigned long long> epoch;
+        char padding[64 - sizeof(std::atomic<unsigned long long>)];
+    };
+
+    struct Retired
+    {
+        const Catalog *catalog;
+        unsigned long long epoch;
+    };
+
+    void replace(Catalog *catalog);
+    void reclaimLocked();
+
+    std::atomic<const Catalog*> m_current;
+    std::atomic<unsigned long long> m_epoch;
+    std::atomic<unsigned long long> m_version;
+    mutable std::vector<Slot> m_slots;
+    std::vector<Retired> m_retired;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace quicktle
+
+#endif // TLECATALOGHANDLE_H
@@ -0,0 +1,121 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file columnbatch.h
+    \brief File contains the definition of quicktle::ColumnBatch class.
+*/
+
+#ifndef TLECOLUMNBATCH_H
+#define TLECOLUMNBATCH_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <quicktle/nodeview.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Columns of the chosen fields of many TLE records.
+
+    The caller declares the needed fields, only these columns of the
+    raw records are parsed (see quicktle::NodeView) and stored, one
+    vector per field. The numeric fields are stored as double values
+    in the units of Node getters, the satellite number, name and
+    designator are stored as strings. The records are appended e.g.
+    by quicktle::TolerantStream:
+
+    \code
+    ColumnBatch batch;
+    batch.addField(ColumnBatch::Epoch);
+    batch.addField(ColumnBatch::MeanMotion);
+    while (stream)
+        stream >> batch;
+    \endcode
+*/
+class ColumnBatch
+{
+public:
+    //! Field of the record
+    enum Field
+    {
+        SatelliteNumber = 0,
+        SatelliteName,
+        Designator,
+        Epoch,             //!< Precise epoch [seconds from Jan 1, 1970]
+        MeanMotion,        //!< Mean motion [radians per second]
+        MeanMotionDerivative,
+        MeanMotionSecondDerivative,
+        Inclination,       //!< Inclination [radians]
+        RightAscension,    //!< Right ascension of the node [radians]
+        ArgumentOfPerigee, //!< Argument of perigee [radians]
+        MeanAnomaly,       //!< Mean anomaly [radians]
+        Eccentricity,
+        Bstar,
+        ElementNumber,
+        RevolutionNumber,
+        FieldsCount
+    };
+
+    //! Constructor. No fields are declared.
+    ColumnBatch();
+    //! Declare the field. The batch should be empty.
+    void addField(Field field);
+    //! Check whether the field is declared
+    bool hasField(Field field) const;
+    //! Get the number of records
+    std::size_t size() const;
+    //! Reserve the memory for the records
+    void reserve(std::size_t size);
+    //! Remove all records, the fields are kept
+    void clear();
+    /*!
+        \brief Append the declared fields of the raw record
+        \param view - raw record
+        \return True if the fields have been parsed without errors
+    */
+    bool append(const NodeView &view);
+    /*!
+        \brief Get the column of the numeric field
+        \return Values or empty vector if the field is not declared
+                or is not numeric
+    */
+    const std::vector<double>& values(Field field) const;
+    /*!
+        \brief Get the column of the satellite number, name or designator
+        \return Values or empty vector if the field is not declared
+                or is numeric
+    */
+    const std::vector<std::string>& strings(Field field) const;
+
+private:
+    static bool isString(Field field);
+    static double value(const NodeView &view, Field field);
+
+    std::vector<Field> m_fields;
+    std::vector<double> m_values[FieldsCount];
+    std::vector<std::string> m_strings[FieldsCount];
+    std::size_t m_size;
+};
+
+} // namespace quicktle
+
+#endif // TLECOLUMNBATCH_H
@@ -0,0 +1,118 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file compressedinput.h
+    \brief File contains the definition of quicktle::CompressedInput class.
+*/
+
+#ifndef TLECOMPRESSEDINPUT_H
+#define TLECOMPRESSEDINPUT_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+namespace quicktle
+{
+
+/*!
+    \brief Input stream, decompressing gzip or xz data on the fly.
+
+    The object is passed to quicktle::Stream instead of std::ifstream:
+    \code
+    quicktle::CompressedInput input("history.tle.gz");
+    quicktle::Stream stream(input, quicktle::ThreeLines);
+    \endcode
+    The data are decompressed by blocks. By default the blocks are
+    filled by the helper thread, so the decompression overlaps with
+    the parsing. The formats are available if the library is built
+    with zlib (gzip) and liblzma (xz), see supported().
+*/
+class CompressedInput: public std::istream
+{
+public:
+    //! Format of the input data
+    enum Format
+    {
+        AutoDetect = 0, //!< Detect the format by the magic bytes
+        Plain,          //!< Uncompressed data
+        Gzip,           //!< gzip (one or several members)
+        Xz              //!< xz (one or several streams)
+    };
+
+    //! Constructor. The stream is not opened.
+    CompressedInput();
+    /*!
+        \brief Constructor. Opens the file.
+        \param fileName - name of the file
+        \param format - format of the file
+    */
+    explicit CompressedInput(const std::string &fileName,
+                             Format format = AutoDetect);
+    //! Destructor. Stops the helper thread.
+    ~CompressedInput();
+    //! Check whether the library is built with the support of the format
+    static bool supported(Format format);
+    /*!
+        \brief Set the mode of decompression for the next opening.
+        \param threaded - true (default value) means, that the data
+                          are decompressed by the helper thread,
+                          false - by the reading thread on demand.
+    */
+    void setThreaded(bool threaded);
+    /*!
+        \brief Open the file
+        \param fileName - name of the file
+        \param format - format of the file
+        \return True if the file is opened and its format is supported
+    */
+    bool open(const std::string &fileName, Format format = AutoDetect);
+    /*!
+        \brief Read the compressed data from another stream
+        \param source - input stream, it should not be used by
+                        the caller until this stream is closed
+        \param format - format of the data
+        \return True if the format is supported
+    */
+    bool open(std::istream &source, Format format = AutoDetect);
+    //! Close the stream
+    void close();
+    //! Check whether the stream is opened
+    bool isOpen() const;
+    //! Get the format of the opened stream
+    Format format() const;
+    /*!
+        \brief Check whether the compressed data are damaged or truncated.
+               The stream reaches its end at the damaged place.
+    */
+    bool damaged() const;
+
+private:
+    CompressedInput(const CompressedInput&);            //!< Copying is unavailable.
+    CompressedInput& operator=(const CompressedInput&); //!< Copying is unavailable.
+
+    class Buffer;
+
+    Buffer *m_buffer;
+};
+
+} // namespace quicktle
+
+#endif // TLECOMPRESSEDINPUT_H
@@ -25,6 +25,7 @@
 #ifndef TLEDATASET_H
 #define TLEDATASET_H
 
+#include <list>
 #include <vector>
 #include <quicktle/node.h>
 
@@ -35,6 +36,8 @@ class DataSet
 {
 public:
     typedef std::vector<Node>::size_type IndexType;
+    //! Constructor. The nodes are kept decoded.
+    DataSet();
     /*!
         \brief Append new node to data set
         \param node - TLE-node
@@ -70,11 +73,68 @@ public:
         \return Copy of the nearest node
     */
     const Node& nearestNode(const time_t &t) const;
+    /*!
+        \brief Set the compressed storage mode
+        \param blockSize - number of nodes in one compressed block.
+                           If it is 0, all nodes are kept decoded.
+        \param recentSize - number of the latest nodes, which are kept
+                            decoded
+        \param cacheSize - number of decoded blocks, which are kept
+                           in memory (at least 1)
+
+        The older nodes are encoded by blocks (see quicktle::HistoryBlock)
+        with the precision of TLE text. The block is decoded on demand
+        and is put into the cache of recently used blocks, so
+        the reference, returned by node() or nearestNode(), stays valid
+        until \a cacheSize other blocks are decoded. The cache is not
+        synchronised: the compressed data set should not be read from
+        several threads simultaneously.
+
+        The compression is lossy. The encoded nodes lose their original
+        lines, so they are not printed verbatim any more: the lines are
+        regenerated from the parameters. The parameters, set with more
+        precision than TLE text has, are rounded to it.
+    */
+    void setCompression(IndexType blockSize, IndexType recentSize,
+                        IndexType cacheSize = 4);
+    //! Get the number of nodes, kept in compressed blocks
+    IndexType compressedSize() const;
+    //! Get the size of the compressed blocks [bytes]
+    std::size_t compressedBytes() const;
 
 private:
+    //! Compressed block of the older nodes
+    struct Block
+    {
+        std::vector<unsigned char> data;
+        IndexType first;    //!< Index of the first node of the block
+        IndexType count;    //!< Number of nodes in the block
+        time_t firstEpoch;
+        time_t lastEpoch;
+    };
+
+    //! Decoded block in the cache
+    struct CachedBlock
+    {
+        IndexType block;
+        std::vector<Node> nodes;
+    };
+
     IndexType nearestNotLess(const time_t &t, bool &found) const;
+    IndexType findBlock(const IndexType &index) const;
+    const std::vector<Node>& decodedBlock(const IndexType &block) const;
+    void encodeBlock(const IndexType &block, const std::vector<Node> &nodes);
+    void compressRecent();
+    void decompressAll();
+    void updateBlocks();
 
 	std::vector<Node> m_data;
+    std::vector<Block> m_blocks;
+    IndexType m_compressedSize;
+    IndexType m_blockSize;
+    IndexType m_recentSize;
+    IndexType m_cacheSize;
+    mutable std::list<CachedBlock> m_cache;
 };
 
 } // namespace quicktle
@@ -177,6 +177,41 @@ double parseDouble(const std::string &line, const std::size_t start,
                    const std::size_t length, Node::ErrorCode &error,
                    const bool decimalPointAssumed=false);
 
+/*!
+    \brief Convert the characters into integer variable without copying
+           them into std::string, the same way as parseInt() does.
+    \param str - pointer to the first character
+    \param length - number of characters
+    \param error - buffer to keep error code
+    \return A value of 'int' type.
+*/
+int parseRawInt(const char *str, std::size_t length, Node::ErrorCode &error);
+
+/*!
+    \brief Convert the characters into 'double' variable without copying
+           them into std::string, the same way as parseDouble() does.
+    \param str - pointer to the first character
+    \param length - number of characters
+    \param error - buffer to keep error code
+    \param decimalPointAssumed - specifies, if the value is presented
+                                 as a fractional part of the number
+    \return A value of 'double' type.
+*/
+double parseRawDouble(const char *str, std::size_t length,
+                      Node::ErrorCode &error,
+                      const bool decimalPointAssumed = false);
+
+/*!
+    \brief Convert the characters into date without copying them
+           into std::string, the same way as string2date() does.
+    \param str - pointer to the first character
+    \param length - number of characters
+    \param error - buffer to keep error code
+    \return Number of seconds (including fractional part) since Jan 1, 1970
+*/
+double parseRawDate(const char *str, std::size_t length,
+                    Node::ErrorCode &error);
+
 /*!
     \brief Calculate the checksum for the given string,
            using the Modulo 10 algorithm
@@ -185,6 +220,15 @@ double parseDouble(const std::string &line, const std::size_t start,
 */
 int checksum(const std::string &str);
 
+/*!
+    \brief Calculate the checksum for the given characters,
+           using the Modulo 10 algorithm
+    \param str - pointer to the first character
+    \param length - number of characters
+    \return Return the checksum of 'int' type.
+*/
+int checksum(const char *str, const std::size_t length);
+
 /*!
     \brief Make the angle value between 0 and 360 degrees
     \param angle - angle
@@ -204,6 +248,46 @@ double deg2rad(double angle);
 */
 double rad2deg(double angle);
 
+/*!
+    \brief Write 32-bit unsigned integer in little-endian byte order
+    \param p - pointer to 4 bytes of the output buffer
+    \param value - value to be written
+*/
+void putU32(unsigned char *p, unsigned long value);
+
+/*!
+    \brief Write 64-bit unsigned integer in little-endian byte order
+    \param p - pointer to 8 bytes of the output buffer
+    \param value - value to be written
+*/
+void putU64(unsigned char *p, unsigned long long value);
+
+/*!
+    \brief Write IEEE 754 double in little-endian byte order
+    \param p - pointer to 8 bytes of the output buffer
+    \param value - value to be written
+*/
+void putDouble(unsigned char *p, double value);
+
+//! Read 32-bit unsigned integer in little-endian byte order
+unsigned long getU32(const unsigned char *p);
+
+//! Read 64-bit unsigned integer in little-endian byte order
+unsigned long long getU64(const unsigned char *p);
+
+//! Read IEEE 754 double in little-endian byte order
+double getDouble(const unsigned char *p);
+
+/*!
+    \brief Calculate 32-bit FNV-1a hash
+    \param data - pointer to the data
+    \param size - size of the data
+    \param hash - hash of the previous data, to continue the calculation
+    \return Hash value
+*/
+unsigned long fnv1a(const unsigned char *data, std::size_t size,
+                    unsigned long hash = 2166136261UL);
+
 } // namespace quicktle
 
 #endif // FUNC_H
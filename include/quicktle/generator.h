@@ -0,0 +1,140 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file generator.h
+    \brief File contains the definition of quicktle::Generator class.
+*/
+
+#ifndef TLEGENERATOR_H
+#define TLEGENERATOR_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <quicktle/node.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Generator of synthetic TLE catalogs for load testing.
+
+    The catalog contains \a satellitesCount objects with \a epochsCount
+    records each. The records are ordered by epoch: every "delivery"
+    contains one record for each satellite. The elements of each object
+    are chosen randomly according to its orbit class, the mean anomaly
+    moves along the orbit from one epoch to another. The output is fully
+    determined by the seed.
+*/
+class Generator
+{
+public:
+    //! Orbit class of a satellite
+    enum OrbitClass
+    {
+        LEO = 0,          //!< Low Earth orbit
+        MEO,              //!< Medium Earth orbit (navigation satellites)
+        GEO,              //!< Geostationary orbit
+        HEO,              //!< Highly elliptical orbit (Molniya, GTO)
+        OrbitClassesCount
+    };
+
+    /*!
+        \brief Constructor
+        \param seed - seed of the pseudo-random sequence
+    */
+    explicit Generator(unsigned long long seed = 0);
+    //! Set the seed of the pseudo-random sequence
+    void setSeed(unsigned long long seed);
+    /*!
+        \brief Set the number of satellites
+        \param count - number of satellites. The satellite numbers are
+                       assigned sequentially and wrap around after 99999.
+    */
+    void setSatellitesCount(std::size_t count);
+    //! Get the number of satellites
+    std::size_t satellitesCount() const;
+    //! Set the number of records per satellite
+    void setEpochsCount(std::size_t count);
+    //! Get the number of records per satellite
+    std::size_t epochsCount() const;
+    //! Set the number of the first satellite
+    void setFirstSatelliteNumber(int number);
+    /*!
+        \brief Set the epoch of the first record
+        \param epoch - number of seconds from Jan 1, 1970
+    */
+    void setStartEpoch(double epoch);
+    //! Set the interval between the records of one satellite [seconds]
+    void setEpochStep(double step);
+    //! Set the output format: 2- or 3-lines
+    void setFileType(FileType fileType);
+    /*!
+        \brief Set the relative weights of orbit classes in the catalog.
+               Default weights are 0.7, 0.08, 0.15 and 0.07.
+    */
+    void setOrbitMix(double leo, double meo, double geo, double heo);
+    //! Get the orbit class of the satellite with the given index
+    OrbitClass orbitClass(std::size_t satellite) const;
+    /*!
+        \brief Generate the lines of one record
+        \param satellite - index of satellite [0, satellitesCount)
+        \param epoch - index of epoch [0, epochsCount)
+        \param line1 - buffer for the first TLE line (satellite name)
+        \param line2 - buffer for the second TLE line ("1 ...")
+        \param line3 - buffer for the third TLE line ("2 ...")
+    */
+    void record(std::size_t satellite, std::size_t epoch, std::string &line1,
+                std::string &line2, std::string &line3) const;
+    //! Generate the Node object for one record
+    Node node(std::size_t satellite, std::size_t epoch) const;
+    /*!
+        \brief Write the whole catalog into the output stream
+        \param stream - output stream
+        \return Number of written records
+    */
+    std::size_t write(std::ostream &stream) const;
+    /*!
+        \brief Write the whole catalog into the file
+        \param fileName - name of the file
+        \return True if the file has been written successfully
+    */
+    bool write(const std::string &fileName) const;
+
+private:
+    struct Orbit;
+
+    Orbit orbit(std::size_t satellite) const;
+    std::size_t format(const Orbit &orbit, std::size_t satellite,
+                       std::size_t epoch, char *buffer) const;
+
+    unsigned long long m_seed;
+    std::size_t m_satellitesCount;
+    std::size_t m_epochsCount;
+    int m_firstSatelliteNumber;
+    double m_startEpoch;
+    double m_epochStep;
+    FileType m_fileType;
+    double m_mix[OrbitClassesCount];
+};
+
+} // namespace quicktle
+
+#endif // TLEGENERATOR_H
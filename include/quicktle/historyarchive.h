@@ -0,0 +1,219 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file historyarchive.h
+    \brief File contains the definition of quicktle::HistoryWriter
+           and quicktle::HistoryReader classes.
+*/
+
+#ifndef TLEHISTORYARCHIVE_H
+#define TLEHISTORYARCHIVE_H
+
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <quicktle/dataset.h>
+#include <quicktle/historyblock.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Writer of the compressed history archive.
+
+    The records of each satellite are split into the blocks of
+    successive records (see quicktle::HistoryBlock), the directory of
+    satellites and blocks is written at the end of the file:
+    \verbatim
+    header     16 bytes   magic "QTLEHIST", version, reserved
+    blocks                size, checksum (FNV-1a), encoded records
+    directory             for each satellite: number (8 chars),
+                          blocks count, records count and for each
+                          block: offset, records count, first and
+                          last epochs
+    footer     24 bytes   directory offset, satellites count,
+                          directory checksum, footer checksum
+    \endverbatim
+    All numbers are little-endian. The elements are kept with the
+    precision of TLE text.
+*/
+class HistoryWriter
+{
+public:
+    HistoryWriter(); //!< Default constructor.
+    //! Destructor. Closes the archive.
+    ~HistoryWriter();
+    /*!
+        \brief Create the archive
+        \param fileName - name of the file
+        \return True if the file has been created
+    */
+    bool open(const std::string &fileName);
+    /*!
+        \brief Set the maximal number of records in the block.
+               Default value is 1024.
+    */
+    void setBlockSize(std::size_t size);
+    /*!
+        \brief Append the node to the archive
+        \param node - node to be written
+        \return True if the node has been appended. The nodes of each
+                satellite must follow each other in the order of epochs,
+                e.g. as quicktle::ArchiveSorter produces them.
+    */
+    bool append(const Node &node);
+    /*!
+        \brief Write the rest blocks and the directory and close the file
+        \return True if the archive has been written
+    */
+    bool close();
+    //! Get the number of appended records
+    std::size_t recordsCount() const;
+
+private:
+    HistoryWriter(const HistoryWriter&);            //!< Copying is unavailable.
+    HistoryWriter& operator=(const HistoryWriter&); //!< Copying is unavailable.
+
+    struct Block
+    {
+        unsigned long long offset;
+        std::size_t recordsCount;
+        double firstEpoch;
+        double lastEpoch;
+    };
+
+    struct Satellite
+    {
+        std::string number;
+        std::size_t recordsCount;
+        std::vector<Block> blocks;
+    };
+
+    bool flush();
+
+    std::ofstream m_file;
+    std::size_t m_blockSize;
+    std::vector<Node> m_nodes;
+    std::vector<Satellite> m_satellites;
+    std::set<std::string> m_numbers;
+    std::vector<unsigned char> m_buffer;
+    unsigned long long m_offset;
+    std::size_t m_recordsCount;
+    bool m_ok;
+};
+
+/*!
+    \brief Reader of the compressed history archive.
+
+    The directory is read by open(), the blocks are read and decoded
+    only for the requested satellites.
+*/
+class HistoryReader
+{
+public:
+    //! Function, receiving the decoded nodes
+    typedef std::function<void(const Node&)> Sink;
+
+    HistoryReader(); //!< Default constructor.
+    /*!
+        \brief Open the archive and read its directory
+        \param fileName - name of the file
+        \return True if the archive has been opened
+    */
+    bool open(const std::string &fileName);
+    //! Close the archive
+    void close();
+    //! Check if the archive is opened
+    bool isOpen() const;
+    //! Get the number of satellites
+    std::size_t satellitesCount() const;
+    /*!
+        \brief Find the satellite
+        \param satelliteNumber - satellite number
+        \return Index of the satellite or satellitesCount()
+                if it is not found
+    */
+    std::size_t find(const std::string &satelliteNumber) const;
+    //! Get the number of the satellite with the given index
+    const std::string& satelliteNumber(std::size_t satellite) const;
+    //! Get the number of records of the satellite with the given index
+    std::size_t recordsCount(std::size_t satellite) const;
+    /*!
+        \brief Decode the records of the satellite in the period [t1, t2]
+        \param satellite - index of the satellite
+        \param t1 - start of the period (seconds from Jan 1, 1970)
+        \param t2 - end of the period (seconds from Jan 1, 1970)
+        \param sink - function, called for each record in order of epochs
+        \return True if the blocks have been read and decoded
+    */
+    bool read(std::size_t satellite, double t1, double t2,
+              const Sink &sink);
+    /*!
+        \brief Decode all records of the satellite
+        \param satellite - index of the satellite
+        \param dataSet - data set, the nodes are appended to
+        \return True if the blocks have been read and decoded
+    */
+    bool read(std::size_t satellite, DataSet &dataSet);
+    /*!
+        \brief Decode the element columns of the satellite
+        \param satellite - index of the satellite
+        \param columns - columns, the values are appended to
+        \return True if the blocks have been read and decoded
+    */
+    bool read(std::size_t satellite, HistoryBlock::Columns &columns);
+
+private:
+    HistoryReader(const HistoryReader&);            //!< Copying is unavailable.
+    HistoryReader& operator=(const HistoryReader&); //!< Copying is unavailable.
+
+    struct Block
+    {
+        unsigned long long offset;
+        double firstEpoch;
+        double lastEpoch;
+    };
+
+    struct Satellite
+    {
+        std::string number;
+        std::size_t recordsCount;
+        std::size_t firstBlock;
+        std::size_t blocksCount;
+    };
+
+    bool readDirectory();
+    bool readBlock(const Block &block);
+
+    std::ifstream m_file;
+    std::vector<Satellite> m_satellites;
+    std::map<std::string, std::size_t> m_numbers;
+    std::vector<Block> m_blocks;
+    std::vector<unsigned char> m_buffer;
+    unsigned long long m_blocksEnd;
+};
+
+} // namespace quicktle
+
+#endif // TLEHISTORYARCHIVE_H
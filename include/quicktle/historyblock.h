@@ -0,0 +1,101 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file historyblock.h
+    \brief File contains the definition of quicktle::HistoryBlock class.
+*/
+
+#ifndef TLEHISTORYBLOCK_H
+#define TLEHISTORYBLOCK_H
+
+#include <cstddef>
+#include <vector>
+#include <quicktle/node.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Compressed block of successive records of one satellite.
+
+    The elements are kept as the integers of TLE text, e.g. the
+    inclination in 1e-4 degrees and the epoch in 1e-8 days, so the
+    decoded values are equal to the values, parsed from the text.
+    The values of the block are stored by columns: each column contains
+    the differences of successive values, encoded as zigzag varints,
+    and the runs of equal values are replaced by their lengths.
+    The names and designators are kept in the table of the block.
+*/
+class HistoryBlock
+{
+public:
+    //! Element columns of the decoded block
+    struct Columns
+    {
+        std::vector<double> epoch; //!< Seconds from Jan 1, 1970
+        std::vector<double> n;
+        std::vector<double> dn;
+        std::vector<double> d2n;
+        std::vector<double> i;
+        std::vector<double> Omega;
+        std::vector<double> omega;
+        std::vector<double> M;
+        std::vector<double> e;
+        std::vector<double> bstar;
+        std::vector<int> elementNumber;
+        std::vector<int> revolutionNumber;
+
+        //! Remove all values
+        void clear();
+        //! Get the number of records
+        std::size_t size() const;
+    };
+
+    /*!
+        \brief Encode the records and append them to the buffer
+        \param nodes - pointer to the first node
+        \param count - number of nodes
+        \param data - buffer, the block is appended to
+    */
+    static void encode(const Node *nodes, std::size_t count,
+                       std::vector<unsigned char> &data);
+    /*!
+        \brief Decode the records
+        \param data - pointer to the block
+        \param size - size of the block
+        \param nodes - vector, the nodes are appended to
+        \return True if the block has been decoded
+    */
+    static bool decode(const unsigned char *data, std::size_t size,
+                       std::vector<Node> &nodes);
+    /*!
+        \brief Decode the element columns only, without Node objects
+        \param data - pointer to the block
+        \param size - size of the block
+        \param columns - columns, the values are appended to
+        \return True if the block has been decoded
+    */
+    static bool decode(const unsigned char *data, std::size_t size,
+                       Columns &columns);
+};
+
+} // namespace quicktle
+
+#endif // TLEHISTORYBLOCK_H
@@ -255,6 +255,8 @@ public:
         \return Reference to itself.
     */
     Node& outputFormat(const FileType format);
+    //! Get output format: 2- or 3-lines
+    FileType outputFormat() const;
     /*!
         \brief Output function
         \param stream - Output stream
@@ -269,6 +271,15 @@ public:
     {
         return m_lastError;
     }
+    /*!
+        \brief Check whether any parameter has been set after the assignment
+               of TLE lines. The lines of unmodified node are written
+               to the output stream as they are.
+    */
+    bool modified() const
+    {
+        return m_modified;
+    }
 
     Node& operator=(Node node);
 
@@ -308,6 +319,13 @@ private:
         FieldsCount
     };
 
+    /*!
+        Check whether the field value is already known: it has been parsed
+        or set, or there is no line to parse it from.
+    */
+    bool isCached(Field field, const std::string &line) const;
+    //! Store the code of last error
+    void setError(ErrorCode error) const;
 
     std::string m_line1;
     std::string m_line2;
@@ -332,6 +350,7 @@ private:
     FileType m_fileType;
     mutable ErrorCode m_lastError;
     mutable std::bitset<FieldsCount> m_initList;
+    bool m_modified;
 };
 
 } // namespace quicktle
@@ -0,0 +1,143 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file nodeview.h
+    \brief File contains the definition of quicktle::NodeView class.
+*/
+
+#ifndef TLENODEVIEW_H
+#define TLENODEVIEW_H
+
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <quicktle/node.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Read-only TLE record over external lines.
+
+    The object keeps the pointers to the lines and their lengths only,
+    the lines must outlive it. The getters parse the columns in place
+    each time they are called and return the same values as the getters
+    of quicktle::Node. Use toNode() for the coordinates and velocity.
+*/
+class NodeView
+{
+public:
+    //! Default constructor. The view is empty.
+    NodeView();
+    /*!
+        \brief Constructor
+        \param line2 - second TLE line ("1 ...")
+        \param length2 - length of the second line
+        \param line3 - third TLE line ("2 ...")
+        \param length3 - length of the third line
+    */
+    NodeView(const char *line2, std::size_t length2,
+             const char *line3, std::size_t length3);
+    /*!
+        \brief Constructor
+        \param line1 - first TLE line (satellite name)
+        \param length1 - length of the first line
+        \param line2 - second TLE line ("1 ...")
+        \param length2 - length of the second line
+        \param line3 - third TLE line ("2 ...")
+        \param length3 - length of the third line
+    */
+    NodeView(const char *line1, std::size_t length1,
+             const char *line2, std::size_t length2,
+             const char *line3, std::size_t length3);
+    /*!
+        \brief Check the lengths and checksums of the lines
+        \return Error code
+    */
+    Node::ErrorCode check() const;
+    //! Get the satellite number
+    std::string satelliteNumber() const;
+    //! Get the satellite name
+    std::string satelliteName() const;
+    //! Get the International Designator
+    std::string designator() const;
+    //! Get the Mean Motion [radians per second]
+    double n() const;
+    //! Get the First Time Derivative of the Mean Motion
+    double dn() const;
+    //! Get the Second Time Derivative of the Mean Motion
+    double d2n() const;
+    //! Get the Inclination [Radians]
+    double i() const;
+    //! Get the Right Ascension of the Ascending Node [Radians]
+    double Omega() const;
+    //! Get the Argument of Perigee [Radians]
+    double omega() const;
+    //! Get the Mean Anomaly [Radians]
+    double M() const;
+    //! Get the BSTAR drag term
+    double bstar() const;
+    //! Get the Eccentricity
+    double e() const;
+    //! Get the Classification
+    char classification() const;
+    //! Get the Ephemeris type
+    char ephemerisType() const;
+    //! Get the precise epoch - number of seconds from Jan 1, 1970
+    double preciseEpoch() const;
+    //! Get the epoch - number of seconds from Jan 1, 1970
+    std::time_t epoch() const;
+    //! Get the Element number
+    int elementNumber() const;
+    //! Get the Revolution number [Revs]
+    int revolutionNumber() const;
+    //! Make the Node object with the copies of the lines
+    Node toNode() const;
+    //! Get the code of last error
+    Node::ErrorCode lastError() const
+    {
+        return m_lastError;
+    }
+
+private:
+    double field(const char *line, std::size_t length, std::size_t start,
+                 std::size_t fieldLength,
+                 bool decimalPointAssumed = false) const;
+    int intField(const char *line, std::size_t length, std::size_t start,
+                 std::size_t fieldLength) const;
+    char charField(const char *line, std::size_t length,
+                   std::size_t index) const;
+    std::string stringField(const char *line, std::size_t length,
+                            std::size_t start, std::size_t fieldLength,
+                            Node::ErrorCode &error) const;
+    void setError(Node::ErrorCode error) const;
+
+    const char *m_line1;
+    const char *m_line2;
+    const char *m_line3;
+    std::size_t m_length1;
+    std::size_t m_length2;
+    std::size_t m_length3;
+    mutable Node::ErrorCode m_lastError;
+};
+
+} // namespace quicktle
+
+#endif // TLENODEVIEW_H
@@ -0,0 +1,139 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file pipelinedstream.h
+    \brief File contains the definition of quicktle::PipelinedStream class.
+*/
+
+#ifndef TLEPIPELINEDSTREAM_H
+#define TLEPIPELINEDSTREAM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <quicktle/catalog.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Reader of TLE records with the read-ahead in the helper thread.
+
+    The interface is the same as of quicktle::Stream. The helper thread
+    reads the source by large blocks and passes them to the parsing
+    thread through the bounded single-producer single-consumer queue,
+    so the waiting for the input overlaps with the parsing. The queue
+    is lock-free while it is neither empty nor full; a thread sleeps
+    only when it has to wait for the other one.
+
+    The lines may be separated by "\n" or "\r\n".
+*/
+class PipelinedStream
+{
+public:
+    /*!
+        \brief Constructor. The reading starts at the first request.
+        \param source - input stream, it should not be used by the
+                        caller while this object exists
+        \param fileType - TLE file type (2- or 3-lines)
+    */
+    PipelinedStream(std::istream &source, const FileType fileType = TwoLines);
+    //! Destructor. Stops the helper thread.
+    ~PipelinedStream();
+    /*!
+        \brief Set the size of the blocks before the reading.
+               Default value is 1 MiB.
+    */
+    void setBlockSize(std::size_t size);
+    /*!
+        \brief Extract the Node object from the input stream.
+        \param node - the Node object
+        \return Reference to itself
+    */
+    PipelinedStream& operator>>(Node &node);
+    /*!
+        \brief Extract the Node object and put it into data set
+        \param dataSet - data set
+        \return Reference to itself
+    */
+    PipelinedStream& operator>>(DataSet &dataSet);
+    /*!
+        \brief Extract the Node object and put it into catalog
+        \param catalog - catalog
+        \return Reference to itself
+    */
+    PipelinedStream& operator>>(Catalog &catalog);
+    /*!
+        \brief Operator bool()
+        \return True if the input stream can be read further.
+    */
+    operator bool();
+    /*!
+        \brief Set the parsing mode (see Stream::enforceParsing())
+        \return Previous value of parsing mode.
+    */
+    bool enforceParsing(bool parsingMode);
+
+private:
+    PipelinedStream(const PipelinedStream&);            //!< Copying is unavailable.
+    PipelinedStream& operator=(const PipelinedStream&); //!< Copying is unavailable.
+
+    //! Block of the input
+    struct Block
+    {
+        std::vector<char> data;
+        std::size_t size;
+    };
+
+    void start();
+    void run();
+    bool acquireBlock();
+    void releaseBlock();
+    void readLine(std::string &line);
+
+    std::istream *m_source;
+    FileType m_fileType;
+    bool m_enforceParsing;
+    std::size_t m_blockSize;
+    std::string m_lines[3];
+
+    std::vector<Block> m_blocks;
+    std::atomic<std::size_t> m_produced; //!< Number of filled blocks
+    std::atomic<std::size_t> m_consumed; //!< Number of released blocks
+    std::atomic<bool> m_end;
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_producerWaits;
+    std::atomic<bool> m_consumerWaits;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_thread;
+
+    const Block *m_block;  //!< Current block of the parsing thread
+    std::size_t m_position;
+};
+
+} // namespace quicktle
+
+#endif // TLEPIPELINEDSTREAM_H
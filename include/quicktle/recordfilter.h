@@ -0,0 +1,112 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file recordfilter.h
+    \brief File contains the definition of quicktle::RecordFilter class.
+*/
+
+#ifndef TLERECORDFILTER_H
+#define TLERECORDFILTER_H
+
+#include <set>
+#include <string>
+#include <vector>
+#include <quicktle/nodeview.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Predicate on the raw TLE records, which is checked by the
+           readers before the Node objects are made.
+
+    The record is accepted if its satellite number is in the set (if
+    the set is not empty), its epoch is in the window (if it is set)
+    and all given elements are in their ranges. The columns are parsed
+    in place by quicktle::NodeView: the satellite number first, then
+    the epoch, then the elements, so most of rejected records are
+    skipped after one column is read. The records with unreadable
+    checked columns are rejected. Empty filter accepts everything.
+*/
+class RecordFilter
+{
+public:
+    //! Orbital element, checked by the range
+    enum Element
+    {
+        MeanMotion = 0,    //!< Mean motion [radians per second]
+        Eccentricity,      //!< Eccentricity
+        Inclination,       //!< Inclination [radians]
+        RightAscension,    //!< Right ascension of the node [radians]
+        ArgumentOfPerigee, //!< Argument of perigee [radians]
+        MeanAnomaly,       //!< Mean anomaly [radians]
+        Bstar              //!< BSTAR drag term
+    };
+
+    //! Constructor. The filter is empty.
+    RecordFilter();
+    //! Accept the satellite (the number is compared without spaces)
+    void addSatellite(const std::string &satelliteNumber);
+    /*!
+        \brief Accept the epochs of the window only
+        \param first - the first epoch, seconds from Jan 1, 1970
+        \param last - the last epoch, seconds from Jan 1, 1970
+    */
+    void setEpochRange(double first, double last);
+    /*!
+        \brief Accept the values of the element in the range only.
+               The units are the same as of Node getters,
+               e.g. 11 revs per day is 11 * 2 * M_PI / 86400.
+        \param element - orbital element
+        \param min - the minimal value
+        \param max - the maximal value
+    */
+    void addRange(Element element, double min, double max);
+    //! Remove all conditions
+    void clear();
+    //! Check whether there are no conditions
+    bool empty() const;
+    /*!
+        \brief Check the record
+        \param view - raw record
+        \return True if the record is accepted
+    */
+    bool accept(const NodeView &view) const;
+
+private:
+    struct Range
+    {
+        Element element;
+        double min;
+        double max;
+    };
+
+    static double value(const NodeView &view, Element element);
+
+    std::set<std::string> m_satellites;
+    bool m_hasEpochRange;
+    double m_firstEpoch;
+    double m_lastEpoch;
+    std::vector<Range> m_ranges;
+};
+
+} // namespace quicktle
+
+#endif // TLERECORDFILTER_H
@@ -0,0 +1,128 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file sharedcatalog.h
+    \brief File contains the definition of quicktle::SharedCatalogWriter
+           and quicktle::SharedCatalogReader classes.
+*/
+
+#ifndef TLESHAREDCATALOG_H
+#define TLESHAREDCATALOG_H
+
+#include <cstddef>
+#include <string>
+#include <quicktle/catalog.h>
+#include <quicktle/snapshot.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Publisher of the catalog in POSIX shared memory.
+
+    Every published version of the catalog is a separate shared memory
+    segment "<name>.<generation>" with the Snapshot image. The control
+    segment "<name>" contains the atomic number of the current generation.
+    The publication writes the new segment, switches the generation and
+    unlinks the previous segment: the readers, which have mapped it, use
+    it until they refresh.
+*/
+class SharedCatalogWriter
+{
+public:
+    /*!
+        \brief Constructor
+        \param name - name of the shared memory object, e.g. "/catalog"
+    */
+    explicit SharedCatalogWriter(const std::string &name);
+    //! Destructor. The published catalog stays available for readers.
+    ~SharedCatalogWriter();
+    /*!
+        \brief Publish the new version of the catalog
+        \param catalog - catalog
+        \return True if the catalog is published
+    */
+    bool publish(const Catalog &catalog);
+    //! Get the generation of the last published catalog (0 - nothing)
+    unsigned long long generation() const;
+    /*!
+        \brief Unlink the control and the current catalog segments
+        \param name - name of the shared memory object
+    */
+    static void remove(const std::string &name);
+
+private:
+    SharedCatalogWriter(const SharedCatalogWriter&);
+    SharedCatalogWriter& operator=(const SharedCatalogWriter&);
+
+    bool openControl();
+
+    std::string m_name;
+    void *m_control;
+};
+
+/*!
+    \brief Read-only view of the catalog, published by SharedCatalogWriter.
+           The queries use the shared memory directly.
+
+    refresh() must not be called concurrently with the queries
+    of the same reader.
+*/
+class SharedCatalogReader
+{
+public:
+    /*!
+        \brief Constructor
+        \param name - name of the shared memory object, e.g. "/catalog"
+    */
+    explicit SharedCatalogReader(const std::string &name);
+    //! Destructor. Unmaps the segments.
+    ~SharedCatalogReader();
+    /*!
+        \brief Map the current version of the catalog if it is newer
+               than the mapped one
+        \return True if the reader has a catalog
+    */
+    bool refresh();
+    //! Get the generation of the mapped catalog (0 - nothing)
+    unsigned long long generation() const;
+    //! Check whether a newer catalog is published
+    bool outdated() const;
+    //! Get the mapped catalog
+    const Snapshot& snapshot() const;
+
+private:
+    SharedCatalogReader(const SharedCatalogReader&);
+    SharedCatalogReader& operator=(const SharedCatalogReader&);
+
+    bool openControl();
+    void unmap();
+
+    std::string m_name;
+    void *m_control;
+    void *m_mapping;
+    std::size_t m_mappingSize;
+    unsigned long long m_generation;
+    Snapshot m_snapshot;
+};
+
+} // namespace quicktle
+
+#endif // TLESHAREDCATALOG_H
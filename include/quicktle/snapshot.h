@@ -0,0 +1,186 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file snapshot.h
+    \brief File contains the definition of quicktle::Snapshot class.
+*/
+
+#ifndef TLESNAPSHOT_H
+#define TLESNAPSHOT_H
+
+#include <cstddef>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <quicktle/catalog.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Binary image of a parsed catalog.
+
+    The snapshot contains the header, the directory of satellites
+    (ordered by their numbers), the fixed-width records of parsed
+    elements (ordered by epoch for each satellite) and the table of
+    interned names and designators. All numbers are little-endian, all
+    references are offsets from the start of the snapshot, so the file
+    can be mapped into memory and used without parsing.
+
+    Layout of version 1:
+    \verbatim
+    header     72 bytes   magic "QTLESNAP", version, sizes, offsets,
+                          payload checksum, header checksum (FNV-1a)
+    satellites 16 bytes   number (8 chars), first record, records count
+    records    104 bytes  epoch, n, dn, d2n, i, Omega, omega, M, e,
+                          bstar, name and designator offsets,
+                          element and revolution numbers,
+                          classification, ephemeris type, file type
+    strings               zero-terminated names and designators
+    \endverbatim
+*/
+class Snapshot
+{
+public:
+    //! Result of opening the snapshot
+    enum Status
+    {
+        Ok = 0,             //!< Snapshot is opened
+        NotOpened,          //!< Nothing is opened
+        FileError,          //!< File can not be opened or mapped
+        InvalidHeader,      //!< Wrong magic or sizes
+        UnsupportedVersion, //!< Snapshot is written by a newer library
+        HeaderChecksumError //!< Header is corrupted
+    };
+
+    //! Constructor
+    Snapshot();
+    //! Destructor. Unmaps the file.
+    ~Snapshot();
+    /*!
+        \brief Map the snapshot file into memory
+        \param fileName - name of the file
+        \return True if the snapshot is valid
+    */
+    bool open(const std::string &fileName);
+    /*!
+        \brief Use the snapshot in memory. The memory must outlive
+               the object or until close() is called.
+        \param data - pointer to the snapshot
+        \param size - size of the snapshot
+        \return True if the snapshot is valid
+    */
+    bool attach(const void *data, std::size_t size);
+    //! Release the snapshot
+    void close();
+    //! Get the status of the last open() or attach()
+    Status status() const;
+    /*!
+        \brief Check the payload checksum. It reads the whole snapshot,
+               so it is not done by open() and attach().
+        \return True if the payload is not corrupted
+    */
+    bool verify() const;
+    //! Get the number of satellites
+    std::size_t satellitesCount() const;
+    //! Get the number of records of all satellites
+    std::size_t recordsCount() const;
+    /*!
+        \brief Find the satellite by its number
+        \param satelliteNumber - satellite number
+        \return Index of the satellite or satellitesCount()
+                if there is no such satellite
+    */
+    std::size_t find(const std::string &satelliteNumber) const;
+    //! Get the number of the satellite with given index
+    std::string satelliteNumber(std::size_t satellite) const;
+    //! Get the number of records of the satellite with given index
+    std::size_t recordsCount(std::size_t satellite) const;
+    /*!
+        \brief Make the node from the record
+        \param satellite - index of satellite
+        \param record - index of record of the satellite
+        \return Node object
+    */
+    Node node(std::size_t satellite, std::size_t record) const;
+    /*!
+        \brief Find the record with nearest to \a t epoch
+        \param satellite - index of satellite
+        \param t - date and time
+        \return Index of record of the satellite
+    */
+    std::size_t nearestRecord(std::size_t satellite, std::time_t t) const;
+    /*!
+        \brief Make the node with nearest to \a t epoch
+        \param satelliteNumber - satellite number
+        \param t - date and time
+        \param node - buffer for the node
+        \return False if there is no such satellite
+    */
+    bool nearestNode(const std::string &satelliteNumber, std::time_t t,
+                     Node &node) const;
+    /*!
+        \brief Put the nodes of the satellite into the data set
+        \param satellite - index of satellite
+        \param dataSet - data set
+    */
+    void load(std::size_t satellite, DataSet &dataSet) const;
+    //! Put all nodes into the catalog
+    void load(Catalog &catalog) const;
+    /*!
+        \brief Write the snapshot of the catalog
+        \param catalog - catalog
+        \param stream - output stream
+        \return False if a satellite number is longer than 8 characters
+                or the stream is failed
+    */
+    static bool write(const Catalog &catalog, std::ostream &stream);
+    /*!
+        \brief Write the snapshot of the catalog into the file
+        \param catalog - catalog
+        \param fileName - name of the file
+        \return True if the file is written successfully
+    */
+    static bool write(const Catalog &catalog, const std::string &fileName);
+
+private:
+    Snapshot(const Snapshot&);            //!< Copying is unavailable.
+    Snapshot& operator=(const Snapshot&); //!< Copying is unavailable.
+
+    const unsigned char* satelliteEntry(std::size_t satellite) const;
+    const unsigned char* record(std::size_t satellite,
+                                std::size_t record) const;
+    double recordEpoch(std::size_t satellite, std::size_t record) const;
+
+    const unsigned char *m_data;
+    std::size_t m_size;
+    void *m_mapping;
+    std::size_t m_mappingSize;
+    Status m_status;
+    std::size_t m_satellitesCount;
+    std::size_t m_recordsCount;
+    std::size_t m_satellitesOffset;
+    std::size_t m_recordsOffset;
+    std::size_t m_stringsOffset;
+};
+
+} // namespace quicktle
+
+#endif // TLESNAPSHOT_H
@@ -0,0 +1,103 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file stats.h
+    \brief File contains the definition of quicktle::Stats class.
+*/
+
+#ifndef TLESTATS_H
+#define TLESTATS_H
+
+#include <iostream>
+#include <quicktle/node.h>
+
+/*!
+    \def QUICKTLE_STATS_INC(counter)
+    \brief Increment the counter of the current thread.
+           It expands to an empty statement if the library is built
+           without QUICKTLE_STATS definition (ENABLE_STATS cmake option).
+*/
+#ifdef QUICKTLE_STATS
+#define QUICKTLE_STATS_INC(counter) \
+    quicktle::Stats::increment(quicktle::Stats::counter)
+#define QUICKTLE_STATS_ERROR(code) quicktle::Stats::error(code)
+#else
+#define QUICKTLE_STATS_INC(counter) ((void)0)
+#define QUICKTLE_STATS_ERROR(code) ((void)0)
+#endif
+
+namespace quicktle
+{
+
+/*!
+    \brief Counters of the library hot paths: parsing, caching, errors,
+           reading and searching.
+
+    Every thread increments its own counters, Stats::collect() sums
+    the counters of all threads, including the finished ones.
+*/
+class Stats
+{
+public:
+    //! Counted event
+    enum Counter
+    {
+        FieldParses = 0, //!< Node field is parsed from TLE line
+        CacheHits,       //!< Node field is taken from cache
+        RecordsRead,     //!< Record is read by Stream
+        DataSetSearches, //!< DataSet is searched for the node by time
+        DataSetProbes,   //!< Node epoch is compared during the search
+        DataSetDecodes,  //!< Compressed block of DataSet is decoded
+        CountersCount
+    };
+
+    //! Constructor. All counters are zero.
+    Stats();
+    //! Check whether the library is built with the counters
+    static bool enabled();
+    //! Get the sum of the counters of all threads
+    static Stats collect();
+    //! Reset the counters of all threads
+    static void reset();
+    //! Increment the counter of the current thread
+    static void increment(Counter counter);
+    //! Increment the errors counter of the current thread
+    static void error(Node::ErrorCode code);
+    //! Get the value of the counter
+    unsigned long long value(Counter counter) const;
+    //! Get the number of errors with the given code
+    unsigned long long errors(Node::ErrorCode code) const;
+    //! Print the counters as text: one "name value" pair per line
+    void print(std::ostream &stream) const;
+    //! Print the counters as JSON object
+    void printJson(std::ostream &stream) const;
+
+    //! Number of counted error codes
+    static const int ErrorsCount = Node::InvalidFormat + 1;
+    //! Number of all counters
+    static const int ValuesCount = CountersCount + ErrorsCount;
+
+private:
+    unsigned long long m_values[ValuesCount];
+};
+
+} // namespace quicktle
+
+#endif // TLESTATS_H
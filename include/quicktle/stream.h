@@ -26,7 +26,7 @@
 #define TLESTREAM_H
 
 #include <iostream>
-#include <quicktle/dataset.h>
+#include <quicktle/catalog.h>
 
 namespace quicktle
 {
@@ -56,6 +56,13 @@ public:
         \return Reference to input stream
     */
     Stream& operator>>(DataSet &dataSet);
+    /*!
+        \brief Extract the Node object from the input stream
+               and put it into catalog
+        \param catalog - catalog
+        \return Reference to input stream
+    */
+    Stream& operator>>(Catalog &catalog);
     /*!
         \brief Operator bool()
         \return True if the input stream can be read further.
@@ -0,0 +1,139 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file threadpool.h
+    \brief File contains the definition of quicktle::ThreadPool class.
+*/
+
+#ifndef TLETHREADPOOL_H
+#define TLETHREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace quicktle
+{
+
+/*!
+    \brief Task scheduler with work stealing.
+
+    Every worker thread owns a queue of tasks. A worker takes the tasks
+    from the back of its own queue and, when the queue is empty, steals
+    the tasks from the front of the queues of other workers. The tasks
+    should not throw exceptions.
+*/
+class ThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+    typedef std::function<void(std::size_t)> Body;
+    typedef std::function<void(std::size_t, std::size_t)> Body2D;
+
+    /*!
+        \brief Constructor
+        \param threadsCount - number of worker threads. If it is 0,
+                              the number of hardware threads is used.
+    */
+    explicit ThreadPool(std::size_t threadsCount = 0);
+    //! Destructor. Waits for all submitted tasks.
+    ~ThreadPool();
+    //! Get the number of worker threads
+    std::size_t threadsCount() const;
+    /*!
+        \brief Get the index of the current thread, e.g. to choose
+               its own buffer for the results of the tasks
+        \return Index in [0, threadsCount()) for the worker threads
+                of this pool and threadsCount() for other threads
+    */
+    std::size_t currentThread() const;
+    /*!
+        \brief Put the task into the queue
+        \param task - task to be executed by one of the worker threads
+    */
+    void submit(const Task &task);
+    /*!
+        \brief Wait until all submitted tasks are completed.
+               The calling thread helps to execute them.
+    */
+    void wait();
+    /*!
+        \brief Execute \a body for each index in [begin, end).
+        \param begin - first index
+        \param end - index after the last one
+        \param body - function, called for each index
+        \param grain - maximal number of indices, processed by one task.
+                       If it is 0, the value is chosen automatically.
+
+        The range is split recursively, so the idle threads steal
+        the halves of heavy ranges. The calling thread takes part
+        in the execution and returns when all indices are processed.
+    */
+    void parallelFor(std::size_t begin, std::size_t end, const Body &body,
+                     std::size_t grain = 0);
+    /*!
+        \brief Execute \a body for each pair (row, column)
+               of the \a rows x \a columns grid, for example
+               satellites x time steps.
+        \param rows - number of rows
+        \param columns - number of columns
+        \param body - function, called for each (row, column) pair
+        \param grain - maximal number of cells, processed by one task.
+                       If it is 0, the value is chosen automatically.
+    */
+    void parallelFor(std::size_t rows, std::size_t columns,
+                     const Body2D &body, std::size_t grain = 0);
+
+private:
+    ThreadPool(const ThreadPool&);            //!< Copying is unavailable.
+    ThreadPool& operator=(const ThreadPool&); //!< Copying is unavailable.
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(std::size_t index);
+    bool takeTask(Task &task);
+    bool stealTask(std::size_t index, Task &task);
+    void execute(Task &task);
+    void splitRange(std::size_t begin, std::size_t end, std::size_t grain,
+                    const Body &body, std::atomic<std::size_t> &remaining);
+
+    std::vector<Queue*> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<std::size_t> m_queued;
+    std::atomic<std::size_t> m_pending;
+    std::atomic<std::size_t> m_next;
+    std::mutex m_mutex;
+    std::condition_variable m_taskCondition;
+    std::condition_variable m_doneCondition;
+    bool m_stop;
+};
+
+} // namespace quicktle
+
+#endif // TLETHREADPOOL_H
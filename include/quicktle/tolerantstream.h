@@ -0,0 +1,135 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file tolerantstream.h
+    \brief File contains the definition of quicktle::TolerantStream class.
+*/
+
+#ifndef TLETOLERANTSTREAM_H
+#define TLETOLERANTSTREAM_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <quicktle/catalog.h>
+#include <quicktle/columnbatch.h>
+#include <quicktle/recordfilter.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Reader of TLE records from the untrusted input.
+
+    The format of every record is detected by the prefixes of its lines:
+    the lines "1 " and "2 " are the data lines, any other line just
+    before "1 " line is the satellite name, so 2- and 3-lines records
+    may be mixed. The lines may be of any length, "\r", trailing spaces
+    and tabs and empty lines are ignored.
+
+    Only the valid records are returned: both data lines should be
+    present, have valid checksums and the same satellite number.
+    If the record is broken, the reading continues from the line,
+    which breaks it, so every line is examined once and one bad line
+    costs at most one record. The valid records may be filtered by
+    quicktle::RecordFilter before the Node objects are made.
+*/
+class TolerantStream
+{
+public:
+    /*!
+        \brief Constructor.
+        \param source - input stream
+    */
+    explicit TolerantStream(std::istream &source);
+    /*!
+        \brief Extract the next valid record from the input stream.
+               The node is not changed if there are no more records.
+        \param node - the Node object
+        \return Reference to itself
+    */
+    TolerantStream& operator>>(Node &node);
+    /*!
+        \brief Extract the next valid record and put it into data set
+        \param dataSet - data set
+        \return Reference to itself
+    */
+    TolerantStream& operator>>(DataSet &dataSet);
+    /*!
+        \brief Extract the next valid record and put it into catalog
+        \param catalog - catalog
+        \return Reference to itself
+    */
+    TolerantStream& operator>>(Catalog &catalog);
+    /*!
+        \brief Extract the next valid record and append its declared
+               fields to the batch. The Node object is not made.
+        \param batch - batch of columns
+        \return Reference to itself
+    */
+    TolerantStream& operator>>(ColumnBatch &batch);
+    /*!
+        \brief Operator bool(). The input is read up to the next
+               valid record.
+        \return True if there is a valid record, not extracted yet.
+    */
+    operator bool();
+    /*!
+        \brief Set the parsing mode (see Stream::enforceParsing())
+        \return Previous value of parsing mode.
+    */
+    bool enforceParsing(bool parsingMode);
+    //! Set the filter of the records. Default filter accepts everything.
+    void setFilter(const RecordFilter &filter);
+    //! Get the number of extracted records
+    std::size_t recordsCount() const;
+    //! Get the number of dropped records, which have "1 " line
+    std::size_t brokenRecordsCount() const;
+    //! Get the number of not empty lines, which are not in valid records
+    std::size_t skippedLinesCount() const;
+    //! Get the number of valid records, rejected by the filter
+    std::size_t rejectedRecordsCount() const;
+
+private:
+    TolerantStream(const TolerantStream&);            //!< Copying is unavailable.
+    TolerantStream& operator=(const TolerantStream&); //!< Copying is unavailable.
+
+    bool readLine(std::string &line);
+    bool findRecord();
+
+    std::istream *m_source;
+    bool m_enforceParsing;
+    RecordFilter m_filter;
+    std::string m_name;
+    std::string m_first;
+    std::string m_second;
+    std::string m_line;     //!< Line, which is read ahead
+    bool m_hasLine;         //!< Whether m_line is not examined yet
+    bool m_hasName;         //!< Whether the record has the name line
+    bool m_ready;           //!< Whether the record is found, not extracted
+    std::size_t m_recordsCount;
+    std::size_t m_brokenRecordsCount;
+    std::size_t m_skippedLinesCount;
+    std::size_t m_rejectedRecordsCount;
+};
+
+} // namespace quicktle
+
+#endif // TLETOLERANTSTREAM_H
@@ -0,0 +1,114 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file trace.h
+    \brief File contains the definition of quicktle::Trace
+           and quicktle::TraceSpan classes.
+*/
+
+#ifndef TLETRACE_H
+#define TLETRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+
+namespace quicktle
+{
+
+/*!
+    \brief Tracing of the library operations.
+
+    When the tracing is enabled, every quicktle::TraceSpan object stores
+    the time interval of its life into the ring buffer of the current
+    thread. The collected spans can be written in Chrome trace format
+    (chrome://tracing, Perfetto). When the tracing is disabled the span
+    costs one atomic load.
+*/
+class Trace
+{
+public:
+    //! Enable or disable the tracing
+    static void enable(bool enabled = true);
+    //! Check whether the tracing is enabled
+    static bool enabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+    /*!
+        \brief Set the size of ring buffer of the threads, which
+               have not traced anything yet. The oldest spans are
+               overwritten, when the buffer is full.
+        \param spansCount - number of spans in the buffer
+    */
+    static void setBufferSize(std::size_t spansCount);
+    //! Remove all collected spans
+    static void clear();
+    /*!
+        \brief Write the collected spans in Chrome trace JSON format.
+               It should be called, when the traced work is finished.
+        \param stream - output stream
+        \return True if the spans are written successfully
+    */
+    static bool write(std::ostream &stream);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/*!
+    \brief Traced block of code: the span starts in the constructor
+           and ends in the destructor.
+*/
+class TraceSpan
+{
+public:
+    /*!
+        \brief Constructor
+        \param name - span name. It must be a string literal or another
+                      string, which lives until the trace is written.
+    */
+    explicit TraceSpan(const char *name)
+        : m_name(0)
+    {
+        if (Trace::enabled())
+            start(name);
+    }
+    //! Destructor
+    ~TraceSpan()
+    {
+        if (m_name)
+            finish();
+    }
+
+private:
+    TraceSpan(const TraceSpan&);            //!< Copying is unavailable.
+    TraceSpan& operator=(const TraceSpan&); //!< Copying is unavailable.
+
+    void start(const char *name);
+    void finish();
+
+    const char *m_name;
+    long long m_start;
+};
+
+} // namespace quicktle
+
+#endif // TLETRACE_H
@@ -0,0 +1,134 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file validator.h
+    \brief File contains the definition of quicktle::Validator class.
+*/
+
+#ifndef TLEVALIDATOR_H
+#define TLEVALIDATOR_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <quicktle/node.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Checker of the TLE files, which does not create Node objects.
+
+    The validator walks the raw text line by line and checks the line
+    numbers, lengths, checksums, the format of numeric columns and the
+    agreement of the satellite numbers in both lines of a record.
+    Only the first issue of each line is reported.
+*/
+class Validator
+{
+public:
+    //! Kind of the problem of a line
+    enum Issue
+    {
+        TooShortLine = 0,        //!< Line is shorter than 69 characters
+        InvalidLineNumber,       //!< Line does not start with "1 " or "2 "
+        ChecksumMismatch,        //!< Line has invalid checksum
+        InvalidField,            //!< Column has invalid format
+        SatelliteNumberMismatch, //!< Lines have different satellite numbers
+        IncompleteRecord,        //!< Input is finished inside the record
+        TooLongLine,             //!< Line is longer than 69 characters
+        IssuesCount
+    };
+
+    //! Problem of a line
+    struct Error
+    {
+        std::size_t line;   //!< Line number, starting from 1
+        std::size_t column; //!< Column of the problem, starting from 1
+        Issue issue;        //!< Kind of the problem
+    };
+
+    /*!
+        \brief Constructor
+        \param fileType - TLE file type (2- or 3-lines)
+    */
+    explicit Validator(const FileType fileType = TwoLines);
+    /*!
+        \brief Set the maximal number of stored errors.
+               The records are counted after this limit anyway.
+    */
+    void setMaxErrors(std::size_t count);
+    /*!
+        \brief Check the text in memory
+        \param data - pointer to the text
+        \param size - size of the text
+        \return True if there are no errors
+    */
+    bool scan(const char *data, std::size_t size);
+    /*!
+        \brief Check the text of the input stream
+        \param stream - input stream
+        \return True if there are no errors and the stream is read
+    */
+    bool scan(std::istream &stream);
+    /*!
+        \brief Check the file
+        \param fileName - name of the file
+        \return True if there are no errors and the file is read
+    */
+    bool scanFile(const std::string &fileName);
+    //! Get the number of checked records
+    std::size_t recordsCount() const;
+    //! Get the number of records with at least one error
+    std::size_t invalidRecordsCount() const;
+    //! Get the stored errors
+    const std::vector<Error>& errors() const;
+    //! Get the name of the issue
+    static const char* issueName(Issue issue);
+    /*!
+        \brief Print the report: one line per error
+        \param stream - output stream
+    */
+    void print(std::ostream &stream) const;
+
+private:
+    void reset();
+    void feed(const char *data, std::size_t size);
+    void finish();
+    void checkLine(const char *line, std::size_t length);
+    void checkDataLine(const char *line, std::size_t length, char number);
+    void addError(std::size_t column, Issue issue);
+
+    FileType m_fileType;
+    std::size_t m_maxErrors;
+    std::vector<Error> m_errors;
+    std::string m_partialLine;
+    char m_satelliteNumber[5];
+    std::size_t m_lineNumber;
+    std::size_t m_position;
+    std::size_t m_recordsCount;
+    std::size_t m_invalidRecordsCount;
+    bool m_recordIsValid;
+};
+
+} // namespace quicktle
+
+#endif // TLEVALIDATOR_H
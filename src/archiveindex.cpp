@@ -0,0 +1,542 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file archiveindex.cpp
+    \brief File contains the realization of methods
+           of quicktle::ArchiveIndex class.
+*/
+
+#define INDEX_VERSION 2
+#define HEADER_SIZE 56
+#define ENTRY_SIZE 24
+#define NUMBER_LENGTH 8        //!< Max length of satellite number
+#define EPOCH_START 18         //!< Start of epoch in the line "1 ..."
+#define EPOCH_LENGTH 14        //!< Length of epoch in the line "1 ..."
+#define READ_BUFFER_SIZE (1 << 20)
+#define WRITE_BLOCK_SIZE 4096  //!< Number of entries, encoded at once
+#define FINGERPRINT_SIZE 65536 //!< Size of the hashed head and tail
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <quicktle/archiveindex.h>
+#include <quicktle/func.h>
+#include <quicktle/trace.h>
+#include <sys/stat.h>
+
+namespace quicktle
+{
+
+namespace
+{
+    const char MAGIC[8] = {'Q', 'T', 'L', 'E', 'I', 'N', 'D', 'X'};
+
+    // Offsets of the header fields
+    enum
+    {
+        Header_Version = 8,
+        Header_FileType = 12,
+        Header_EntriesCount = 16,
+        Header_ArchiveSize = 24,
+        Header_ArchiveTime = 32,
+        Header_Fingerprint = 40,
+        Header_PayloadChecksum = 44,
+        Header_HeaderChecksum = 48
+    };
+
+    // Offsets of the entry fields
+    enum
+    {
+        Entry_Number = 0,
+        Entry_Epoch = 8,
+        Entry_Offset = 16
+    };
+
+    //! Order of entries: by satellite number, then by epoch
+    bool lessEntry(const ArchiveIndex::Entry &a, const ArchiveIndex::Entry &b)
+    {
+        const int result = strncmp(a.satelliteNumber, b.satelliteNumber,
+                                   NUMBER_LENGTH);
+        return result ? result < 0 : a.epoch < b.epoch;
+    }
+
+    void encodeEntry(const ArchiveIndex::Entry &entry, unsigned char *p)
+    {
+        memcpy(p + Entry_Number, entry.satelliteNumber, NUMBER_LENGTH);
+        putDouble(p + Entry_Epoch, entry.epoch);
+        putU64(p + Entry_Offset, entry.offset);
+    }
+
+    void decodeEntry(const unsigned char *p, ArchiveIndex::Entry &entry)
+    {
+        memcpy(entry.satelliteNumber, p + Entry_Number, NUMBER_LENGTH);
+        entry.satelliteNumber[NUMBER_LENGTH - 1] = '\0';
+        entry.epoch = getDouble(p + Entry_Epoch);
+        entry.offset = getU64(p + Entry_Offset);
+    }
+}
+
+ArchiveIndex::ArchiveIndex(const FileType fileType)
+    : m_fileType(fileType)
+{
+    reset();
+}
+//------------------------------------------------------------------------------
+
+std::size_t ArchiveIndex::scan(const char *data, std::size_t size)
+{
+    TraceSpan span("ArchiveIndex::scan");
+
+    reset();
+    feed(data, size);
+    finish();
+
+    return m_entries.size();
+}
+//------------------------------------------------------------------------------
+
+std::size_t ArchiveIndex::scan(std::istream &stream)
+{
+    TraceSpan span("ArchiveIndex::scan");
+
+    reset();
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    while (stream)
+    {
+        stream.read(&buffer[0], buffer.size());
+        feed(&buffer[0], static_cast<std::size_t>(stream.gcount()));
+    }
+    finish();
+
+    return m_entries.size();
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveIndex::scanFile(const std::string &fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!file)
+    {
+        reset();
+        return false;
+    }
+
+    scan(file);
+    m_archiveTime = fileTime(fileName);
+    return !file.bad();
+}
+//------------------------------------------------------------------------------
+
+FileType ArchiveIndex::fileType() const
+{
+    return m_fileType;
+}
+//------------------------------------------------------------------------------
+
+std::size_t ArchiveIndex::size() const
+{
+    return m_entries.size();
+}
+//------------------------------------------------------------------------------
+
+const std::vector<ArchiveIndex::Entry>& ArchiveIndex::entries() const
+{
+    return m_entries;
+}
+//------------------------------------------------------------------------------
+
+std::pair<std::size_t, std::size_t> ArchiveIndex::find(
+                                        const std::string &satelliteNumber,
+                                        double t1, double t2) const
+{
+    Entry key;
+    memset(key.satelliteNumber, 0, sizeof(key.satelliteNumber));
+    strncpy(key.satelliteNumber, satelliteNumber.c_str(), NUMBER_LENGTH - 1);
+
+    key.epoch = t1;
+    const std::size_t first =
+        std::lower_bound(m_entries.begin(), m_entries.end(), key, lessEntry)
+        - m_entries.begin();
+    key.epoch = t2;
+    const std::size_t last =
+        std::upper_bound(m_entries.begin() + first, m_entries.end(), key,
+                         lessEntry)
+        - m_entries.begin();
+
+    return std::make_pair(first, last);
+}
+//------------------------------------------------------------------------------
+
+std::size_t ArchiveIndex::skippedCount() const
+{
+    return m_skippedCount;
+}
+//------------------------------------------------------------------------------
+
+unsigned long long ArchiveIndex::archiveSize() const
+{
+    return m_offset;
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveIndex::write(std::ostream &stream) const
+{
+    TraceSpan span("ArchiveIndex::write");
+
+    // The entries are encoded twice: for the checksum and for the output,
+    // so the huge index is not kept in memory in both forms.
+    std::vector<unsigned char> block(WRITE_BLOCK_SIZE * ENTRY_SIZE);
+    unsigned long payloadChecksum = fnv1a(0, 0);
+    for (std::size_t i = 0; i < m_entries.size(); i += WRITE_BLOCK_SIZE)
+    {
+        const std::size_t count = std::min<std::size_t>(WRITE_BLOCK_SIZE,
+                                                        m_entries.size() - i);
+        for (std::size_t j = 0; j < count; ++j)
+            encodeEntry(m_entries[i + j], &block[j * ENTRY_SIZE]);
+        payloadChecksum = fnv1a(&block[0], count * ENTRY_SIZE,
+                                payloadChecksum);
+    }
+
+    unsigned char header[HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    putU32(header + Header_Version, INDEX_VERSION);
+    putU32(header + Header_FileType, m_fileType);
+    putU64(header + Header_EntriesCount, m_entries.size());
+    putU64(header + Header_ArchiveSize, m_offset);
+    putU64(header + Header_ArchiveTime,
+           static_cast<unsigned long long>(m_archiveTime));
+    putU32(header + Header_Fingerprint, m_fingerprint);
+    putU32(header + Header_PayloadChecksum, payloadChecksum);
+    putU32(header + Header_HeaderChecksum,
+           fnv1a(header, Header_HeaderChecksum));
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    for (std::size_t i = 0; i < m_entries.size() && stream;
+         i += WRITE_BLOCK_SIZE)
+    {
+        const std::size_t count = std::min<std::size_t>(WRITE_BLOCK_SIZE,
+                                                        m_entries.size() - i);
+        for (std::size_t j = 0; j < count; ++j)
+            encodeEntry(m_entries[i + j], &block[j * ENTRY_SIZE]);
+        stream.write(reinterpret_cast<const char*>(&block[0]),
+                     count * ENTRY_SIZE);
+    }
+
+    return static_cast<bool>(stream);
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveIndex::write(const std::string &fileName) const
+{
+    std::ofstream file(fileName.c_str(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    return write(file) && file.flush();
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveIndex::read(std::istream &stream)
+{
+    TraceSpan span("ArchiveIndex::read");
+
+    reset();
+    unsigned char header[HEADER_SIZE];
+    if (!stream.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        memcmp(header, MAGIC, sizeof(MAGIC)) ||
+        getU32(header + Header_Version) != INDEX_VERSION ||
+        fnv1a(header, Header_HeaderChecksum) !=
+                                        getU32(header + Header_HeaderChecksum))
+    {
+        return false;
+    }
+
+    const unsigned long long count = getU64(header + Header_EntriesCount);
+    std::vector<unsigned char> block(WRITE_BLOCK_SIZE * ENTRY_SIZE);
+    unsigned long payloadChecksum = fnv1a(0, 0);
+    for (unsigned long long i = 0; i < count; i += WRITE_BLOCK_SIZE)
+    {
+        const std::size_t blockCount = static_cast<std::size_t>(
+                    std::min<unsigned long long>(WRITE_BLOCK_SIZE, count - i));
+        if (!stream.read(reinterpret_cast<char*>(&block[0]),
+                         blockCount * ENTRY_SIZE))
+        {
+            reset();
+            return false;
+        }
+
+        payloadChecksum = fnv1a(&block[0], blockCount * ENTRY_SIZE,
+                                payloadChecksum);
+        Entry entry;
+        for (std::size_t j = 0; j < blockCount; ++j)
+        {
+            decodeEntry(&block[j * ENTRY_SIZE], entry);
+            m_entries.push_back(entry);
+        }
+    }
+
+    if (payloadChecksum != getU32(header + Header_PayloadChecksum))
+    {
+        reset();
+        return false;
+    }
+
+    m_fileType = static_cast<FileType>(getU32(header + Header_FileType));
+    m_offset = getU64(header + Header_ArchiveSize);
+    m_archiveTime = static_cast<long long>(
+                                    getU64(header + Header_ArchiveTime));
+    m_fingerprint = getU32(header + Header_Fingerprint);
+    return true;
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveIndex::read(const std::string &fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!file)
+    {
+        reset();
+        return false;
+    }
+
+    return read(file);
+}
+//------------------------------------------------------------------------------
+
+std::string ArchiveIndex::fileName(const std::string &archiveName)
+{
+    return archiveName + ".qtx";
+}
+//------------------------------------------------------------------------------
+
+unsigned long ArchiveIndex::archiveFingerprint() const
+{
+    return m_fingerprint;
+}
+//------------------------------------------------------------------------------
+
+long long ArchiveIndex::archiveTime() const
+{
+    return m_archiveTime;
+}
+//------------------------------------------------------------------------------
+
+void ArchiveIndex::setArchiveTime(long long time)
+{
+    m_archiveTime = time;
+}
+//------------------------------------------------------------------------------
+
+unsigned long ArchiveIndex::fingerprint(std::istream &archive)
+{
+    archive.clear();
+    archive.seekg(0, std::ios::end);
+    const unsigned long long size =
+                        static_cast<unsigned long long>(archive.tellg());
+
+    // The head, then the tail without the bytes of the head
+    std::vector<char> buffer(FINGERPRINT_SIZE);
+    const std::size_t headSize = static_cast<std::size_t>(
+                    std::min<unsigned long long>(size, FINGERPRINT_SIZE));
+    archive.seekg(0, std::ios::beg);
+    archive.read(&buffer[0], headSize);
+    unsigned long hash = fnv1a(
+        reinterpret_cast<const unsigned char*>(&buffer[0]), headSize);
+
+    const unsigned long long tailFirst =
+        std::max<unsigned long long>(headSize, size - headSize);
+    const std::size_t tailSize = static_cast<std::size_t>(size - tailFirst);
+    archive.seekg(static_cast<std::streamoff>(tailFirst), std::ios::beg);
+    archive.read(&buffer[0], tailSize);
+    hash = fnv1a(reinterpret_cast<const unsigned char*>(&buffer[0]),
+                 tailSize, hash);
+
+    archive.clear();
+    archive.seekg(0, std::ios::beg);
+    return hash;
+}
+//------------------------------------------------------------------------------
+
+long long ArchiveIndex::fileTime(const std::string &fileName)
+{
+    struct stat status;
+    if (stat(fileName.c_str(), &status))
+        return 0;
+    return static_cast<long long>(status.st_mtime);
+}
+//------------------------------------------------------------------------------
+
+void ArchiveIndex::reset()
+{
+    m_entries.clear();
+    m_partialLine.clear();
+    m_offset = 0;
+    m_recordOffset = 0;
+    m_position = 0;
+    m_skippedCount = 0;
+    m_archiveTime = 0;
+    m_fingerprint = fnv1a(0, 0);
+    m_headHash = fnv1a(0, 0);
+    m_headSize = 0;
+    m_tail.clear();
+}
+//------------------------------------------------------------------------------
+
+void ArchiveIndex::feed(const char *data, std::size_t size)
+{
+    // The first and the last bytes are kept for the fingerprint
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(data);
+    if (m_headSize < FINGERPRINT_SIZE)
+    {
+        const std::size_t count = std::min<std::size_t>(
+                                    size, FINGERPRINT_SIZE - m_headSize);
+        m_headHash = fnv1a(bytes, count, m_headHash);
+        m_headSize += count;
+    }
+    if (size >= FINGERPRINT_SIZE)
+    {
+        m_tail.assign(data + size - FINGERPRINT_SIZE, FINGERPRINT_SIZE);
+    }
+    else
+    {
+        m_tail.append(data, size);
+        if (m_tail.size() > FINGERPRINT_SIZE)
+            m_tail.erase(0, m_tail.size() - FINGERPRINT_SIZE);
+    }
+
+    const char *end = data + size;
+    while (data < end)
+    {
+        const char *newline =
+            static_cast<const char*>(memchr(data, '\n', end - data));
+        if (!newline)
+        {
+            // The line is continued in the next block
+            m_partialLine.append(data, end);
+            return;
+        }
+
+        const unsigned long long offset = m_offset;
+        if (m_partialLine.empty())
+        {
+            m_offset += newline - data + 1;
+            addLine(data, newline - data, offset);
+        }
+        else
+        {
+            m_partialLine.append(data, newline);
+            m_offset += m_partialLine.length() + 1;
+            addLine(m_partialLine.data(), m_partialLine.length(), offset);
+            m_partialLine.clear();
+        }
+        data = newline + 1;
+    }
+}
+//------------------------------------------------------------------------------
+
+void ArchiveIndex::finish()
+{
+    if (!m_partialLine.empty())
+    {
+        const unsigned long long offset = m_offset;
+        m_offset += m_partialLine.length();
+        addLine(m_partialLine.data(), m_partialLine.length(), offset);
+        m_partialLine.clear();
+    }
+    m_position = 0;
+
+    // The bytes of the tail, which are in the head, are not hashed again
+    const unsigned long long tailFirst = m_offset - m_tail.size();
+    const std::size_t skip = (tailFirst < m_headSize)
+                           ? static_cast<std::size_t>(m_headSize - tailFirst)
+                           : 0;
+    m_fingerprint = fnv1a(
+        reinterpret_cast<const unsigned char*>(m_tail.data()) + skip,
+        m_tail.size() - skip, m_headHash);
+    std::string().swap(m_tail);
+
+    std::stable_sort(m_entries.begin(), m_entries.end(), lessEntry);
+}
+//------------------------------------------------------------------------------
+
+void ArchiveIndex::addLine(const char *line, std::size_t length,
+                           unsigned long long offset)
+{
+    if (length && line[length - 1] == '\r')
+        --length;
+
+    if (!m_position)
+    {
+        // Empty lines between the records are skipped
+        if (!length)
+            return;
+        m_recordOffset = offset;
+    }
+
+    // Only the line "1 ..." is parsed
+    const std::size_t linesCount = (m_fileType == ThreeLines) ? 3 : 2;
+    if (m_position + 2 == linesCount)
+        addEntry(line, length);
+
+    if (++m_position == linesCount)
+        m_position = 0;
+}
+//------------------------------------------------------------------------------
+
+void ArchiveIndex::addEntry(const char *line, std::size_t length)
+{
+    Entry entry;
+    if (!parseEntry(line, length, entry))
+    {
+        ++m_skippedCount;
+        return;
+    }
+
+    entry.offset = m_recordOffset;
+    m_entries.push_back(entry);
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveIndex::parseEntry(const char *line, std::size_t length,
+                              Entry &entry)
+{
+    if (length < EPOCH_START + EPOCH_LENGTH || line[0] != '1')
+        return false;
+
+    memset(entry.satelliteNumber, 0, sizeof(entry.satelliteNumber));
+    std::size_t start = 2;
+    std::size_t end = 7;
+    while (start < end && line[start] == ' ')
+        ++start;
+    while (end > start && line[end - 1] == ' ')
+        --end;
+    if (start == end)
+        return false;
+    memcpy(entry.satelliteNumber, line + start, end - start);
+
+    Node::ErrorCode error = Node::NoError;
+    entry.epoch = parseRawDate(line + EPOCH_START, EPOCH_LENGTH, error);
+    return error == Node::NoError;
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
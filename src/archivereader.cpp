@@ -0,0 +1,157 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file archivereader.cpp
+    \brief File contains the realization of methods
+           of quicktle::ArchiveReader class.
+*/
+
+#include <algorithm>
+#include <vector>
+#include <quicktle/archivereader.h>
+#include <quicktle/trace.h>
+
+namespace quicktle
+{
+
+ArchiveReader::ArchiveReader()
+{
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveReader::open(const std::string &archiveName,
+                         const FileType fileType)
+{
+    TraceSpan span("ArchiveReader::open");
+
+    close();
+    m_file.open(archiveName.c_str(), std::ios::in | std::ios::binary);
+    if (!m_file)
+        return false;
+
+    m_file.seekg(0, std::ios::end);
+    const unsigned long long size =
+                        static_cast<unsigned long long>(m_file.tellg());
+    m_file.seekg(0, std::ios::beg);
+
+    // The archive, edited in place, may keep its size: the time and
+    // the fingerprint are compared too
+    const long long time = ArchiveIndex::fileTime(archiveName);
+    const std::string indexName = ArchiveIndex::fileName(archiveName);
+    if (m_index.read(indexName) && m_index.archiveSize() == size &&
+        m_index.fileType() == fileType && m_index.archiveTime() == time &&
+        m_index.archiveFingerprint() == ArchiveIndex::fingerprint(m_file))
+    {
+        return true;
+    }
+
+    m_index = ArchiveIndex(fileType);
+    if (!m_index.scan(m_file) && m_file.bad())
+    {
+        close();
+        return false;
+    }
+    m_index.setArchiveTime(time);
+    m_file.clear();
+    // The index is rebuilt anyway, so a read-only directory is not an error
+    m_index.write(indexName);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+
+void ArchiveReader::close()
+{
+    if (m_file.is_open())
+        m_file.close();
+    m_file.clear();
+    m_index = ArchiveIndex();
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveReader::isOpen() const
+{
+    return m_file.is_open();
+}
+//------------------------------------------------------------------------------
+
+const ArchiveIndex& ArchiveReader::index() const
+{
+    return m_index;
+}
+//------------------------------------------------------------------------------
+
+std::size_t ArchiveReader::read(const std::string &satelliteNumber,
+                                double t1, double t2, DataSet &dataSet)
+{
+    TraceSpan span("ArchiveReader::read");
+
+    if (!isOpen())
+        return 0;
+
+    const std::pair<std::size_t, std::size_t> range =
+                                    m_index.find(satelliteNumber, t1, t2);
+
+    // The records are read in the order of the file
+    std::vector<unsigned long long> offsets;
+    offsets.reserve(range.second - range.first);
+    for (std::size_t i = range.first; i < range.second; ++i)
+        offsets.push_back(m_index.entries()[i].offset);
+    std::sort(offsets.begin(), offsets.end());
+
+    const bool threeLines = (m_index.fileType() == ThreeLines);
+    std::string line1, line2, line3;
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < offsets.size(); ++i)
+    {
+        m_file.clear();
+        m_file.seekg(static_cast<std::streamoff>(offsets[i]));
+        if ((threeLines && !readLine(line1)) || !readLine(line2) ||
+            !readLine(line3))
+        {
+            continue;
+        }
+
+        Node node;
+        const bool valid = threeLines ? node.assign(line1, line2, line3)
+                                      : node.assign(line2, line3);
+        if (!valid)
+            continue;
+
+        dataSet.append(node);
+        ++count;
+    }
+
+    return count;
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveReader::readLine(std::string &line)
+{
+    if (!std::getline(m_file, line))
+        return false;
+
+    if (!line.empty() && line[line.length() - 1] == '\r')
+        line.erase(line.length() - 1);
+    return true;
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
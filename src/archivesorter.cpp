@@ -0,0 +1,562 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file archivesorter.cpp
+    \brief File contains the realization of methods
+           of quicktle::ArchiveSorter class.
+*/
+
+#define DEFAULT_MEMORY_LIMIT (256 << 20)
+#define MERGE_WIDTH 64  //!< Max number of runs, merged at once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <sstream>
+#include <quicktle/archivesorter.h>
+#include <quicktle/threadpool.h>
+#include <quicktle/trace.h>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace quicktle
+{
+
+namespace
+{
+    //! Number of the next temporary file in this process
+    std::atomic<unsigned long> s_nextRun(0);
+
+    /*!
+        Compare the trimmed satellite numbers numerically: the number
+        with more significant digits is greater ("5" < "25544"), the
+        numbers of the same length are compared as strings, so Alpha-5
+        numbers ("A0001") follow "99999". The numbers, differing only by
+        the leading zeros, are ordered as strings.
+    */
+    int compareNumbers(const char *a, const char *b)
+    {
+        const char *p = a;
+        const char *q = b;
+        while (*p == '0')
+            ++p;
+        while (*q == '0')
+            ++q;
+
+        const std::size_t lengthA = strlen(p);
+        const std::size_t lengthB = strlen(q);
+        if (lengthA != lengthB)
+            return lengthA < lengthB ? -1 : 1;
+
+        const int result = strcmp(p, q);
+        return result ? result : strcmp(a, b);
+    }
+
+    //! Order of records: by satellite number, then by epoch
+    bool lessKey(const ArchiveIndex::Entry &a, const ArchiveIndex::Entry &b)
+    {
+        const int result = compareNumbers(a.satelliteNumber,
+                                          b.satelliteNumber);
+        return result ? result < 0 : a.epoch < b.epoch;
+    }
+
+    bool equalKey(const ArchiveIndex::Entry &a, const ArchiveIndex::Entry &b)
+    {
+        return !strcmp(a.satelliteNumber, b.satelliteNumber) &&
+               a.epoch == b.epoch;
+    }
+
+    void stripCarriageReturn(std::string &line)
+    {
+        if (!line.empty() && line[line.length() - 1] == '\r')
+            line.erase(line.length() - 1);
+    }
+}
+
+//! Records of the input in memory
+struct ArchiveSorter::Chunk
+{
+    //! Record: the key and the position of its text
+    struct Item
+    {
+        ArchiveIndex::Entry key;  //!< The offset is the start of the text
+        std::size_t length;
+        bool operator<(const Item &item) const
+        {
+            return lessKey(key, item.key);
+        }
+    };
+
+    std::string text;
+    std::vector<Item> items;
+};
+
+//! Chunks, sorted in parallel
+struct ArchiveSorter::Batch
+{
+    Batch(std::size_t threadsCount, std::size_t memoryLimit)
+        : pool(threadsCount),
+          chunks(pool.threadsCount()),
+          used(0)
+    {
+        chunkLimit = memoryLimit / chunks.size();
+        if (!chunkLimit)
+            chunkLimit = 1;
+    }
+
+    ThreadPool pool;
+    std::vector<Chunk> chunks;
+    std::size_t used;
+    std::size_t chunkLimit;
+};
+
+//! Sorted temporary file, which is merged
+struct ArchiveSorter::Run
+{
+    std::ifstream file;
+    std::string lines[3];
+    ArchiveIndex::Entry key;
+    std::size_t index;
+
+    bool next(std::size_t firstLine)
+    {
+        for (std::size_t i = firstLine; i < 3; ++i)
+        {
+            if (!std::getline(file, lines[i]))
+                return false;
+        }
+        return ArchiveIndex::parseEntry(lines[1].data(), lines[1].length(),
+                                        key);
+    }
+};
+
+namespace
+{
+    //! Order of runs in the heap: the least key is on the top
+    struct RunGreater
+    {
+        template <typename T>
+        bool operator()(const T *a, const T *b) const
+        {
+            if (lessKey(b->key, a->key))
+                return true;
+            if (lessKey(a->key, b->key))
+                return false;
+            // The earlier run keeps the first record of the input
+            return a->index > b->index;
+        }
+    };
+}
+
+ArchiveSorter::ArchiveSorter(const FileType fileType)
+    : m_fileType(fileType),
+      m_memoryLimit(DEFAULT_MEMORY_LIMIT),
+      m_directory("."),
+      m_threadsCount(0),
+      m_runsCount(0),
+      m_recordsCount(0),
+      m_duplicatesCount(0),
+      m_skippedCount(0)
+{
+}
+//------------------------------------------------------------------------------
+
+void ArchiveSorter::setMemoryLimit(std::size_t bytes)
+{
+    m_memoryLimit = bytes;
+}
+//------------------------------------------------------------------------------
+
+void ArchiveSorter::setTemporaryDirectory(const std::string &directory)
+{
+    m_directory = directory;
+}
+//------------------------------------------------------------------------------
+
+void ArchiveSorter::setThreadsCount(std::size_t count)
+{
+    m_threadsCount = count;
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveSorter::sort(const std::vector<std::string> &inputNames,
+                         std::ostream &output)
+{
+    const std::size_t firstLine = (m_fileType == ThreeLines) ? 0 : 1;
+    return sortInputs(inputNames, 0, false,
+                      [this, &output, firstLine](const std::string *lines)
+                      {
+                          for (std::size_t i = firstLine; i < 3; ++i)
+                              output << lines[i] << '\n';
+                          ++m_recordsCount;
+                          return static_cast<bool>(output);
+                      });
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveSorter::sort(const std::vector<std::string> &inputNames,
+                         const std::string &outputName)
+{
+    std::ofstream file(outputName.c_str(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    return sort(inputNames, file) && file.flush();
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveSorter::sort(const std::vector<std::string> &inputNames,
+                         const Sink &sink)
+{
+    const bool threeLines = (m_fileType == ThreeLines);
+    return sortInputs(inputNames, 0, true,
+                      [this, &sink, threeLines](const std::string *lines)
+                      {
+                          Node node;
+                          const bool valid = threeLines
+                                ? node.assign(lines[0], lines[1], lines[2])
+                                : node.assign(lines[1], lines[2]);
+                          if (!valid)
+                          {
+                              ++m_skippedCount;
+                              return true;
+                          }
+
+                          sink(node);
+                          ++m_recordsCount;
+                          return true;
+                      });
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveSorter::sort(std::istream &input, std::ostream &output)
+{
+    const std::size_t firstLine = (m_fileType == ThreeLines) ? 0 : 1;
+    return sortInputs(std::vector<std::string>(), &input, false,
+                      [this, &output, firstLine](const std::string *lines)
+                      {
+                          for (std::size_t i = firstLine; i < 3; ++i)
+                              output << lines[i] << '\n';
+                          ++m_recordsCount;
+                          return static_cast<bool>(output);
+                      });
+}
+//------------------------------------------------------------------------------
+
+std::size_t ArchiveSorter::recordsCount() const
+{
+    return m_recordsCount;
+}
+//------------------------------------------------------------------------------
+
+std::size_t ArchiveSorter::duplicatesCount() const
+{
+    return m_duplicatesCount;
+}
+//------------------------------------------------------------------------------
+
+std::size_t ArchiveSorter::skippedCount() const
+{
+    return m_skippedCount;
+}
+//------------------------------------------------------------------------------
+
+std::size_t ArchiveSorter::runsCount() const
+{
+    return m_runsCount;
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveSorter::sortInputs(const std::vector<std::string> &inputNames,
+                               std::istream *input, bool validate,
+                               const RecordSink &sink)
+{
+    TraceSpan span("ArchiveSorter::sort");
+
+    m_runs.clear();
+    m_runsCount = 0;
+    m_recordsCount = 0;
+    m_duplicatesCount = 0;
+    m_skippedCount = 0;
+
+    bool ok = true;
+    {
+        Batch batch(m_threadsCount, m_memoryLimit);
+        if (input)
+            ok = read(*input, batch, validate);
+
+        // The files are opened one by one: there may be thousands of them
+        for (std::size_t i = 0; ok && i < inputNames.size(); ++i)
+        {
+            std::ifstream file(inputNames[i].c_str(),
+                               std::ios::in | std::ios::binary);
+            ok = file && read(file, batch, validate);
+        }
+
+        ok = flush(batch) && ok;
+    }
+    m_runsCount = m_runs.size();
+
+    ok = ok && merge(sink);
+    removeRuns();
+
+    return ok;
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveSorter::read(std::istream &input, Batch &batch, bool validate)
+{
+    TraceSpan span("ArchiveSorter::read");
+
+    const std::size_t linesCount = (m_fileType == ThreeLines) ? 3 : 2;
+    std::string line;
+    std::size_t position = 0;
+    std::size_t recordStart = 0;
+    bool valid = false;
+    std::string lines[3];
+    Chunk::Item item;
+    while (std::getline(input, line))
+    {
+        stripCarriageReturn(line);
+        // Empty lines between the records are skipped
+        if (!position && line.empty())
+            continue;
+
+        Chunk &chunk = batch.chunks[batch.used];
+        if (!position)
+        {
+            recordStart = chunk.text.length();
+            valid = false;
+        }
+        chunk.text += line;
+        chunk.text += '\n';
+
+        // Only the line "1 ..." is parsed
+        if (position + 2 == linesCount)
+            valid = ArchiveIndex::parseEntry(line.data(), line.length(),
+                                             item.key);
+        if (validate)
+            lines[position].swap(line);
+
+        if (++position < linesCount)
+            continue;
+        position = 0;
+
+        // The broken record must not displace its valid duplicate,
+        // so the checksums are checked before the duplicates are dropped
+        if (valid && validate)
+        {
+            Node node;
+            valid = (linesCount == 3)
+                  ? node.assign(lines[0], lines[1], lines[2])
+                  : node.assign(lines[0], lines[1]);
+        }
+
+        if (!valid)
+        {
+            chunk.text.resize(recordStart);
+            ++m_skippedCount;
+            continue;
+        }
+
+        item.key.offset = recordStart;
+        item.length = chunk.text.length() - recordStart;
+        chunk.items.push_back(item);
+
+        if (chunk.text.length() >= batch.chunkLimit &&
+            ++batch.used == batch.chunks.size() && !flush(batch))
+        {
+            return false;
+        }
+    }
+
+    // Incomplete record at the end of the input
+    if (position)
+    {
+        Chunk &chunk = batch.chunks[batch.used];
+        chunk.text.resize(recordStart);
+        ++m_skippedCount;
+    }
+
+    return !input.bad();
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveSorter::flush(Batch &batch)
+{
+    // The last chunk may be partially filled
+    std::size_t count = batch.used;
+    if (count < batch.chunks.size() && !batch.chunks[count].items.empty())
+        ++count;
+    if (!count)
+        return true;
+
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < count; ++i)
+        names.push_back(runName());
+    m_runs.insert(m_runs.end(), names.begin(), names.end());
+
+    std::atomic<bool> ok(true);
+    batch.pool.parallelFor(0, count,
+                           [&batch, &names, &ok](std::size_t index)
+                           {
+                               TraceSpan span("ArchiveSorter::run");
+
+                               Chunk &chunk = batch.chunks[index];
+                               std::stable_sort(chunk.items.begin(),
+                                                chunk.items.end());
+
+                               std::ofstream file(names[index].c_str(),
+                                                  std::ios::out |
+                                                  std::ios::binary |
+                                                  std::ios::trunc);
+                               for (std::size_t i = 0;
+                                    file && i < chunk.items.size(); ++i)
+                               {
+                                   const Chunk::Item &item = chunk.items[i];
+                                   file.write(chunk.text.data() +
+                                                          item.key.offset,
+                                              item.length);
+                               }
+                               if (!file.flush())
+                                   ok = false;
+
+                               chunk.text.clear();
+                               chunk.items.clear();
+                           },
+                           1);
+
+    batch.used = 0;
+    return ok;
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveSorter::merge(const RecordSink &sink)
+{
+    // Too many runs are merged in several passes. The neighbouring runs
+    // are merged together, so the order of input is kept.
+    const std::size_t firstLine = (m_fileType == ThreeLines) ? 0 : 1;
+    bool ok = true;
+    while (ok && m_runs.size() > MERGE_WIDTH)
+    {
+        std::vector<std::string> merged;
+        for (std::size_t first = 0; ok && first < m_runs.size();
+             first += MERGE_WIDTH)
+        {
+            const std::size_t last = std::min<std::size_t>(
+                                        first + MERGE_WIDTH, m_runs.size());
+            merged.push_back(runName());
+            std::ofstream file(merged.back().c_str(),
+                               std::ios::out | std::ios::binary |
+                               std::ios::trunc);
+            ok = merge(first, last,
+                       [&file, firstLine](const std::string *lines)
+                       {
+                           for (std::size_t i = firstLine; i < 3; ++i)
+                               file << lines[i] << '\n';
+                           return static_cast<bool>(file);
+                       });
+            ok = file.flush() && ok;
+        }
+
+        removeRuns();
+        m_runs.swap(merged);
+    }
+
+    return ok && merge(0, m_runs.size(), sink);
+}
+//------------------------------------------------------------------------------
+
+bool ArchiveSorter::merge(std::size_t first, std::size_t last,
+                          const RecordSink &sink)
+{
+    TraceSpan span("ArchiveSorter::merge");
+
+    const std::size_t firstLine = (m_fileType == ThreeLines) ? 0 : 1;
+    std::vector<Run> runs(last - first);
+    std::priority_queue<Run*, std::vector<Run*>, RunGreater> heap;
+    for (std::size_t i = 0; i < runs.size(); ++i)
+    {
+        Run &run = runs[i];
+        run.index = i;
+        run.file.open(m_runs[first + i].c_str(),
+                      std::ios::in | std::ios::binary);
+        if (!run.file)
+            return false;
+        if (run.next(firstLine))
+            heap.push(&run);
+    }
+
+    ArchiveIndex::Entry previous;
+    bool hasPrevious = false;
+    while (!heap.empty())
+    {
+        Run *run = heap.top();
+        heap.pop();
+
+        if (hasPrevious && equalKey(previous, run->key))
+        {
+            ++m_duplicatesCount;
+        }
+        else
+        {
+            if (!sink(run->lines))
+                return false;
+            previous = run->key;
+            hasPrevious = true;
+        }
+
+        if (run->next(firstLine))
+            heap.push(run);
+        else if (run->file.bad())
+            return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+
+std::string ArchiveSorter::runName() const
+{
+    std::ostringstream name;
+    name << m_directory << "/qtlesort." << getpid() << "." << s_nextRun++
+         << ".run";
+    return name.str();
+}
+//------------------------------------------------------------------------------
+
+void ArchiveSorter::removeRuns()
+{
+    for (std::size_t i = 0; i < m_runs.size(); ++i)
+        std::remove(m_runs[i].c_str());
+    m_runs.clear();
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
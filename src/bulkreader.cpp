@@ -0,0 +1,782 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file bulkreader.cpp
+    \brief File contains the realization of methods
+           of quicktle::BulkReader class.
+*/
+
+#define DEFAULT_QUEUE_DEPTH 64  //!< Default number of reads in flight
+#define MAX_READ_SIZE (1 << 30) //!< Maximal size of one read request
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <quicktle/bulkreader.h>
+#include <quicktle/threadpool.h>
+#include <quicktle/trace.h>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef QUICKTLE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace quicktle
+{
+
+//! File, read by BulkReader
+struct BulkReader::File
+{
+    File()
+        : index(0),
+          descriptor(-1),
+          done(0),
+          failed(false)
+    {
+    }
+
+    std::string name;
+    std::size_t index; //!< Index in the list of files
+    std::string data;
+    int descriptor;
+    std::size_t done;  //!< Number of read bytes
+    bool failed;
+};
+
+//! Partial catalog, filled by one thread
+struct BulkReader::Partial
+{
+    //! Parsed node
+    struct Entry
+    {
+        std::time_t epoch;
+        std::size_t file;  //!< Index of the file in the list
+        Node node;
+    };
+    typedef std::map<std::string, std::vector<Entry> > Satellites;
+
+    Partial()
+        : recordsCount(0),
+          rejectedCount(0)
+    {
+    }
+
+    Satellites satellites;
+    std::size_t recordsCount;
+    std::size_t rejectedCount;
+};
+
+namespace
+{
+#ifdef QUICKTLE_IO_URING
+    /*!
+        \brief Submission and completion queues of io_uring.
+
+        The queues are shared with the kernel: the heads and tails
+        are accessed by the atomic operations with acquire/release
+        ordering.
+    */
+    class Ring
+    {
+    public:
+        Ring()
+            : m_descriptor(-1),
+              m_sqMemory(MAP_FAILED),
+              m_cqMemory(MAP_FAILED),
+              m_sqes(MAP_FAILED),
+              m_sqMemorySize(0),
+              m_cqMemorySize(0),
+              m_sqesSize(0),
+              m_queued(0)
+        {
+        }
+
+        ~Ring()
+        {
+            if (m_sqes != MAP_FAILED)
+                munmap(m_sqes, m_sqesSize);
+            if (m_cqMemory != MAP_FAILED && m_cqMemory != m_sqMemory)
+                munmap(m_cqMemory, m_cqMemorySize);
+            if (m_sqMemory != MAP_FAILED)
+                munmap(m_sqMemory, m_sqMemorySize);
+            if (m_descriptor >= 0)
+                close(m_descriptor);
+        }
+
+        bool init(unsigned entries)
+        {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            m_descriptor = syscall(__NR_io_uring_setup, entries, &params);
+            if (m_descriptor < 0)
+                return false;
+
+            m_sqMemorySize = params.sq_off.array
+                           + params.sq_entries * sizeof(unsigned);
+            m_cqMemorySize = params.cq_off.cqes
+                           + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single = (params.features & IORING_FEAT_SINGLE_MMAP);
+            if (single && m_cqMemorySize > m_sqMemorySize)
+                m_sqMemorySize = m_cqMemorySize;
+
+            m_sqMemory = mmap(0, m_sqMemorySize, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, m_descriptor,
+                              IORING_OFF_SQ_RING);
+            if (m_sqMemory == MAP_FAILED)
+                return false;
+            m_cqMemory = single
+                       ? m_sqMemory
+                       : mmap(0, m_cqMemorySize, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, m_descriptor,
+                              IORING_OFF_CQ_RING);
+            if (m_cqMemory == MAP_FAILED)
+                return false;
+            m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            m_sqes = mmap(0, m_sqesSize, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, m_descriptor,
+                          IORING_OFF_SQES);
+            if (m_sqes == MAP_FAILED)
+                return false;
+
+            char *sq = static_cast<char*>(m_sqMemory);
+            m_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            m_sqMask = *reinterpret_cast<unsigned*>(
+                sq + params.sq_off.ring_mask);
+            m_sqEntries = params.sq_entries;
+            m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+            char *cq = static_cast<char*>(m_cqMemory);
+            m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            m_cqMask = *reinterpret_cast<unsigned*>(
+                cq + params.cq_off.ring_mask);
+            m_cqes = reinterpret_cast<io_uring_cqe*>(
+                cq + params.cq_off.cqes);
+            return canRead();
+        }
+
+        //! Put the read request into the submission queue
+        bool read(int descriptor, char *buffer, unsigned size,
+                  unsigned long long offset, unsigned long long userData)
+        {
+            const unsigned tail = *m_sqTail;
+            if (tail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE)
+                    >= m_sqEntries)
+                return false;
+
+            const unsigned index = tail & m_sqMask;
+            io_uring_sqe &sqe = static_cast<io_uring_sqe*>(m_sqes)[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = descriptor;
+            sqe.addr = reinterpret_cast<unsigned long long>(buffer);
+            sqe.len = size;
+            sqe.off = offset;
+            sqe.user_data = userData;
+            m_sqArray[index] = index;
+            __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+            ++m_queued;
+            return true;
+        }
+
+        //! Submit the queued requests and wait for one completion
+        bool submitAndWait()
+        {
+            const int result = syscall(__NR_io_uring_enter, m_descriptor,
+                                       m_queued, 1, IORING_ENTER_GETEVENTS,
+                                       0, 0);
+            if (result < 0)
+                return false;
+            m_queued -= result;
+            return true;
+        }
+
+        //! Take the next completion
+        bool complete(unsigned long long &userData, int &result)
+        {
+            const unsigned head = *m_cqHead;
+            if (head == __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE))
+                return false;
+
+            const io_uring_cqe &cqe = m_cqes[head & m_cqMask];
+            userData = cqe.user_data;
+            result = cqe.res;
+            __atomic_store_n(m_cqHead, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+    private:
+        Ring(const Ring&);            //!< Copying is unavailable.
+        Ring& operator=(const Ring&); //!< Copying is unavailable.
+
+        /*!
+            \brief Check whether IORING_OP_READ is supported.
+
+            The operation and the probe have appeared in Linux 5.6,
+            io_uring itself in Linux 5.1, so the failed probe means
+            the kernel without the operation.
+        */
+        bool canRead() const
+        {
+            const unsigned count = IORING_OP_READ + 1;
+            std::vector<char> buffer(sizeof(io_uring_probe)
+                                     + count * sizeof(io_uring_probe_op));
+            io_uring_probe *probe =
+                reinterpret_cast<io_uring_probe*>(&buffer[0]);
+            if (syscall(__NR_io_uring_register, m_descriptor,
+                        IORING_REGISTER_PROBE, probe, count) < 0)
+                return false;
+            return probe->last_op >= IORING_OP_READ &&
+                   (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+        }
+
+        int m_descriptor;
+        void *m_sqMemory;
+        void *m_cqMemory;
+        void *m_sqes;
+        std::size_t m_sqMemorySize;
+        std::size_t m_cqMemorySize;
+        std::size_t m_sqesSize;
+        unsigned *m_sqHead;
+        unsigned *m_sqTail;
+        unsigned m_sqMask;
+        unsigned m_sqEntries;
+        unsigned *m_sqArray;
+        unsigned *m_cqHead;
+        unsigned *m_cqTail;
+        unsigned m_cqMask;
+        io_uring_cqe *m_cqes;
+        unsigned m_queued;
+    };
+#endif
+
+    //! Read the whole file in the current thread
+    bool readFile(const std::string &fileName, std::string &data)
+    {
+#ifndef _WIN32
+        const int descriptor = open(fileName.c_str(), O_RDONLY);
+        if (descriptor < 0)
+            return false;
+
+        struct stat status;
+        bool ok = (fstat(descriptor, &status) == 0);
+        if (ok)
+            data.resize(status.st_size);
+        std::size_t done = 0;
+        while (ok && done < data.size())
+        {
+            const ssize_t size = pread(descriptor, &data[done],
+                                       data.size() - done, done);
+            ok = (size > 0);
+            done += (ok ? size : 0);
+        }
+        close(descriptor);
+        return ok;
+#else
+        std::ifstream file(fileName.c_str(), std::ios_base::binary);
+        if (!file.is_open())
+            return false;
+        data.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+        return !file.bad();
+#endif
+    }
+}
+
+BulkReader::BulkReader(const FileType fileType)
+    : m_fileType(fileType),
+      m_threadsCount(0),
+      m_queueDepth(DEFAULT_QUEUE_DEPTH),
+      m_method(AutoDetect),
+      m_usedMethod(AutoDetect),
+      m_failedCount(0),
+      m_recordsCount(0),
+      m_rejectedCount(0)
+{
+}
+//------------------------------------------------------------------------------
+
+void BulkReader::setThreadsCount(std::size_t count)
+{
+    m_threadsCount = count;
+}
+//------------------------------------------------------------------------------
+
+void BulkReader::setQueueDepth(std::size_t depth)
+{
+    m_queueDepth = depth ? depth : 1;
+}
+//------------------------------------------------------------------------------
+
+void BulkReader::setMethod(Method method)
+{
+    m_method = method;
+}
+//------------------------------------------------------------------------------
+
+void BulkReader::setFilter(const RecordFilter &filter)
+{
+    m_filter = filter;
+}
+//------------------------------------------------------------------------------
+
+bool BulkReader::ioUringAvailable()
+{
+#ifdef QUICKTLE_IO_URING
+    Ring ring;
+    return ring.init(1);
+#else
+    return false;
+#endif
+}
+//------------------------------------------------------------------------------
+
+bool BulkReader::read(const std::vector<std::string> &fileNames,
+                      Catalog &catalog)
+{
+    TraceSpan span("BulkReader::read");
+
+    m_failedCount = 0;
+    m_recordsCount = 0;
+    m_rejectedCount = 0;
+
+    std::vector<File> files(fileNames.size());
+    for (std::size_t i = 0; i < files.size(); ++i)
+    {
+        files[i].name = fileNames[i];
+        files[i].index = i;
+    }
+
+    ThreadPool pool(m_threadsCount);
+    // One partial catalog per worker and one for the calling thread,
+    // which executes the tasks too, while it waits for them
+    std::vector<Partial> partials(pool.threadsCount() + 1);
+
+    m_usedMethod = m_method;
+    if (m_method != Pread && readByRing(files, partials, pool))
+    {
+        m_usedMethod = IoUring;
+    }
+    else if (m_method == IoUring)
+    {
+        return false;
+    }
+    else
+    {
+        m_usedMethod = Pread;
+        readByPread(files, partials, pool);
+    }
+    pool.wait();
+
+    for (std::size_t i = 0; i < files.size(); ++i)
+        m_failedCount += (files[i].failed ? 1 : 0);
+    for (std::size_t i = 0; i < partials.size(); ++i)
+    {
+        m_recordsCount += partials[i].recordsCount;
+        m_rejectedCount += partials[i].rejectedCount;
+    }
+
+    merge(partials, catalog, pool);
+    return !m_failedCount;
+}
+//------------------------------------------------------------------------------
+
+bool BulkReader::readDirectory(const std::string &directory,
+                               Catalog &catalog)
+{
+    std::vector<std::string> fileNames;
+    if (!listDirectory(directory, fileNames))
+    {
+        m_failedCount = 0;
+        m_recordsCount = 0;
+        m_rejectedCount = 0;
+        return false;
+    }
+    return read(fileNames, catalog);
+}
+//------------------------------------------------------------------------------
+
+bool BulkReader::listDirectory(const std::string &directory,
+                               std::vector<std::string> &fileNames)
+{
+    fileNames.clear();
+#ifndef _WIN32
+    DIR *dir = opendir(directory.c_str());
+    if (!dir)
+        return false;
+
+    const std::string prefix = (directory.empty() ||
+                                directory[directory.size() - 1] == '/')
+                             ? directory : directory + "/";
+    while (const dirent *entry = readdir(dir))
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        const std::string fileName = prefix + entry->d_name;
+        struct stat status;
+        if (stat(fileName.c_str(), &status) == 0 && S_ISREG(status.st_mode))
+            fileNames.push_back(fileName);
+    }
+    closedir(dir);
+
+    std::sort(fileNames.begin(), fileNames.end());
+    return true;
+#else
+    (void)directory;
+    return false;
+#endif
+}
+//------------------------------------------------------------------------------
+
+BulkReader::Method BulkReader::usedMethod() const
+{
+    return m_usedMethod;
+}
+//------------------------------------------------------------------------------
+
+std::size_t BulkReader::failedCount() const
+{
+    return m_failedCount;
+}
+//------------------------------------------------------------------------------
+
+std::size_t BulkReader::recordsCount() const
+{
+    return m_recordsCount;
+}
+//------------------------------------------------------------------------------
+
+std::size_t BulkReader::rejectedCount() const
+{
+    return m_rejectedCount;
+}
+//------------------------------------------------------------------------------
+
+bool BulkReader::readByRing(std::vector<File> &files,
+                            std::vector<Partial> &partials, ThreadPool &pool)
+{
+#ifdef QUICKTLE_IO_URING
+    TraceSpan span("BulkReader::readByRing");
+
+    // The buffers of the abandoned requests outlive the ring
+    std::vector<std::string> abandoned;
+    Ring ring;
+    if (!ring.init(static_cast<unsigned>(m_queueDepth)))
+        return false;
+
+    // The reads are submitted by this thread, the read files are
+    // parsed by the workers
+    std::size_t next = 0;
+    std::size_t inFlight = 0;
+    std::size_t readCount = 0;
+    bool broken = false;
+    while (!broken && (next < files.size() || inFlight))
+    {
+        while (next < files.size() && inFlight < m_queueDepth)
+        {
+            File &file = files[next];
+            file.descriptor = open(file.name.c_str(), O_RDONLY);
+            struct stat status;
+            if (file.descriptor < 0 || fstat(file.descriptor, &status))
+            {
+                file.failed = true;
+            }
+            else if (status.st_size > 0)
+            {
+                file.data.resize(status.st_size);
+                const std::size_t size = std::min<std::size_t>(
+                    file.data.size(), MAX_READ_SIZE);
+                if (!ring.read(file.descriptor, &file.data[0], size, 0,
+                               next))
+                {
+                    // The queue is full, the file is opened again later
+                    close(file.descriptor);
+                    file.descriptor = -1;
+                    break;
+                }
+                ++inFlight;
+                ++next;
+                continue;
+            }
+
+            if (file.descriptor >= 0)
+                close(file.descriptor);
+            file.descriptor = -1;
+            ++next;
+        }
+
+        if (!inFlight)
+            continue;
+
+        if (!ring.submitAndWait())
+        {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                continue;
+            broken = true;
+            break;
+        }
+
+        unsigned long long index;
+        int result;
+        while (ring.complete(index, result))
+        {
+            File &file = files[index];
+            --inFlight;
+            if (result == -EINVAL || result == -EOPNOTSUPP)
+            {
+                // The reading is not supported for this file
+                broken = true;
+                break;
+            }
+            if (result > 0)
+                file.done += result;
+
+            if (result > 0 && file.done < file.data.size())
+            {
+                // The rest of the file is requested again
+                const std::size_t size = std::min<std::size_t>(
+                    file.data.size() - file.done, MAX_READ_SIZE);
+                if (ring.read(file.descriptor, &file.data[file.done], size,
+                              file.done, index))
+                {
+                    ++inFlight;
+                    continue;
+                }
+            }
+
+            close(file.descriptor);
+            file.descriptor = -1;
+            if (file.done < file.data.size())
+            {
+                file.failed = true;
+                continue;
+            }
+            ++readCount;
+            pool.submit([this, &file, &partials, &pool]()
+                        {
+                            parse(file, partials, pool);
+                        });
+        }
+    }
+    if (!broken)
+        return true;
+
+    // The requests in flight are abandoned, the files, which are not
+    // read yet, are read by pread()
+    std::vector<File*> rest;
+    for (std::size_t i = 0; i < next; ++i)
+    {
+        File &file = files[i];
+        if (file.descriptor < 0)
+            continue;
+        close(file.descriptor);
+        file.descriptor = -1;
+        file.done = 0;
+        abandoned.push_back(std::string());
+        abandoned.back().swap(file.data);
+        rest.push_back(&file);
+    }
+    if (!readCount)
+    {
+        // Nothing has been read by the ring: all the files are read again
+        for (std::size_t i = 0; i < files.size(); ++i)
+            files[i].failed = false;
+        return false;
+    }
+
+    for (std::size_t i = next; i < files.size(); ++i)
+        rest.push_back(&files[i]);
+    pool.parallelFor(0, rest.size(),
+                     [this, &rest, &partials, &pool](std::size_t i)
+                     {
+                         readAndParse(*rest[i], partials, pool);
+                     },
+                     1);
+    return true;
+#else
+    (void)files;
+    (void)partials;
+    (void)pool;
+    return false;
+#endif
+}
+//------------------------------------------------------------------------------
+
+void BulkReader::readByPread(std::vector<File> &files,
+                             std::vector<Partial> &partials, ThreadPool &pool)
+{
+    TraceSpan span("BulkReader::readByPread");
+
+    // Every worker reads and parses its files, so up to the number of
+    // threads reads are in flight
+    pool.parallelFor(0, files.size(),
+                     [this, &files, &partials, &pool](std::size_t i)
+                     {
+                         readAndParse(files[i], partials, pool);
+                     },
+                     1);
+}
+//------------------------------------------------------------------------------
+
+void BulkReader::readAndParse(File &file, std::vector<Partial> &partials,
+                              const ThreadPool &pool) const
+{
+    file.failed = !readFile(file.name, file.data);
+    if (!file.failed)
+        parse(file, partials, pool);
+}
+//------------------------------------------------------------------------------
+
+void BulkReader::parse(File &file, std::vector<Partial> &partials,
+                       const ThreadPool &pool) const
+{
+    TraceSpan span("BulkReader::parse");
+
+    Partial &partial = partials[pool.currentThread()];
+    Partial::Entry entry;
+    entry.file = file.index;
+
+    const std::size_t linesCount = (m_fileType == ThreeLines) ? 3 : 2;
+    std::string lines[3];
+    std::size_t count = 0;
+
+    const char *position = file.data.data();
+    const char *end = position + file.data.size();
+    while (position < end)
+    {
+        const char *eol = static_cast<const char*>(
+            std::memchr(position, '\n', end - position));
+        if (!eol)
+            eol = end;
+
+        const char *last = eol;
+        if (last > position && *(last - 1) == '\r')
+            --last;
+        if (last > position)
+            lines[count++].assign(position, last);
+        position = eol + 1;
+
+        if (count < linesCount)
+            continue;
+
+        count = 0;
+        const std::string &first = lines[linesCount - 2];
+        const std::string &second = lines[linesCount - 1];
+        if (!m_filter.empty() &&
+            !m_filter.accept(NodeView(first.data(), first.size(),
+                                      second.data(), second.size())))
+        {
+            ++partial.rejectedCount;
+            continue;
+        }
+
+        if (m_fileType == ThreeLines)
+            entry.node.assign(lines[0], lines[1], lines[2], true);
+        else
+            entry.node.assign(lines[0], lines[1], true);
+        entry.epoch = entry.node.epoch();
+        partial.satellites[entry.node.satelliteNumber()].push_back(entry);
+        ++partial.recordsCount;
+    }
+
+    std::string().swap(file.data);
+}
+//------------------------------------------------------------------------------
+
+void BulkReader::merge(std::vector<Partial> &partials, Catalog &catalog,
+                       ThreadPool &pool)
+{
+    TraceSpan span("BulkReader::merge");
+
+    // The data sets are added to the catalog by this thread, then
+    // every task fills the data set of its own satellite
+    std::map<std::string, DataSet*> dataSets;
+    for (std::size_t i = 0; i < partials.size(); ++i)
+    {
+        const Partial::Satellites &satellites = partials[i].satellites;
+        for (Partial::Satellites::const_iterator it = satellites.begin();
+             it != satellites.end(); ++it)
+        {
+            DataSet *&dataSet = dataSets[it->first];
+            if (!dataSet)
+                dataSet = &catalog.dataSet(it->first);
+        }
+    }
+
+    std::vector<std::pair<const std::string*, DataSet*> > targets;
+    targets.reserve(dataSets.size());
+    for (std::map<std::string, DataSet*>::const_iterator it =
+             dataSets.begin(); it != dataSets.end(); ++it)
+        targets.push_back(std::make_pair(&it->first, it->second));
+
+    pool.parallelFor(0, targets.size(),
+                     [&partials, &targets](std::size_t i)
+                     {
+                         std::vector<Partial::Entry> entries;
+                         for (std::size_t k = 0; k < partials.size(); ++k)
+                         {
+                             Partial::Satellites &satellites =
+                                 partials[k].satellites;
+                             Partial::Satellites::iterator it =
+                                 satellites.find(*targets[i].first);
+                             if (it == satellites.end())
+                                 continue;
+                             if (entries.empty())
+                                 entries.swap(it->second);
+                             else
+                                 entries.insert(entries.end(),
+                                                it->second.begin(),
+                                                it->second.end());
+                         }
+
+                         // The nodes of one file are kept in one partial
+                         // catalog in their order, so the stable sorting
+                         // keeps the order of the sequential reading
+                         std::stable_sort(
+                             entries.begin(), entries.end(),
+                             [](const Partial::Entry &left,
+                                const Partial::Entry &right)
+                             {
+                                 return left.epoch < right.epoch ||
+                                        (left.epoch == right.epoch &&
+                                         left.file < right.file);
+                             });
+
+                         DataSet &dataSet = *targets[i].second;
+                         for (std::size_t k = 0; k < entries.size(); ++k)
+                             dataSet.append(entries[k].node);
+                     });
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
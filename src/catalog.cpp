@@ -0,0 +1,160 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file catalog.cpp
+    \brief File contains the realization of methods of quicktle::Catalog class.
+*/
+
+#include <algorithm>
+#include <quicktle/catalog.h>
+#include <quicktle/stream.h>
+#include <quicktle/trace.h>
+
+namespace quicktle
+{
+
+Catalog& Catalog::append(const Node &node)
+{
+    m_data[node.satelliteNumber()].append(node);
+    return *this;
+}
+//------------------------------------------------------------------------------
+
+bool Catalog::remove(const std::string &satelliteNumber)
+{
+    return m_data.erase(satelliteNumber) > 0;
+}
+//------------------------------------------------------------------------------
+
+std::size_t Catalog::merge(Stream &delta, std::vector<std::string> *changed)
+{
+    TraceSpan span("Catalog::merge");
+
+    if (changed)
+        changed->clear();
+
+    std::size_t count = 0;
+    Container::iterator last = m_data.end();
+    Node node;
+    while (delta)
+    {
+        delta >> node;
+        if (node.lastError() != Node::NoError)
+            continue;
+
+        // The records of one satellite usually follow each other
+        const std::string number = node.satelliteNumber();
+        if (last == m_data.end() || last->first != number)
+        {
+            last = m_data.insert(std::make_pair(number, DataSet())).first;
+            if (changed)
+                changed->push_back(number);
+        }
+        // New epochs are usually the latest ones, they are appended
+        // to the end of data set without moving the other nodes
+        last->second.append(node);
+        ++count;
+    }
+
+    if (changed)
+    {
+        std::sort(changed->begin(), changed->end());
+        changed->erase(std::unique(changed->begin(), changed->end()),
+                       changed->end());
+    }
+
+    return count;
+}
+//------------------------------------------------------------------------------
+
+std::size_t Catalog::merge(const Catalog &delta,
+                           std::vector<std::string> *changed)
+{
+    if (changed)
+        changed->clear();
+
+    std::size_t count = 0;
+    for (ConstIterator it = delta.begin(); it != delta.end(); ++it)
+    {
+        const DataSet &nodes = it->second;
+        if (!nodes.size())
+            continue;
+
+        DataSet &dataSet = m_data[it->first];
+        for (DataSet::IndexType i = 0; i < nodes.size(); ++i)
+            dataSet.append(nodes.node(i));
+
+        count += nodes.size();
+        if (changed)
+            changed->push_back(it->first);
+    }
+
+    return count;
+}
+//------------------------------------------------------------------------------
+
+void Catalog::clear()
+{
+    m_data.clear();
+}
+//------------------------------------------------------------------------------
+
+std::size_t Catalog::size() const
+{
+    return m_data.size();
+}
+//------------------------------------------------------------------------------
+
+std::size_t Catalog::nodesCount() const
+{
+    std::size_t count = 0;
+    for (ConstIterator it = m_data.begin(); it != m_data.end(); ++it)
+        count += it->second.size();
+
+    return count;
+}
+//------------------------------------------------------------------------------
+
+const DataSet* Catalog::find(const std::string &satelliteNumber) const
+{
+    ConstIterator it = m_data.find(satelliteNumber);
+    return (it != m_data.end()) ? &it->second : 0;
+}
+//------------------------------------------------------------------------------
+
+DataSet& Catalog::dataSet(const std::string &satelliteNumber)
+{
+    return m_data[satelliteNumber];
+}
+//------------------------------------------------------------------------------
+
+Catalog::ConstIterator Catalog::begin() const
+{
+    return m_data.begin();
+}
+//------------------------------------------------------------------------------
+
+Catalog::ConstIterator Catalog::end() const
+{
+    return m_data.end();
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
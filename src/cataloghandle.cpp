@@ -0,0 +1,197 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file cataloghandle.cpp
+    \brief File contains the realization of methods
+           of quicktle::CatalogHandle class.
+*/
+
+#define READER_SLOTS 128  //!< Max number of simultaneous readers
+
+#include <thread>
+#include <quicktle/cataloghandle.h>
+#include <quicktle/trace.h>
+
+namespace quicktle
+{
+
+namespace
+{
+    //! Slot, used by the current thread last time
+    thread_local std::size_t t_slot = 0;
+}
+
+CatalogHandle::ReadGuard::ReadGuard(std::atomic<unsigned long long> *slot,
+                                    const Catalog *catalog)
+    : m_slot(slot),
+      m_catalog(catalog)
+{
+}
+//------------------------------------------------------------------------------
+
+CatalogHandle::ReadGuard::ReadGuard(ReadGuard &&guard)
+    : m_slot(guard.m_slot),
+      m_catalog(guard.m_catalog)
+{
+    guard.m_slot = 0;
+    guard.m_catalog = 0;
+}
+//------------------------------------------------------------------------------
+
+CatalogHandle::ReadGuard::~ReadGuard()
+{
+    if (m_slot)
+        m_slot->store(0);
+}
+//------------------------------------------------------------------------------
+
+CatalogHandle::CatalogHandle()
+    : m_current(new Catalog),
+      m_epoch(1),
+      m_version(1),
+      m_slots(READER_SLOTS)
+{
+    for (std::size_t i = 0; i < m_slots.size(); ++i)
+        m_slots[i].epoch.store(0);
+}
+//------------------------------------------------------------------------------
+
+CatalogHandle::CatalogHandle(const Catalog &catalog)
+    : m_current(new Catalog(catalog)),
+      m_epoch(1),
+      m_version(1),
+      m_slots(READER_SLOTS)
+{
+    for (std::size_t i = 0; i < m_slots.size(); ++i)
+        m_slots[i].epoch.store(0);
+}
+//------------------------------------------------------------------------------
+
+CatalogHandle::~CatalogHandle()
+{
+    for (std::size_t i = 0; i < m_retired.size(); ++i)
+        delete m_retired[i].catalog;
+    delete m_current.load();
+}
+//------------------------------------------------------------------------------
+
+CatalogHandle::ReadGuard CatalogHandle::read() const
+{
+    // Announce the epoch in a free slot
+    const std::size_t count = m_slots.size();
+    std::size_t index = t_slot;
+    while (true)
+    {
+        unsigned long long expected = 0;
+        if (m_slots[index].epoch.compare_exchange_strong(expected,
+                                                         m_epoch.load()))
+            break;
+
+        index = (index + 1) % count;
+        if (index == t_slot)
+            std::this_thread::yield();
+    }
+    t_slot = index;
+
+    // The version can not be deleted after the epoch is announced
+    return ReadGuard(&m_slots[index].epoch, m_current.load());
+}
+//------------------------------------------------------------------------------
+
+void CatalogHandle::publish(const Catalog &catalog)
+{
+    Catalog *copy = new Catalog(catalog);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    replace(copy);
+}
+//------------------------------------------------------------------------------
+
+void CatalogHandle::update(const Update &update)
+{
+    TraceSpan span("CatalogHandle::update");
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Only the writers replace the current version
+    Catalog *catalog = new Catalog(*m_current.load());
+    update(*catalog);
+    replace(catalog);
+}
+//------------------------------------------------------------------------------
+
+unsigned long long CatalogHandle::version() const
+{
+    return m_version.load();
+}
+//------------------------------------------------------------------------------
+
+std::size_t CatalogHandle::retiredCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_retired.size();
+}
+//------------------------------------------------------------------------------
+
+void CatalogHandle::reclaim()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    reclaimLocked();
+}
+//------------------------------------------------------------------------------
+
+void CatalogHandle::replace(Catalog *catalog)
+{
+    Retired retired;
+    retired.catalog = m_current.exchange(catalog);
+    // The readers of the later epochs see the new version
+    retired.epoch = m_epoch.fetch_add(1) + 1;
+    m_retired.push_back(retired);
+    ++m_version;
+
+    reclaimLocked();
+}
+//------------------------------------------------------------------------------
+
+void CatalogHandle::reclaimLocked()
+{
+    if (m_retired.empty())
+        return;
+
+    unsigned long long oldest = m_epoch.load();
+    for (std::size_t i = 0; i < m_slots.size(); ++i)
+    {
+        const unsigned long long epoch = m_slots[i].epoch.load();
+        if (epoch && epoch < oldest)
+            oldest = epoch;
+    }
+
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < m_retired.size(); ++i)
+    {
+        if (m_retired[i].epoch <= oldest)
+            delete m_retired[i].catalog;
+        else
+            m_retired[kept++] = m_retired[i];
+    }
+    m_retired.resize(kept);
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
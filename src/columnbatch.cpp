@@ -0,0 +1,164 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file columnbatch.cpp
+    \brief File contains the realization of methods
+           of quicktle::ColumnBatch class.
+*/
+
+#include <algorithm>
+#include <quicktle/columnbatch.h>
+#include <quicktle/trace.h>
+
+namespace quicktle
+{
+
+ColumnBatch::ColumnBatch()
+    : m_size(0)
+{
+}
+//------------------------------------------------------------------------------
+
+void ColumnBatch::addField(Field field)
+{
+    if (m_size || field >= FieldsCount || hasField(field))
+        return;
+    m_fields.push_back(field);
+}
+//------------------------------------------------------------------------------
+
+bool ColumnBatch::hasField(Field field) const
+{
+    return std::find(m_fields.begin(), m_fields.end(), field)
+           != m_fields.end();
+}
+//------------------------------------------------------------------------------
+
+std::size_t ColumnBatch::size() const
+{
+    return m_size;
+}
+//------------------------------------------------------------------------------
+
+void ColumnBatch::reserve(std::size_t size)
+{
+    for (std::size_t i = 0; i < m_fields.size(); ++i)
+    {
+        if (isString(m_fields[i]))
+            m_strings[m_fields[i]].reserve(size);
+        else
+            m_values[m_fields[i]].reserve(size);
+    }
+}
+//------------------------------------------------------------------------------
+
+void ColumnBatch::clear()
+{
+    for (std::size_t i = 0; i < FieldsCount; ++i)
+    {
+        m_values[i].clear();
+        m_strings[i].clear();
+    }
+    m_size = 0;
+}
+//------------------------------------------------------------------------------
+
+bool ColumnBatch::append(const NodeView &view)
+{
+    TraceSpan span("ColumnBatch::append");
+
+    for (std::size_t i = 0; i < m_fields.size(); ++i)
+    {
+        const Field field = m_fields[i];
+        switch (field)
+        {
+        case SatelliteNumber:
+            m_strings[field].push_back(view.satelliteNumber());
+            break;
+        case SatelliteName:
+            m_strings[field].push_back(view.satelliteName());
+            break;
+        case Designator:
+            m_strings[field].push_back(view.designator());
+            break;
+        default:
+            m_values[field].push_back(value(view, field));
+        }
+    }
+    ++m_size;
+
+    return (view.lastError() == Node::NoError);
+}
+//------------------------------------------------------------------------------
+
+const std::vector<double>& ColumnBatch::values(Field field) const
+{
+    return m_values[field];
+}
+//------------------------------------------------------------------------------
+
+const std::vector<std::string>& ColumnBatch::strings(Field field) const
+{
+    return m_strings[field];
+}
+//------------------------------------------------------------------------------
+
+bool ColumnBatch::isString(Field field)
+{
+    return field == SatelliteNumber || field == SatelliteName ||
+           field == Designator;
+}
+//------------------------------------------------------------------------------
+
+double ColumnBatch::value(const NodeView &view, Field field)
+{
+    switch (field)
+    {
+    case Epoch:
+        return view.preciseEpoch();
+    case MeanMotion:
+        return view.n();
+    case MeanMotionDerivative:
+        return view.dn();
+    case MeanMotionSecondDerivative:
+        return view.d2n();
+    case Inclination:
+        return view.i();
+    case RightAscension:
+        return view.Omega();
+    case ArgumentOfPerigee:
+        return view.omega();
+    case MeanAnomaly:
+        return view.M();
+    case Eccentricity:
+        return view.e();
+    case Bstar:
+        return view.bstar();
+    case ElementNumber:
+        return view.elementNumber();
+    case RevolutionNumber:
+        return view.revolutionNumber();
+    default:
+        return 0;
+    }
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
@@ -0,0 +1,654 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file compressedinput.cpp
+    \brief File contains the realization of methods
+           of quicktle::CompressedInput class.
+*/
+
+#define INPUT_CHUNK_SIZE (64 * 1024)   //!< Size of read compressed chunk
+#define OUTPUT_BLOCK_SIZE (64 * 1024)  //!< Size of decompressed block
+#define OUTPUT_BLOCKS_COUNT 8          //!< Number of decompressed blocks
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <quicktle/compressedinput.h>
+#include <quicktle/trace.h>
+
+#ifdef QUICKTLE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef QUICKTLE_LZMA
+#include <lzma.h>
+#endif
+
+namespace quicktle
+{
+
+namespace
+{
+    //! Decompressor of one format
+    class Decoder
+    {
+    public:
+        enum Result
+        {
+            Ok = 0, //!< The decoding can be continued
+            End,    //!< The end of the data is reached
+            Error   //!< The data are damaged or truncated
+        };
+
+        virtual ~Decoder() {}
+        /*!
+            \brief Decode the next portion of data
+            \param in - input data, moved to the first unused byte
+            \param inSize - size of the input data
+            \param last - true if there is no input after \a in
+            \param out - output buffer, moved after the decoded data
+            \param outSize - free space in the output buffer
+            \return Result of the decoding
+        */
+        virtual Result decode(const char *&in, std::size_t &inSize,
+                              bool last, char *&out,
+                              std::size_t &outSize) = 0;
+    };
+
+    class PlainDecoder: public Decoder
+    {
+    public:
+        Result decode(const char *&in, std::size_t &inSize, bool last,
+                      char *&out, std::size_t &outSize)
+        {
+            if (!inSize)
+                return last ? End : Ok;
+
+            const std::size_t size = std::min(inSize, outSize);
+            std::memcpy(out, in, size);
+            in += size;
+            inSize -= size;
+            out += size;
+            outSize -= size;
+            return Ok;
+        }
+    };
+
+#ifdef QUICKTLE_ZLIB
+    //! Decoder of gzip data, the members are concatenated
+    class GzipDecoder: public Decoder
+    {
+    public:
+        GzipDecoder()
+            : m_ok(false),
+              m_end(false)
+        {
+            std::memset(&m_stream, 0, sizeof(m_stream));
+            m_ok = (inflateInit2(&m_stream, 16 + MAX_WBITS) == Z_OK);
+        }
+
+        ~GzipDecoder()
+        {
+            if (m_ok)
+                inflateEnd(&m_stream);
+        }
+
+        bool ok() const
+        {
+            return m_ok;
+        }
+
+        Result decode(const char *&in, std::size_t &inSize, bool last,
+                      char *&out, std::size_t &outSize)
+        {
+            if (m_end && inSize)
+            {
+                // The next member follows
+                inflateReset(&m_stream);
+                m_end = false;
+            }
+            if (m_end)
+                return last ? End : Ok;
+
+            m_stream.next_in =
+                reinterpret_cast<Bytef*>(const_cast<char*>(in));
+            m_stream.avail_in = static_cast<uInt>(inSize);
+            m_stream.next_out = reinterpret_cast<Bytef*>(out);
+            m_stream.avail_out = static_cast<uInt>(outSize);
+
+            const int code = inflate(&m_stream, Z_NO_FLUSH);
+
+            const std::size_t consumed = inSize - m_stream.avail_in;
+            const std::size_t produced = outSize - m_stream.avail_out;
+            in += consumed;
+            inSize -= consumed;
+            out += produced;
+            outSize -= produced;
+
+            if (code == Z_STREAM_END)
+            {
+                m_end = true;
+                return Ok;
+            }
+            if (code != Z_OK && code != Z_BUF_ERROR)
+                return Error;
+            if (!consumed && !produced && last && !inSize)
+                return Error;
+            return Ok;
+        }
+
+    private:
+        z_stream m_stream;
+        bool m_ok;
+        bool m_end;
+    };
+#endif
+
+#ifdef QUICKTLE_LZMA
+    //! Decoder of xz data, the streams are concatenated
+    class XzDecoder: public Decoder
+    {
+    public:
+        XzDecoder()
+            : m_ok(false)
+        {
+            lzma_stream stream = LZMA_STREAM_INIT;
+            m_stream = stream;
+            m_ok = (lzma_stream_decoder(&m_stream, UINT64_MAX,
+                                        LZMA_CONCATENATED) == LZMA_OK);
+        }
+
+        ~XzDecoder()
+        {
+            lzma_end(&m_stream);
+        }
+
+        bool ok() const
+        {
+            return m_ok;
+        }
+
+        Result decode(const char *&in, std::size_t &inSize, bool last,
+                      char *&out, std::size_t &outSize)
+        {
+            m_stream.next_in = reinterpret_cast<const uint8_t*>(in);
+            m_stream.avail_in = inSize;
+            m_stream.next_out = reinterpret_cast<uint8_t*>(out);
+            m_stream.avail_out = outSize;
+
+            const lzma_ret code = lzma_code(&m_stream,
+                                            last ? LZMA_FINISH : LZMA_RUN);
+
+            const std::size_t consumed = inSize - m_stream.avail_in;
+            const std::size_t produced = outSize - m_stream.avail_out;
+            in += consumed;
+            inSize -= consumed;
+            out += produced;
+            outSize -= produced;
+
+            if (code == LZMA_STREAM_END)
+                return End;
+            if (code == LZMA_OK)
+                return Ok;
+            if (code == LZMA_BUF_ERROR && !(last && !inSize))
+                return Ok;
+            return Error;
+        }
+
+    private:
+        lzma_stream m_stream;
+        bool m_ok;
+    };
+#endif
+
+    //! Detect the format by the first bytes of the data
+    CompressedInput::Format detect(const char *data, std::size_t size)
+    {
+        static const char gzip[] = "\x1f\x8b";
+        static const char xz[] = "\xfd" "7zXZ";
+
+        if (size >= 2 && !std::memcmp(data, gzip, 2))
+            return CompressedInput::Gzip;
+        if (size >= 6 && !std::memcmp(data, xz, 6))
+            return CompressedInput::Xz;
+        return CompressedInput::Plain;
+    }
+
+    //! Create the decoder of the format
+    Decoder* createDecoder(CompressedInput::Format format)
+    {
+        switch (format)
+        {
+        case CompressedInput::Plain:
+            return new PlainDecoder;
+#ifdef QUICKTLE_ZLIB
+        case CompressedInput::Gzip:
+        {
+            GzipDecoder *decoder = new GzipDecoder;
+            if (decoder->ok())
+                return decoder;
+            delete decoder;
+            return 0;
+        }
+#endif
+#ifdef QUICKTLE_LZMA
+        case CompressedInput::Xz:
+        {
+            XzDecoder *decoder = new XzDecoder;
+            if (decoder->ok())
+                return decoder;
+            delete decoder;
+            return 0;
+        }
+#endif
+        default:
+            return 0;
+        }
+    }
+}
+
+/*!
+    \brief Buffer of the decompressed data.
+
+    The blocks are passed between the helper thread and the reader
+    through two queues: the free blocks and the filled ones.
+*/
+class CompressedInput::Buffer: public std::streambuf
+{
+public:
+    Buffer();
+    ~Buffer();
+
+    bool open(std::istream *source, Format format);
+    void close();
+    bool isOpen() const;
+
+    std::ifstream file;
+    Format format;
+    bool damaged;
+    bool threaded;
+
+protected:
+    int_type underflow();
+
+private:
+    Buffer(const Buffer&);            //!< Copying is unavailable.
+    Buffer& operator=(const Buffer&); //!< Copying is unavailable.
+
+    void readInput();
+    std::size_t fill(std::vector<char> &block);
+    void run();
+
+    std::istream *m_source;
+    Decoder *m_decoder;
+    std::vector<char> m_input;
+    const char *m_in;
+    std::size_t m_inSize;
+    bool m_inputEnd;
+    bool m_end;
+    bool m_damaged;
+
+    bool m_threaded;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_freeCondition;
+    std::condition_variable m_filledCondition;
+    std::vector<std::vector<char> > m_blocks;
+    std::vector<std::size_t> m_sizes;
+    std::deque<std::size_t> m_free;
+    std::deque<std::size_t> m_filled;
+    std::size_t m_current;
+    bool m_finished;
+    bool m_stop;
+};
+//------------------------------------------------------------------------------
+
+CompressedInput::Buffer::Buffer()
+    : format(Plain),
+      damaged(false),
+      threaded(true),
+      m_source(0),
+      m_decoder(0),
+      m_input(INPUT_CHUNK_SIZE),
+      m_in(0),
+      m_inSize(0),
+      m_inputEnd(true),
+      m_end(true),
+      m_damaged(false),
+      m_threaded(false),
+      m_blocks(OUTPUT_BLOCKS_COUNT),
+      m_sizes(OUTPUT_BLOCKS_COUNT, 0),
+      m_current(OUTPUT_BLOCKS_COUNT),
+      m_finished(true),
+      m_stop(false)
+{
+}
+//------------------------------------------------------------------------------
+
+CompressedInput::Buffer::~Buffer()
+{
+    close();
+}
+//------------------------------------------------------------------------------
+
+bool CompressedInput::Buffer::open(std::istream *source, Format format)
+{
+    TraceSpan span("CompressedInput::open");
+
+    m_source = source;
+    m_inputEnd = false;
+    readInput();
+
+    if (format == AutoDetect)
+        format = detect(m_in, m_inSize);
+    m_decoder = createDecoder(format);
+    if (!m_decoder)
+    {
+        close();
+        return false;
+    }
+
+    this->format = format;
+    damaged = false;
+    m_end = false;
+    m_damaged = false;
+    m_threaded = threaded;
+    m_finished = false;
+    m_stop = false;
+    m_free.clear();
+    m_filled.clear();
+    m_current = OUTPUT_BLOCKS_COUNT;
+    for (std::size_t i = 0; i < OUTPUT_BLOCKS_COUNT; ++i)
+    {
+        m_blocks[i].resize(OUTPUT_BLOCK_SIZE);
+        m_free.push_back(i);
+    }
+    setg(0, 0, 0);
+
+    if (m_threaded)
+        m_thread = std::thread(&Buffer::run, this);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+
+bool CompressedInput::Buffer::isOpen() const
+{
+    return m_decoder != 0;
+}
+//------------------------------------------------------------------------------
+
+void CompressedInput::Buffer::close()
+{
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_freeCondition.notify_all();
+        m_thread.join();
+    }
+
+    delete m_decoder;
+    m_decoder = 0;
+    m_source = 0;
+    if (file.is_open())
+        file.close();
+    file.clear();
+
+    m_inSize = 0;
+    m_inputEnd = true;
+    m_end = true;
+    m_finished = true;
+    for (std::size_t i = 0; i < OUTPUT_BLOCKS_COUNT; ++i)
+        std::vector<char>().swap(m_blocks[i]);
+    setg(0, 0, 0);
+}
+//------------------------------------------------------------------------------
+
+CompressedInput::Buffer::int_type CompressedInput::Buffer::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    if (!m_decoder)
+        return traits_type::eof();
+
+    if (!m_threaded)
+    {
+        const std::size_t size = fill(m_blocks[0]);
+        damaged = m_damaged;
+        if (!size)
+            return traits_type::eof();
+        setg(&m_blocks[0][0], &m_blocks[0][0], &m_blocks[0][0] + size);
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_current < OUTPUT_BLOCKS_COUNT)
+    {
+        // The block has been read, the helper thread can refill it
+        m_free.push_back(m_current);
+        m_current = OUTPUT_BLOCKS_COUNT;
+        m_freeCondition.notify_one();
+    }
+
+    while (m_filled.empty() && !m_finished)
+        m_filledCondition.wait(lock);
+
+    if (m_filled.empty())
+    {
+        damaged = m_damaged;
+        setg(0, 0, 0);
+        return traits_type::eof();
+    }
+
+    m_current = m_filled.front();
+    m_filled.pop_front();
+    char *data = &m_blocks[m_current][0];
+    setg(data, data, data + m_sizes[m_current]);
+    return traits_type::to_int_type(*gptr());
+}
+//------------------------------------------------------------------------------
+
+void CompressedInput::Buffer::readInput()
+{
+    m_source->read(&m_input[0], m_input.size());
+    m_in = &m_input[0];
+    m_inSize = m_source->gcount();
+    if (m_inSize < m_input.size())
+        m_inputEnd = true;
+}
+//------------------------------------------------------------------------------
+
+std::size_t CompressedInput::Buffer::fill(std::vector<char> &block)
+{
+    TraceSpan span("CompressedInput::fill");
+
+    char *out = &block[0];
+    std::size_t outSize = block.size();
+    while (!m_end && outSize)
+    {
+        if (!m_inSize && !m_inputEnd)
+            readInput();
+
+        switch (m_decoder->decode(m_in, m_inSize, m_inputEnd, out, outSize))
+        {
+        case Decoder::Ok:
+            break;
+        case Decoder::End:
+            m_end = true;
+            break;
+        case Decoder::Error:
+            m_end = true;
+            m_damaged = true;
+            break;
+        }
+    }
+
+    return block.size() - outSize;
+}
+//------------------------------------------------------------------------------
+
+void CompressedInput::Buffer::run()
+{
+    while (true)
+    {
+        std::size_t index;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (m_free.empty() && !m_stop)
+                m_freeCondition.wait(lock);
+            if (m_stop)
+                break;
+            index = m_free.front();
+            m_free.pop_front();
+        }
+
+        const std::size_t size = fill(m_blocks[index]);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (size)
+        {
+            m_sizes[index] = size;
+            m_filled.push_back(index);
+        }
+        m_finished = m_end;
+        m_filledCondition.notify_one();
+        if (m_finished)
+            return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_finished = true;
+    m_filledCondition.notify_one();
+}
+//------------------------------------------------------------------------------
+
+CompressedInput::CompressedInput()
+    : std::istream(0),
+      m_buffer(new Buffer)
+{
+    init(m_buffer);
+    setstate(std::ios_base::failbit);
+}
+//------------------------------------------------------------------------------
+
+CompressedInput::CompressedInput(const std::string &fileName, Format format)
+    : std::istream(0),
+      m_buffer(new Buffer)
+{
+    init(m_buffer);
+    open(fileName, format);
+}
+//------------------------------------------------------------------------------
+
+CompressedInput::~CompressedInput()
+{
+    delete m_buffer;
+}
+//------------------------------------------------------------------------------
+
+bool CompressedInput::supported(Format format)
+{
+    switch (format)
+    {
+    case AutoDetect:
+    case Plain:
+        return true;
+#ifdef QUICKTLE_ZLIB
+    case Gzip:
+        return true;
+#endif
+#ifdef QUICKTLE_LZMA
+    case Xz:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+//------------------------------------------------------------------------------
+
+void CompressedInput::setThreaded(bool threaded)
+{
+    m_buffer->threaded = threaded;
+}
+//------------------------------------------------------------------------------
+
+bool CompressedInput::open(const std::string &fileName, Format format)
+{
+    close();
+
+    m_buffer->file.open(fileName.c_str(), std::ios_base::binary);
+    if (!m_buffer->file.is_open())
+        return false;
+
+    return open(m_buffer->file, format);
+}
+//------------------------------------------------------------------------------
+
+bool CompressedInput::open(std::istream &source, Format format)
+{
+    if (&source != &m_buffer->file)
+        close();
+
+    if (!m_buffer->open(&source, format))
+    {
+        setstate(std::ios_base::failbit);
+        return false;
+    }
+
+    clear();
+    return true;
+}
+//------------------------------------------------------------------------------
+
+void CompressedInput::close()
+{
+    m_buffer->close();
+    setstate(std::ios_base::failbit);
+}
+//------------------------------------------------------------------------------
+
+bool CompressedInput::isOpen() const
+{
+    return m_buffer->isOpen();
+}
+//------------------------------------------------------------------------------
+
+CompressedInput::Format CompressedInput::format() const
+{
+    return m_buffer->format;
+}
+//------------------------------------------------------------------------------
+
+bool CompressedInput::damaged() const
+{
+    return m_buffer->damaged;
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
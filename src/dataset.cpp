@@ -22,16 +22,104 @@
     \brief File contains the realization of methods of quicktle::DataSet class
 */
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <quicktle/dataset.h>
+#include <quicktle/historyblock.h>
+#include <quicktle/stats.h>
+#include <quicktle/trace.h>
 
 namespace quicktle
 {
 
+namespace
+{
+    //! Find the first node with the epoch not less than t
+    DataSet::IndexType search(const std::vector<Node> &nodes,
+                              const time_t &t, bool &found)
+    {
+        DataSet::IndexType size = nodes.size();
+        if (!size)
+            return 0;
+
+        time_t value;
+        QUICKTLE_STATS_INC(DataSetProbes);
+        if (t >= (value = nodes[size - 1].epoch()))
+        {
+            found = (value == t);
+            return (found ? size - 1 : size);
+        }
+
+        QUICKTLE_STATS_INC(DataSetProbes);
+        if (t <= (value = nodes[0].epoch()))
+        {
+            found = (value == t);
+            return 0;
+        }
+
+        DataSet::IndexType begin = 0;
+        DataSet::IndexType end = size - 1;
+        while (begin < end)
+        {
+            DataSet::IndexType middle = begin + (end - begin) / 2;
+            QUICKTLE_STATS_INC(DataSetProbes);
+            if (nodes[middle].epoch() < t)
+                begin = middle + 1;
+            else
+                end = middle;
+        }
+
+        found = (nodes[end].epoch() == t);
+
+        return end;
+    }
+
+    //! Decode the block, encoded by the data set itself
+    void decodeBlock(const std::vector<unsigned char> &data,
+                     std::vector<Node> &nodes)
+    {
+        if (!HistoryBlock::decode(&data[0], data.size(), nodes))
+        {
+            // The memory is damaged: the missing nodes must not be indexed
+            std::fputs("quicktle::DataSet: compressed block is damaged\n",
+                       stderr);
+            std::abort();
+        }
+    }
+}
+
+DataSet::DataSet()
+    : m_compressedSize(0),
+      m_blockSize(0),
+      m_recentSize(0),
+      m_cacheSize(1)
+{
+}
+//------------------------------------------------------------------------------
+
 DataSet& DataSet::append(const Node &node)
 {
+    TraceSpan span("DataSet::append");
+
     bool found = false;
     IndexType index = nearestNotLess(node.epoch(), found);
 
+    if (index < m_compressedSize)
+    {
+        // The node belongs to the history: re-encode its block
+        const IndexType block = findBlock(index);
+        std::vector<Node> nodes = decodedBlock(block);
+        const IndexType k = index - m_blocks[block].first;
+        if (found)
+            nodes[k] = node;
+        else
+            nodes.insert(nodes.begin() + k, node);
+        encodeBlock(block, nodes);
+        return *this;
+    }
+
+    index -= m_compressedSize;
     if (found)
         m_data[index] = node;
     else if (index >= m_data.size())
@@ -39,50 +127,37 @@ DataSet& DataSet::append(const Node &node)
     else
         m_data.insert(m_data.begin() + index, node);
 
-	return *this;
+    if (m_blockSize)
+        compressRecent();
+
+    return *this;
 }
 //------------------------------------------------------------------------------
 
 DataSet::IndexType DataSet::nearestNotLess(const time_t &t, bool &found) const
 {
     found = false;
-    IndexType size = m_data.size();
-    if (!size)
-        return 0;
+    QUICKTLE_STATS_INC(DataSetSearches);
 
-    time_t value;
-    if (t >= (value = m_data.at(size - 1).epoch()))
-    {
-        found = (value == t);
-        return (found ? size - 1 : size);
-    }
+    // Without compression, or if the epoch is after the history,
+    // the recent nodes are searched directly
+    if (!m_compressedSize || t > m_blocks.back().lastEpoch)
+        return m_compressedSize + search(m_data, t, found);
 
-    if (t <= (value = m_data.at(0).epoch()))
-    {
-        found = (value == t);
-        return 0;
-    }
-
-    IndexType begin = 0;
-    IndexType end = size - 1;
-    while (begin < end)
-    {
-        IndexType middle = begin + (end - begin) / 2;
-        if (m_data.at(middle).epoch() < t)
-            begin = middle + 1;
-        else
-            end = middle;
-    }
-
-    found = (m_data.at(end).epoch() == t);
-
-    return end;
+    // Choose the block by its epochs to decode only one of them
+    std::vector<Block>::const_iterator it =
+        std::lower_bound(m_blocks.begin(), m_blocks.end(), t,
+                         [](const Block &block, const time_t &value)
+                         {
+                             return block.lastEpoch < value;
+                         });
+    return it->first + search(decodedBlock(it - m_blocks.begin()), t, found);
 }
 //------------------------------------------------------------------------------
 
 DataSet::IndexType DataSet::size() const
 {
-    return m_data.size();
+    return m_compressedSize + m_data.size();
 }
 //------------------------------------------------------------------------------
 
@@ -94,41 +169,229 @@ bool DataSet::remove(const Node &node)
     if (!found)
         return false;
 
-    m_data.erase(m_data.begin() + index);
+    if (index < m_compressedSize)
+    {
+        const IndexType block = findBlock(index);
+        std::vector<Node> nodes = decodedBlock(block);
+        nodes.erase(nodes.begin() + (index - m_blocks[block].first));
+        encodeBlock(block, nodes);
+        return true;
+    }
+
+    m_data.erase(m_data.begin() + (index - m_compressedSize));
     return true;
 }
 //------------------------------------------------------------------------------
 
 const Node& DataSet::node(const IndexType &index) const
 {
-    return m_data.at(index);
+    if (index >= m_compressedSize)
+        return m_data.at(index - m_compressedSize);
+
+    const IndexType block = findBlock(index);
+    return decodedBlock(block)[index - m_blocks[block].first];
 }
 //------------------------------------------------------------------------------
 
 const Node& DataSet::nearestNode(const time_t &t) const
 {
-    IndexType size = m_data.size();
+    IndexType size = this->size();
     bool found = false;
     IndexType index = nearestNotLess(t, found);
 
     if (index == size)
         index = size - 1;
 
+    if (!m_compressedSize)
+    {
+        if (index > 0)
+        {
+            time_t dtLeft = t - m_data[index - 1].epoch();
+            time_t dtRight = m_data[index].epoch() - t;
+            if (dtLeft < dtRight)
+                --index;
+        }
+        return m_data.at(index);
+    }
+
     if (index > 0)
     {
-        time_t dtLeft = t - m_data.at(index - 1).epoch();
-        time_t dtRight = m_data.at(index).epoch() - t;
+        time_t dtLeft = t - node(index - 1).epoch();
+        time_t dtRight = node(index).epoch() - t;
         if (dtLeft < dtRight)
             --index;
     }
 
-    return m_data.at(index);
+    return node(index);
 }
 //------------------------------------------------------------------------------
 
 void DataSet::clear()
 {
     m_data.clear();
+    m_blocks.clear();
+    m_cache.clear();
+    m_compressedSize = 0;
+}
+//------------------------------------------------------------------------------
+
+void DataSet::setCompression(IndexType blockSize, IndexType recentSize,
+                             IndexType cacheSize)
+{
+    TraceSpan span("DataSet::setCompression");
+
+    decompressAll();
+    m_blockSize = blockSize;
+    m_recentSize = recentSize;
+    m_cacheSize = cacheSize ? cacheSize : 1;
+    compressRecent();
+}
+//------------------------------------------------------------------------------
+
+DataSet::IndexType DataSet::compressedSize() const
+{
+    return m_compressedSize;
+}
+//------------------------------------------------------------------------------
+
+std::size_t DataSet::compressedBytes() const
+{
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < m_blocks.size(); ++i)
+        bytes += m_blocks[i].data.size();
+    return bytes;
+}
+//------------------------------------------------------------------------------
+
+DataSet::IndexType DataSet::findBlock(const IndexType &index) const
+{
+    std::vector<Block>::const_iterator it =
+        std::upper_bound(m_blocks.begin(), m_blocks.end(), index,
+                         [](const IndexType &value, const Block &block)
+                         {
+                             return value < block.first;
+                         });
+    return (it - m_blocks.begin()) - 1;
+}
+//------------------------------------------------------------------------------
+
+const std::vector<Node>& DataSet::decodedBlock(const IndexType &block) const
+{
+    // The recently used blocks are at the front of the cache
+    for (std::list<CachedBlock>::iterator it = m_cache.begin();
+         it != m_cache.end(); ++it)
+    {
+        if (it->block == block)
+        {
+            m_cache.splice(m_cache.begin(), m_cache, it);
+            return it->nodes;
+        }
+    }
+
+    QUICKTLE_STATS_INC(DataSetDecodes);
+    m_cache.push_front(CachedBlock());
+    CachedBlock &cached = m_cache.front();
+    cached.block = block;
+    const Block &data = m_blocks[block];
+    decodeBlock(data.data, cached.nodes);
+
+    while (m_cache.size() > m_cacheSize)
+        m_cache.pop_back();
+
+    return cached.nodes;
+}
+//------------------------------------------------------------------------------
+
+void DataSet::encodeBlock(const IndexType &block,
+                          const std::vector<Node> &nodes)
+{
+    m_cache.clear();
+
+    if (nodes.empty())
+    {
+        m_blocks.erase(m_blocks.begin() + block);
+        updateBlocks();
+        return;
+    }
+
+    // The block, grown by insertions, is split into two halves
+    const IndexType count = (nodes.size() > 2 * m_blockSize)
+                          ? (nodes.size() + 1) / 2
+                          : nodes.size();
+    if (count < nodes.size())
+        m_blocks.insert(m_blocks.begin() + block + 1, Block());
+
+    for (IndexType first = 0, k = block; first < nodes.size();
+         first += count, ++k)
+    {
+        Block &data = m_blocks[k];
+        data.data.clear();
+        data.count = std::min(count, nodes.size() - first);
+        data.firstEpoch = nodes[first].epoch();
+        data.lastEpoch = nodes[first + data.count - 1].epoch();
+        HistoryBlock::encode(&nodes[first], data.count, data.data);
+        data.data.shrink_to_fit();
+    }
+
+    updateBlocks();
+}
+//------------------------------------------------------------------------------
+
+void DataSet::compressRecent()
+{
+    if (!m_blockSize || m_data.size() < m_recentSize + m_blockSize)
+        return;
+
+    TraceSpan span("DataSet::compressRecent");
+
+    const IndexType count = (m_data.size() - m_recentSize) / m_blockSize
+                          * m_blockSize;
+    for (IndexType first = 0; first < count; first += m_blockSize)
+    {
+        m_blocks.push_back(Block());
+        Block &block = m_blocks.back();
+        block.count = m_blockSize;
+        block.firstEpoch = m_data[first].epoch();
+        block.lastEpoch = m_data[first + m_blockSize - 1].epoch();
+        HistoryBlock::encode(&m_data[first], m_blockSize, block.data);
+        block.data.shrink_to_fit();
+    }
+    m_data.erase(m_data.begin(), m_data.begin() + count);
+
+    updateBlocks();
+}
+//------------------------------------------------------------------------------
+
+void DataSet::decompressAll()
+{
+    if (m_blocks.empty())
+        return;
+
+    TraceSpan span("DataSet::decompressAll");
+
+    std::vector<Node> nodes;
+    nodes.reserve(size());
+    for (std::size_t i = 0; i < m_blocks.size(); ++i)
+    {
+        decodeBlock(m_blocks[i].data, nodes);
+    }
+    nodes.insert(nodes.end(), m_data.begin(), m_data.end());
+    m_data.swap(nodes);
+
+    m_blocks.clear();
+    m_cache.clear();
+    m_compressedSize = 0;
+}
+//------------------------------------------------------------------------------
+
+void DataSet::updateBlocks()
+{
+    m_compressedSize = 0;
+    for (std::size_t i = 0; i < m_blocks.size(); ++i)
+    {
+        m_blocks[i].first = m_compressedSize;
+        m_compressedSize += m_blocks[i].count;
+    }
 }
 //------------------------------------------------------------------------------
 
@@ -26,16 +26,75 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <quicktle/func.h>
 
 #define UNIX_FIRST_YEAR 1970
 #define MAX_ANGLE (2 * M_PI)
+#define DOUBLE_MAX_LENGTH 330 //!< Max length of double in "%f" format
+#define RAW_FIELD_LENGTH 64   //!< Max length of field for raw parsers
 
 namespace quicktle
 {
 
+namespace
+{
+    //! Check whether the trimmed string is a valid floating-point number
+    bool isDouble(const char *val, std::size_t length)
+    {
+        for (std::size_t i = 0; i < length; i++)
+        {
+            bool valid = isdigit(val[i]);  // it is a digit
+            // it is not a digit, but it is a sign at the start
+            valid = valid || (i == 0 && (val[i] == '-' || val[i] == '+'));
+            // it is not a gigit and not a sign at the start,
+            // but it is 'e' or 'E'
+            valid = valid || (i > 0 && (val[i] == 'e' || val[i] == 'E') &&
+                              (isdigit(val[i - 1]) || val[i - 1] == '.') &&
+                              i < length - 1);
+            // it is not a gigit and not a sign at the start and not 'e'
+            // or 'E', but it is a sign after 'e' or 'E'
+            valid = valid || (i > 0 && (val[i] == '-' || val[i] == '+') &&
+                              (val[i - 1] == 'e' || val[i - 1] == 'E') &&
+                              i < length - 1);
+            // may be it is a decimal point?..
+            valid = valid || (val[i] == '.');
+
+            if (!valid)
+                return false;
+        }
+        return true;
+    }
+
+    //! Skip the spaces at the start and end of the characters
+    void trimRaw(const char *&str, std::size_t &length)
+    {
+        while (length && *str == ' ')
+        {
+            ++str;
+            --length;
+        }
+        while (length && str[length - 1] == ' ')
+            --length;
+    }
+
+    //! Replace the last sign, which is not after 'e', by "e" and the sign
+    void insertExponent(char *val, std::size_t &length, char sign)
+    {
+        std::size_t pos = length;
+        while (pos && val[pos - 1] != sign)
+            --pos;
+        if (pos < 2 || val[pos - 2] == 'e' || val[pos - 2] == 'E')
+            return;
+
+        memmove(val + pos, val + pos - 1, length - pos + 2);
+        val[pos - 1] = 'e';
+        ++length;
+    }
+}
+
 std::string int2string(const int val, const std::size_t fieldLength,
                        const bool leftAlign)
 {
@@ -50,17 +109,18 @@ std::string double2string(const double val, const std::size_t fieldLength,
                           const bool decimalPointAssumed,
                           const bool leftAlign)
 {
-    char str[fieldLength];
+    // The actual length of the value may exceed the field length
+    char str[fieldLength + DOUBLE_MAX_LENGTH];
     double val1 = val;
     if (decimalPointAssumed)
     {
         double val3;
         val1 = modf(val, &val3);
     }
-    sprintf(str, ("%" + int2string(fieldLength) + "." +
-                  int2string(precision + (scientific ? 1 : 0)) +
-                  (scientific ? "e" : "f")).c_str(),
-            val1);
+    snprintf(str, sizeof(str), ("%" + int2string(fieldLength) + "." +
+                                int2string(precision + (scientific ? 1 : 0)) +
+                                (scientific ? "e" : "f")).c_str(),
+             val1);
     std::string res(str);
 
     // Remove decimal point
@@ -68,7 +128,9 @@ std::string double2string(const double val, const std::size_t fieldLength,
     int n = 0;
     if (decimalPointAssumed && pos != std::string::npos && scientific)
     {
-        n = -pos;
+        // Digits before the point, the sign and spaces are not counted
+        for (std::size_t i = 0; i < pos; ++i)
+            n -= isdigit(res[i]) ? 1 : 0;
         res.replace(pos, 1, "");
     }
     else if (decimalPointAssumed && !scientific)
@@ -167,33 +229,10 @@ int string2int(const std::string &str, Node::ErrorCode &error)
 double string2double(const std::string &str, Node::ErrorCode &error)
 {
     std::string val = trim(str);
-    // Validate string
-    for (std::size_t i = 0; i < val.length(); i++)
+    if (!isDouble(val.c_str(), val.length()))
     {
-        bool valid = isdigit(val[i]);  // it is a digit
-        valid =
-            valid ||
-            (i == 0 &&
-             (val[i] == '-' ||
-              val[i] ==
-                  '+'));  // it is not a digit, but it is a sign at the start
-        // it is not a gigit and not a sign at the start, but it is 'e' or 'E'
-        valid = valid || (i > 0 && (val[i] == 'e' || val[i] == 'E') &&
-                          (isdigit(val[i - 1]) || val[i - 1] == '.') &&
-                          i < val.length() - 1);
-        // it is not a gigit and not a sign at the start and not 'e' or 'E', but
-        // it is a sign after 'e' or 'E'
-        valid = valid || (i > 0 && (val[i] == '-' || val[i] == '+') &&
-                          (val[i - 1] == 'e' || val[i - 1] == 'E') &&
-                          i < val.length() - 1);
-        // may be it is a decimal point?..
-        valid = valid || (val[i] == '.');
-
-        if (!valid)
-        {
-            error = Node::InvalidFormat;
-            return 0;
-        }
+        error = Node::InvalidFormat;
+        return 0;
     }
     return atof(val.c_str());
 }
@@ -215,7 +254,7 @@ std::string trim(const std::string &str)
 char parseChar(const std::string &line, const std::size_t index,
                Node::ErrorCode &error)
 {
-    if (line.length() - 1 < index)
+    if (index >= line.length())
     {
         error = Node::TooShortString;
         return '\0';
@@ -247,7 +286,7 @@ int parseInt(const std::string &line, const std::size_t start,
         return 0;
     }
 
-    return string2int(trim(line.substr(start, length)), error);
+    return parseRawInt(line.data() + start, length, error);
 }
 //------------------------------------------------------------------------------
 
@@ -261,38 +300,86 @@ double parseDouble(const std::string &line, const std::size_t start,
         return 0;
     }
 
-    std::string val = trim(line.substr(start, length));
+    return parseRawDouble(line.data() + start, length, error,
+                          decimalPointAssumed);
+}
+//------------------------------------------------------------------------------
+
+int parseRawInt(const char *str, std::size_t length, Node::ErrorCode &error)
+{
+    trimRaw(str, length);
+    if (length > RAW_FIELD_LENGTH)
+    {
+        error = Node::InvalidFormat;
+        return 0;
+    }
+
+    // Validate
+    for (std::size_t i = 0; i < length; i++)
+    {
+        if (!isdigit(str[i]) && !(i == 0 && (str[i] == '-' || str[i] == '+')))
+        {
+            error = Node::InvalidFormat;
+            return 0;
+        }
+    }
+
+    char val[RAW_FIELD_LENGTH + 1];
+    memcpy(val, str, length);
+    val[length] = '\0';
+
+    return atoi(val);
+}
+//------------------------------------------------------------------------------
+
+double parseRawDouble(const char *str, std::size_t length,
+                      Node::ErrorCode &error, const bool decimalPointAssumed)
+{
+    trimRaw(str, length);
+    if (length > RAW_FIELD_LENGTH)
+    {
+        error = Node::InvalidFormat;
+        return 0;
+    }
+
+    // Sign, "0.", value, two exponent symbols and terminating zero
+    char val[RAW_FIELD_LENGTH + 5];
+    std::size_t n = 0;
     // Prepare string
     if (decimalPointAssumed)
     {
-        if (val[0] == '-' || val[0] == '+')
-            val = val.substr(0, 1) + "0." + val.substr(1, val.length() - 1);
-        else
-            val = "0." + val;
+        if (length && (*str == '-' || *str == '+'))
+        {
+            val[n++] = *str++;
+            --length;
+        }
+        val[n++] = '0';
+        val[n++] = '.';
     }
+    memcpy(val + n, str, length);
+    n += length;
+    val[n] = '\0';
+
     // -- 123-4 or 123+4 -> 123e-4 or 123e4 --
-    std::size_t pos = val.rfind('-');
-    if (pos != std::string::npos && pos && val[pos - 1] != 'e'
-                                                       && val[pos - 1] != 'E')
-    {
-        val.replace(pos, 1, "e-");
-    }
-    pos = val.rfind('+');
-    if (pos != std::string::npos && pos && val[pos - 1] != 'e'
-                                                       && val[pos - 1] != 'E')
+    insertExponent(val, n, '-');
+    insertExponent(val, n, '+');
+
+    if (!isDouble(val, n))
     {
-        val.replace(pos, 1, "e+");
+        error = Node::InvalidFormat;
+        return 0;
     }
 
-    return string2double(val.c_str(), error);
+    return atof(val);
 }
 //------------------------------------------------------------------------------
 
-double string2date(const std::string &str, Node::ErrorCode &error)
+double parseRawDate(const char *str, std::size_t length,
+                    Node::ErrorCode &error)
 {
-    std::string str1(trim(str));
+    trimRaw(str, length);
     // Validate
-    if (str1.find('-') != std::string::npos)
+    if (memchr(str, '-', length) || length > RAW_FIELD_LENGTH)
     {
         error = Node::InvalidFormat;
         return 0;
@@ -300,7 +387,7 @@ double string2date(const std::string &str, Node::ErrorCode &error)
 
     // Year
     error = Node::NoError;
-    int year = string2int(str1.substr(0, 2).c_str(), error);
+    int year = parseRawInt(str, length < 2 ? length : 2, error);
     if (error != Node::NoError)
         return 0;
 
@@ -308,29 +395,63 @@ double string2date(const std::string &str, Node::ErrorCode &error)
           ? 2000
           : 1900;
 
-    double res = 0;
-    for (int y = UNIX_FIRST_YEAR; y < year; y++)
-    {
-        // If current year is leap
-        bool leap = !(y % 4) && ((y % 100) || !(y % 400));
-        res += leap ? 366 : 365;
-    }
-    // Years -> seconds
+    // Days before the year. The year is not less than UNIX_FIRST_YEAR
+    // ("57".."69" are 2057..2069), so the result is not negative.
+    const int last = year - 1;
+    const int first = UNIX_FIRST_YEAR - 1;
+    double res = 365. * (year - UNIX_FIRST_YEAR)
+               + (last / 4 - last / 100 + last / 400)
+               - (first / 4 - first / 100 + first / 400);
+    // Days -> seconds
     res *= 86400;
     // Additional part
-    res +=
-       (string2double(str1.substr(2, str1.length() - 2), error) - 1) * 86400;
+    if (length > 2)
+    {
+        const char *day = str + 2;
+        std::size_t dayLength = length - 2;
+        trimRaw(day, dayLength);
+
+        char val[RAW_FIELD_LENGTH + 1];
+        memcpy(val, day, dayLength);
+        val[dayLength] = '\0';
+        if (!isDouble(val, dayLength))
+        {
+            error = Node::InvalidFormat;
+            return res - 86400;
+        }
+        res += (atof(val) - 1) * 86400;
+    }
+    else
+    {
+        res -= 86400;
+    }
 
     return res;
 }
 //------------------------------------------------------------------------------
 
+double string2date(const std::string &str, Node::ErrorCode &error)
+{
+    return parseRawDate(str.data(), str.length(), error);
+}
+//------------------------------------------------------------------------------
+
 int checksum(const std::string &str)
+{
+    return checksum(str.data(), str.length());
+}
+//------------------------------------------------------------------------------
+
+int checksum(const char *str, const std::size_t length)
 {
     int checksum = 0;
-    for (std::size_t i = 0; i < str.length(); i++)
-        checksum += isdigit(str[i]) ? atoi(str.substr(i, 1).c_str())
-                                    : (str[i] == '-' ? 1 : 0);
+    for (std::size_t i = 0; i < length; i++)
+    {
+        if (str[i] >= '0' && str[i] <= '9')
+            checksum += str[i] - '0';
+        else if (str[i] == '-')
+            checksum += 1;
+    }
     // Get the last digit
     checksum -= (checksum / 10) * 10;
 
@@ -361,4 +482,65 @@ double rad2deg(double angle)
 }
 //------------------------------------------------------------------------------
 
+void putU32(unsigned char *p, unsigned long value)
+{
+    for (int i = 0; i < 4; ++i)
+        p[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+//------------------------------------------------------------------------------
+
+void putU64(unsigned char *p, unsigned long long value)
+{
+    for (int i = 0; i < 8; ++i)
+        p[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+//------------------------------------------------------------------------------
+
+void putDouble(unsigned char *p, double value)
+{
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putU64(p, bits);
+}
+//------------------------------------------------------------------------------
+
+unsigned long getU32(const unsigned char *p)
+{
+    unsigned long value = 0;
+    for (int i = 0; i < 4; ++i)
+        value |= static_cast<unsigned long>(p[i]) << (8 * i);
+    return value;
+}
+//------------------------------------------------------------------------------
+
+unsigned long long getU64(const unsigned char *p)
+{
+    unsigned long long value = 0;
+    for (int i = 0; i < 8; ++i)
+        value |= static_cast<unsigned long long>(p[i]) << (8 * i);
+    return value;
+}
+//------------------------------------------------------------------------------
+
+double getDouble(const unsigned char *p)
+{
+    unsigned long long bits = getU64(p);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+//------------------------------------------------------------------------------
+
+unsigned long fnv1a(const unsigned char *data, std::size_t size,
+                    unsigned long hash)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash = (hash * 16777619UL) & 0xffffffffUL;
+    }
+    return hash;
+}
+//------------------------------------------------------------------------------
+
 }  // namespace quicktle
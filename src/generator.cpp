@@ -0,0 +1,533 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file generator.cpp
+    \brief File contains the realization of methods
+           of quicktle::Generator class.
+*/
+
+#define SECS_IN_DAY 86400
+#define GM 3.986004418e14
+#define EARTH_RADIUS 6378137.0
+#define UNIX_FIRST_YEAR 1970
+#define NAME_LENGTH 24           //!< Length of the satellite name line
+#define LINE_LENGTH 69           //!< Length of TLE line without end of line
+#define RECORD_LENGTH 256        //!< Upper bound of the record length
+#define BUFFER_SIZE (1 << 20)    //!< Size of the output buffer
+#define MAX_SATELLITE_NUMBER 99999
+#define DEFAULT_START_EPOCH 1577836800.0 // Jan 1, 2020
+
+#include <cmath>
+#include <fstream>
+#include <vector>
+#include <quicktle/generator.h>
+
+namespace quicktle
+{
+
+namespace
+{
+    //! Hash function (splitmix64 finalizer)
+    unsigned long long mix(unsigned long long value)
+    {
+        value += 0x9e3779b97f4a7c15ULL;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    //! Uniformly distributed value in [0, 1), determined by the keys
+    double uniform(unsigned long long seed, unsigned long long key1,
+                   unsigned long long key2)
+    {
+        const unsigned long long value = mix(mix(mix(seed) ^ key1) ^ key2);
+        return (value >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    //! Mean motion [revs per day] of the orbit with the given semi-major axis
+    double meanMotion(double a)
+    {
+        return sqrt(GM / (a * a * a)) * SECS_IN_DAY / 2 / M_PI;
+    }
+
+    double normalizeDegrees(double angle)
+    {
+        angle = fmod(angle, 360.);
+        return angle < 0 ? angle + 360. : angle;
+    }
+
+    //! Put the unsigned value, right aligned in the field
+    void putUnsigned(char *&pos, unsigned long long value, int width,
+                     char fill)
+    {
+        for (int i = width - 1; i >= 0; --i)
+        {
+            pos[i] = (i == width - 1 || value) ? '0' + value % 10 : fill;
+            value /= 10;
+        }
+        pos += width;
+    }
+
+    //! Put the value in "%<width>.<precision>f" format
+    void putFixed(char *&pos, double value, int width, int precision,
+                  long long modulo = 0)
+    {
+        long long scale = 1;
+        for (int i = 0; i < precision; ++i)
+            scale *= 10;
+
+        long long scaled = llround(value * scale);
+        if (modulo && scaled >= modulo * scale)
+            scaled -= modulo * scale;
+
+        putUnsigned(pos, scaled / scale, width - precision - 1, ' ');
+        *pos++ = '.';
+        putUnsigned(pos, scaled % scale, precision, '0');
+    }
+
+    //! Put the value in TLE exponential format: " 12345-3"
+    void putExponential(char *&pos, double value)
+    {
+        long long mantissa = 0;
+        int exponent = 0;
+        if (value != 0)
+        {
+            exponent = static_cast<int>(floor(log10(fabs(value)))) + 1;
+            mantissa = llround(fabs(value) * pow(10., 5 - exponent));
+            if (mantissa >= 100000)
+            {
+                mantissa /= 10;
+                ++exponent;
+            }
+            if (exponent < -9 || !mantissa)
+            {
+                mantissa = 0;
+                exponent = 0;
+            }
+        }
+
+        *pos++ = value < 0 && mantissa ? '-' : ' ';
+        putUnsigned(pos, mantissa, 5, '0');
+        *pos++ = exponent > 0 ? '+' : '-';
+        *pos++ = '0' + (exponent < 0 ? -exponent : exponent);
+    }
+
+    //! Put the epoch in YYDDD.DDDDDDDD format
+    void putEpoch(char *&pos, double epoch)
+    {
+        int year = UNIX_FIRST_YEAR;
+        double yearStart = 0;
+        int yearDays = 365;
+        while (true)
+        {
+            const bool leap = !(year % 4) && ((year % 100) || !(year % 400));
+            yearDays = leap ? 366 : 365;
+            if (epoch < yearStart + yearDays * SECS_IN_DAY)
+                break;
+            yearStart += yearDays * SECS_IN_DAY;
+            ++year;
+        }
+
+        long long units = llround((epoch - yearStart) / SECS_IN_DAY * 1e8);
+        long long day = units / 100000000 + 1;
+        long long fraction = units % 100000000;
+        if (day > yearDays)
+        {
+            day = yearDays;
+            fraction = 99999999;
+        }
+
+        putUnsigned(pos, year % 100, 2, '0');
+        putUnsigned(pos, day, 3, '0');
+        *pos++ = '.';
+        putUnsigned(pos, fraction, 8, '0');
+    }
+
+    //! Put the checksum of the line, started at \a start
+    void putChecksum(char *&pos, const char *start)
+    {
+        int sum = 0;
+        for (const char *c = start; c < pos; ++c)
+        {
+            if (*c >= '0' && *c <= '9')
+                sum += *c - '0';
+            else if (*c == '-')
+                ++sum;
+        }
+        *pos++ = '0' + sum % 10;
+    }
+}
+
+//! Elements of the satellite orbit at the start epoch
+struct Generator::Orbit
+{
+    OrbitClass orbitClass;
+    int number;
+    double n;       // revs per day
+    double dn;      // half of the first derivative [revs per day^2]
+    double bstar;
+    double i;       // degrees
+    double Omega;   // degrees
+    double omega;   // degrees
+    double M;       // degrees
+    double e;
+    int launchYear;
+    int launchNumber;
+    int piece;
+    int elementNumber;
+    double revolutionNumber;
+};
+//------------------------------------------------------------------------------
+
+Generator::Generator(unsigned long long seed)
+    : m_seed(seed),
+      m_satellitesCount(1),
+      m_epochsCount(1),
+      m_firstSatelliteNumber(1),
+      m_startEpoch(DEFAULT_START_EPOCH),
+      m_epochStep(SECS_IN_DAY),
+      m_fileType(TwoLines)
+{
+    setOrbitMix(0.7, 0.08, 0.15, 0.07);
+}
+//------------------------------------------------------------------------------
+
+void Generator::setSeed(unsigned long long seed)
+{
+    m_seed = seed;
+}
+//------------------------------------------------------------------------------
+
+void Generator::setSatellitesCount(std::size_t count)
+{
+    m_satellitesCount = count;
+}
+//------------------------------------------------------------------------------
+
+std::size_t Generator::satellitesCount() const
+{
+    return m_satellitesCount;
+}
+//------------------------------------------------------------------------------
+
+void Generator::setEpochsCount(std::size_t count)
+{
+    m_epochsCount = count;
+}
+//------------------------------------------------------------------------------
+
+std::size_t Generator::epochsCount() const
+{
+    return m_epochsCount;
+}
+//------------------------------------------------------------------------------
+
+void Generator::setFirstSatelliteNumber(int number)
+{
+    m_firstSatelliteNumber = number;
+}
+//------------------------------------------------------------------------------
+
+void Generator::setStartEpoch(double epoch)
+{
+    m_startEpoch = epoch;
+}
+//------------------------------------------------------------------------------
+
+void Generator::setEpochStep(double step)
+{
+    m_epochStep = step;
+}
+//------------------------------------------------------------------------------
+
+void Generator::setFileType(FileType fileType)
+{
+    m_fileType = fileType;
+}
+//------------------------------------------------------------------------------
+
+void Generator::setOrbitMix(double leo, double meo, double geo, double heo)
+{
+    double sum = leo + meo + geo + heo;
+    if (sum <= 0)
+    {
+        leo = sum = 1;
+        meo = geo = heo = 0;
+    }
+
+    m_mix[LEO] = leo / sum;
+    m_mix[MEO] = meo / sum;
+    m_mix[GEO] = geo / sum;
+    m_mix[HEO] = heo / sum;
+}
+//------------------------------------------------------------------------------
+
+Generator::OrbitClass Generator::orbitClass(std::size_t satellite) const
+{
+    double value = uniform(m_seed, satellite, 0);
+    for (int i = 0; i < OrbitClassesCount - 1; ++i)
+    {
+        if (value < m_mix[i])
+            return static_cast<OrbitClass>(i);
+        value -= m_mix[i];
+    }
+
+    return static_cast<OrbitClass>(OrbitClassesCount - 1);
+}
+//------------------------------------------------------------------------------
+
+Generator::Orbit Generator::orbit(std::size_t satellite) const
+{
+    std::size_t key = 1;
+    Orbit res;
+    res.orbitClass = orbitClass(satellite);
+    res.number = 1 + (m_firstSatelliteNumber - 1 + satellite)
+                     % MAX_SATELLITE_NUMBER;
+    res.Omega = 360 * uniform(m_seed, satellite, key++);
+    res.omega = 360 * uniform(m_seed, satellite, key++);
+    res.M = 360 * uniform(m_seed, satellite, key++);
+
+    const double u1 = uniform(m_seed, satellite, key++);
+    const double u2 = uniform(m_seed, satellite, key++);
+    const double u3 = uniform(m_seed, satellite, key++);
+    switch (res.orbitClass)
+    {
+    case LEO:
+    {
+        const double altitude = 300e3 + 1700e3 * u1 * u1;
+        res.n = meanMotion(EARTH_RADIUS + altitude);
+        res.e = 0.02 * u2 * u2 * u2;
+        // Typical inclinations: ISS, Starlink, sun-synchronous, polar
+        static const double inclinations[] = {51.6, 53.0, 97.6, 86.4, 65.0};
+        res.i = (u3 < 0.75) ? inclinations[static_cast<int>(u3 / 0.15)]
+                              + 0.5 * (uniform(m_seed, satellite, key) - 0.5)
+                            : 100 * uniform(m_seed, satellite, key);
+        ++key;
+        res.bstar = 1e-5 + 1e-3 * u1 * uniform(m_seed, satellite, key++);
+        res.dn = (u1 < 0.1 ? 1e-3 : 1e-5) * (u2 - 0.3);
+        break;
+    }
+    case MEO:
+        res.n = meanMotion(26560e3 + 3000e3 * u1);
+        res.e = 0.02 * u2;
+        res.i = 55 + 10 * u3;
+        res.bstar = 0;
+        res.dn = 1e-7 * (u2 - 0.5);
+        break;
+    case GEO:
+        res.n = 1.0027 + 0.001 * (u1 - 0.5);
+        res.e = 0.001 * u2;
+        res.i = 15 * u3 * u3;
+        res.bstar = 0;
+        res.dn = 1e-7 * (u2 - 0.5);
+        break;
+    default:
+        if (u3 < 0.5)
+        {
+            // Molniya
+            res.n = 2.006 + 0.002 * (u1 - 0.5);
+            res.e = 0.65 + 0.1 * u2;
+            res.i = 63.4 + (u3 - 0.25);
+        }
+        else
+        {
+            // Geostationary transfer orbit
+            res.n = 2.2 + 0.1 * u1;
+            res.e = 0.71 + 0.03 * u2;
+            res.i = 7 + 21 * (u3 - 0.5);
+        }
+        res.bstar = 1e-4 * u1;
+        res.dn = 1e-6 * (u2 - 0.5);
+        break;
+    }
+
+    res.launchYear = 1958 + static_cast<int>(60 * uniform(m_seed, satellite,
+                                                          key++));
+    res.launchNumber = 1 + static_cast<int>(150 * uniform(m_seed, satellite,
+                                                          key++));
+    res.piece = static_cast<int>(26 * uniform(m_seed, satellite, key++));
+    res.elementNumber = static_cast<int>(999 * uniform(m_seed, satellite,
+                                                       key++));
+    res.revolutionNumber = 10000 * uniform(m_seed, satellite, key++);
+
+    return res;
+}
+//------------------------------------------------------------------------------
+
+std::size_t Generator::format(const Orbit &orbit, std::size_t satellite,
+                              std::size_t epoch, char *buffer) const
+{
+    // Epochs of one satellite are shifted within +-10% of the step
+    const double dt = epoch * m_epochStep + 0.2 * m_epochStep
+                      * (uniform(m_seed, satellite, epoch + (1ULL << 40)) - 0.5);
+    const double days = dt / SECS_IN_DAY;
+    const double revolutions = orbit.n * days;
+
+    char *pos = buffer;
+    if (m_fileType == ThreeLines)
+    {
+        const char *start = pos;
+        const char prefix[] = "SAT-";
+        for (const char *c = prefix; *c; ++c)
+            *pos++ = *c;
+        putUnsigned(pos, orbit.number, 5, '0');
+        while (pos - start < NAME_LENGTH)
+            *pos++ = ' ';
+        *pos++ = '\n';
+    }
+
+    // Line 1
+    const char *line = pos;
+    *pos++ = '1';
+    *pos++ = ' ';
+    putUnsigned(pos, orbit.number, 5, '0');
+    *pos++ = 'U';
+    *pos++ = ' ';
+    putUnsigned(pos, orbit.launchYear % 100, 2, '0');
+    putUnsigned(pos, orbit.launchNumber, 3, '0');
+    *pos++ = 'A' + orbit.piece;
+    *pos++ = ' ';
+    *pos++ = ' ';
+    *pos++ = ' ';
+    putEpoch(pos, m_startEpoch + dt);
+    *pos++ = ' ';
+    *pos++ = orbit.dn < 0 ? '-' : ' ';
+    *pos++ = '.';
+    putUnsigned(pos, llround(fabs(orbit.dn) * 1e8) % 100000000, 8, '0');
+    *pos++ = ' ';
+    putExponential(pos, 0);
+    *pos++ = ' ';
+    putExponential(pos, orbit.bstar);
+    *pos++ = ' ';
+    *pos++ = '0';
+    *pos++ = ' ';
+    putUnsigned(pos, (orbit.elementNumber + epoch) % 10000, 4, ' ');
+    putChecksum(pos, line);
+    *pos++ = '\n';
+
+    // Line 2
+    line = pos;
+    *pos++ = '2';
+    *pos++ = ' ';
+    putUnsigned(pos, orbit.number, 5, '0');
+    *pos++ = ' ';
+    putFixed(pos, orbit.i, 8, 4);
+    *pos++ = ' ';
+    putFixed(pos, normalizeDegrees(orbit.Omega - 0.1 * days), 8, 4, 360);
+    *pos++ = ' ';
+    putUnsigned(pos, llround(orbit.e * 1e7), 7, '0');
+    *pos++ = ' ';
+    putFixed(pos, normalizeDegrees(orbit.omega + 0.05 * days), 8, 4, 360);
+    *pos++ = ' ';
+    putFixed(pos, normalizeDegrees(orbit.M + 360 * revolutions), 8, 4, 360);
+    *pos++ = ' ';
+    putFixed(pos, orbit.n, 11, 8);
+    putUnsigned(pos,
+                static_cast<long long>(orbit.revolutionNumber + revolutions)
+                % 100000, 5, ' ');
+    putChecksum(pos, line);
+    *pos++ = '\n';
+
+    return pos - buffer;
+}
+//------------------------------------------------------------------------------
+
+void Generator::record(std::size_t satellite, std::size_t epoch,
+                       std::string &line1, std::string &line2,
+                       std::string &line3) const
+{
+    char buffer[RECORD_LENGTH];
+    format(orbit(satellite), satellite, epoch, buffer);
+
+    const char *pos = buffer;
+    if (m_fileType == ThreeLines)
+    {
+        line1.assign(pos, NAME_LENGTH);
+        pos += NAME_LENGTH + 1;
+    }
+    else
+    {
+        line1.clear();
+    }
+
+    line2.assign(pos, LINE_LENGTH);
+    line3.assign(pos + LINE_LENGTH + 1, LINE_LENGTH);
+}
+//------------------------------------------------------------------------------
+
+Node Generator::node(std::size_t satellite, std::size_t epoch) const
+{
+    std::string line1;
+    std::string line2;
+    std::string line3;
+    record(satellite, epoch, line1, line2, line3);
+
+    return (m_fileType == ThreeLines) ? Node(line1, line2, line3)
+                                      : Node(line2, line3);
+}
+//------------------------------------------------------------------------------
+
+std::size_t Generator::write(std::ostream &stream) const
+{
+    std::vector<Orbit> orbits;
+    orbits.reserve(m_satellitesCount);
+    for (std::size_t satellite = 0; satellite < m_satellitesCount; ++satellite)
+        orbits.push_back(orbit(satellite));
+
+    std::vector<char> buffer(BUFFER_SIZE);
+    std::size_t used = 0;
+    std::size_t count = 0;
+    for (std::size_t epoch = 0; epoch < m_epochsCount; ++epoch)
+    {
+        for (std::size_t satellite = 0; satellite < m_satellitesCount;
+             ++satellite)
+        {
+            if (buffer.size() - used < RECORD_LENGTH)
+            {
+                if (!stream.write(&buffer[0], used))
+                    return count;
+                used = 0;
+            }
+
+            used += format(orbits[satellite], satellite, epoch,
+                           &buffer[used]);
+            ++count;
+        }
+    }
+
+    stream.write(&buffer[0], used);
+    return count;
+}
+//------------------------------------------------------------------------------
+
+bool Generator::write(const std::string &fileName) const
+{
+    std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+    if (!file)
+        return false;
+
+    write(file);
+    file.close();
+
+    return !file.fail();
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
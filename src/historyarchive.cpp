@@ -0,0 +1,517 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file historyarchive.cpp
+    \brief File contains the realization of methods
+           of quicktle::HistoryWriter and quicktle::HistoryReader classes.
+*/
+
+#define HISTORY_VERSION 1
+#define HEADER_SIZE 16
+#define BLOCK_HEADER_SIZE 8
+#define SATELLITE_SIZE 16
+#define BLOCK_SIZE 28
+#define FOOTER_SIZE 24
+#define NUMBER_LENGTH 8          //!< Max length of satellite number
+#define DEFAULT_BLOCK_SIZE 1024  //!< Default number of records in block
+
+#include <algorithm>
+#include <cstring>
+#include <quicktle/func.h>
+#include <quicktle/historyarchive.h>
+#include <quicktle/trace.h>
+
+namespace quicktle
+{
+
+namespace
+{
+    const char MAGIC[8] = {'Q', 'T', 'L', 'E', 'H', 'I', 'S', 'T'};
+
+    // Offsets of the header fields
+    enum
+    {
+        Header_Version = 8
+    };
+
+    // Offsets of the block header fields
+    enum
+    {
+        BlockHeader_Size = 0,
+        BlockHeader_Checksum = 4
+    };
+
+    // Offsets of the satellite fields in the directory
+    enum
+    {
+        Satellite_Number = 0,
+        Satellite_BlocksCount = 8,
+        Satellite_RecordsCount = 12
+    };
+
+    // Offsets of the block fields in the directory
+    enum
+    {
+        Block_Offset = 0,
+        Block_RecordsCount = 8,
+        Block_FirstEpoch = 12,
+        Block_LastEpoch = 20
+    };
+
+    // Offsets of the footer fields
+    enum
+    {
+        Footer_DirectoryOffset = 0,
+        Footer_SatellitesCount = 8,
+        Footer_DirectoryChecksum = 16,
+        Footer_FooterChecksum = 20
+    };
+}
+
+HistoryWriter::HistoryWriter()
+    : m_blockSize(DEFAULT_BLOCK_SIZE),
+      m_offset(0),
+      m_recordsCount(0),
+      m_ok(false)
+{
+}
+//------------------------------------------------------------------------------
+
+HistoryWriter::~HistoryWriter()
+{
+    close();
+}
+//------------------------------------------------------------------------------
+
+bool HistoryWriter::open(const std::string &fileName)
+{
+    close();
+    m_file.open(fileName.c_str(),
+                std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file)
+        return false;
+
+    unsigned char header[HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    putU32(header + Header_Version, HISTORY_VERSION);
+    m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    m_offset = HEADER_SIZE;
+    m_recordsCount = 0;
+    m_ok = static_cast<bool>(m_file);
+    return m_ok;
+}
+//------------------------------------------------------------------------------
+
+void HistoryWriter::setBlockSize(std::size_t size)
+{
+    m_blockSize = size ? size : 1;
+}
+//------------------------------------------------------------------------------
+
+bool HistoryWriter::append(const Node &node)
+{
+    if (!m_file.is_open() || !m_ok)
+        return false;
+
+    const std::string number = node.satelliteNumber();
+    if (number.empty() || number.length() >= NUMBER_LENGTH)
+        return false;
+
+    if (m_satellites.empty() || m_satellites.back().number != number)
+    {
+        // The records of the satellite have been already written
+        if (m_numbers.count(number))
+            return false;
+        if (!flush())
+            return false;
+
+        m_numbers.insert(number);
+        m_satellites.push_back(Satellite());
+        m_satellites.back().number = number;
+        m_satellites.back().recordsCount = 0;
+    }
+    else
+    {
+        // The epochs must not decrease
+        const std::vector<Block> &blocks = m_satellites.back().blocks;
+        const double last = m_nodes.empty() ? blocks.back().lastEpoch
+                                            : m_nodes.back().preciseEpoch();
+        if (node.preciseEpoch() < last)
+            return false;
+    }
+
+    m_nodes.push_back(node);
+    ++m_satellites.back().recordsCount;
+    ++m_recordsCount;
+
+    return m_nodes.size() < m_blockSize || flush();
+}
+//------------------------------------------------------------------------------
+
+bool HistoryWriter::close()
+{
+    if (!m_file.is_open())
+        return false;
+
+    bool ok = flush();
+
+    // Directory
+    std::vector<unsigned char> directory;
+    for (std::size_t i = 0; i < m_satellites.size(); ++i)
+    {
+        const Satellite &satellite = m_satellites[i];
+        std::size_t position = directory.size();
+        directory.resize(position + SATELLITE_SIZE +
+                         satellite.blocks.size() * BLOCK_SIZE);
+        unsigned char *p = &directory[position];
+        memcpy(p + Satellite_Number, satellite.number.c_str(),
+               satellite.number.length());
+        putU32(p + Satellite_BlocksCount, satellite.blocks.size());
+        putU32(p + Satellite_RecordsCount, satellite.recordsCount);
+
+        for (std::size_t j = 0; j < satellite.blocks.size(); ++j)
+        {
+            const Block &block = satellite.blocks[j];
+            p = &directory[position + SATELLITE_SIZE + j * BLOCK_SIZE];
+            putU64(p + Block_Offset, block.offset);
+            putU32(p + Block_RecordsCount, block.recordsCount);
+            putDouble(p + Block_FirstEpoch, block.firstEpoch);
+            putDouble(p + Block_LastEpoch, block.lastEpoch);
+        }
+    }
+
+    unsigned char footer[FOOTER_SIZE];
+    putU64(footer + Footer_DirectoryOffset, m_offset);
+    putU64(footer + Footer_SatellitesCount, m_satellites.size());
+    putU32(footer + Footer_DirectoryChecksum,
+           fnv1a(directory.empty() ? 0 : &directory[0], directory.size()));
+    putU32(footer + Footer_FooterChecksum,
+           fnv1a(footer, Footer_FooterChecksum));
+
+    if (!directory.empty())
+        m_file.write(reinterpret_cast<const char*>(&directory[0]),
+                     directory.size());
+    m_file.write(reinterpret_cast<const char*>(footer), sizeof(footer));
+    ok = m_file.flush() && ok && m_ok;
+    m_file.close();
+
+    m_nodes.clear();
+    m_satellites.clear();
+    m_numbers.clear();
+    m_ok = false;
+    return ok;
+}
+//------------------------------------------------------------------------------
+
+std::size_t HistoryWriter::recordsCount() const
+{
+    return m_recordsCount;
+}
+//------------------------------------------------------------------------------
+
+bool HistoryWriter::flush()
+{
+    if (m_nodes.empty())
+        return m_ok;
+
+    TraceSpan span("HistoryWriter::flush");
+
+    m_buffer.assign(BLOCK_HEADER_SIZE, 0);
+    HistoryBlock::encode(&m_nodes[0], m_nodes.size(), m_buffer);
+    const std::size_t size = m_buffer.size() - BLOCK_HEADER_SIZE;
+    putU32(&m_buffer[BlockHeader_Size], size);
+    putU32(&m_buffer[BlockHeader_Checksum],
+           fnv1a(&m_buffer[BLOCK_HEADER_SIZE], size));
+    m_file.write(reinterpret_cast<const char*>(&m_buffer[0]),
+                 m_buffer.size());
+
+    Block block;
+    block.offset = m_offset;
+    block.recordsCount = m_nodes.size();
+    block.firstEpoch = m_nodes.front().preciseEpoch();
+    block.lastEpoch = m_nodes.back().preciseEpoch();
+    m_satellites.back().blocks.push_back(block);
+
+    m_offset += m_buffer.size();
+    m_nodes.clear();
+    m_ok = m_ok && static_cast<bool>(m_file);
+    return m_ok;
+}
+//------------------------------------------------------------------------------
+
+HistoryReader::HistoryReader()
+    : m_blocksEnd(0)
+{
+}
+//------------------------------------------------------------------------------
+
+bool HistoryReader::open(const std::string &fileName)
+{
+    TraceSpan span("HistoryReader::open");
+
+    close();
+    m_file.open(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!m_file)
+        return false;
+
+    if (!readDirectory())
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+
+void HistoryReader::close()
+{
+    if (m_file.is_open())
+        m_file.close();
+    m_file.clear();
+    m_satellites.clear();
+    m_numbers.clear();
+    m_blocks.clear();
+    m_blocksEnd = 0;
+}
+//------------------------------------------------------------------------------
+
+bool HistoryReader::isOpen() const
+{
+    return m_file.is_open();
+}
+//------------------------------------------------------------------------------
+
+std::size_t HistoryReader::satellitesCount() const
+{
+    return m_satellites.size();
+}
+//------------------------------------------------------------------------------
+
+std::size_t HistoryReader::find(const std::string &satelliteNumber) const
+{
+    std::map<std::string, std::size_t>::const_iterator it =
+                                            m_numbers.find(satelliteNumber);
+    return (it != m_numbers.end()) ? it->second : m_satellites.size();
+}
+//------------------------------------------------------------------------------
+
+const std::string& HistoryReader::satelliteNumber(std::size_t satellite) const
+{
+    return m_satellites.at(satellite).number;
+}
+//------------------------------------------------------------------------------
+
+std::size_t HistoryReader::recordsCount(std::size_t satellite) const
+{
+    return m_satellites.at(satellite).recordsCount;
+}
+//------------------------------------------------------------------------------
+
+bool HistoryReader::read(std::size_t satellite, double t1, double t2,
+                         const Sink &sink)
+{
+    TraceSpan span("HistoryReader::read");
+
+    if (satellite >= m_satellites.size())
+        return false;
+
+    const Satellite &sat = m_satellites[satellite];
+    std::vector<Node> nodes;
+    for (std::size_t i = 0; i < sat.blocksCount; ++i)
+    {
+        const Block &block = m_blocks[sat.firstBlock + i];
+        if (block.lastEpoch < t1 || block.firstEpoch > t2)
+            continue;
+
+        nodes.clear();
+        if (!readBlock(block) ||
+            !HistoryBlock::decode(&m_buffer[0], m_buffer.size(), nodes))
+        {
+            return false;
+        }
+
+        for (std::size_t j = 0; j < nodes.size(); ++j)
+        {
+            const double t = nodes[j].preciseEpoch();
+            if (t >= t1 && t <= t2)
+                sink(nodes[j]);
+        }
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+
+bool HistoryReader::read(std::size_t satellite, DataSet &dataSet)
+{
+    if (satellite >= m_satellites.size())
+        return false;
+
+    const Satellite &sat = m_satellites[satellite];
+    if (!sat.blocksCount)
+        return true;
+
+    return read(satellite, m_blocks[sat.firstBlock].firstEpoch,
+                m_blocks[sat.firstBlock + sat.blocksCount - 1].lastEpoch,
+                [&dataSet](const Node &node) { dataSet.append(node); });
+}
+//------------------------------------------------------------------------------
+
+bool HistoryReader::read(std::size_t satellite,
+                         HistoryBlock::Columns &columns)
+{
+    TraceSpan span("HistoryReader::read");
+
+    if (satellite >= m_satellites.size())
+        return false;
+
+    const Satellite &sat = m_satellites[satellite];
+    for (std::size_t i = 0; i < sat.blocksCount; ++i)
+    {
+        if (!readBlock(m_blocks[sat.firstBlock + i]) ||
+            !HistoryBlock::decode(&m_buffer[0], m_buffer.size(), columns))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+
+bool HistoryReader::readDirectory()
+{
+    unsigned char header[HEADER_SIZE];
+    if (!m_file.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        memcmp(header, MAGIC, sizeof(MAGIC)) ||
+        getU32(header + Header_Version) != HISTORY_VERSION)
+    {
+        return false;
+    }
+
+    m_file.seekg(0, std::ios::end);
+    const unsigned long long size =
+                        static_cast<unsigned long long>(m_file.tellg());
+    if (size < HEADER_SIZE + FOOTER_SIZE)
+        return false;
+
+    unsigned char footer[FOOTER_SIZE];
+    m_file.seekg(static_cast<std::streamoff>(size - FOOTER_SIZE));
+    if (!m_file.read(reinterpret_cast<char*>(footer), sizeof(footer)) ||
+        fnv1a(footer, Footer_FooterChecksum) !=
+                                    getU32(footer + Footer_FooterChecksum))
+    {
+        return false;
+    }
+
+    const unsigned long long offset = getU64(footer + Footer_DirectoryOffset);
+    const unsigned long long count = getU64(footer + Footer_SatellitesCount);
+    if (offset < HEADER_SIZE || offset > size - FOOTER_SIZE)
+        return false;
+
+    std::vector<unsigned char> directory(
+                    static_cast<std::size_t>(size - FOOTER_SIZE - offset));
+    m_file.seekg(static_cast<std::streamoff>(offset));
+    if (!directory.empty() &&
+        !m_file.read(reinterpret_cast<char*>(&directory[0]),
+                     directory.size()))
+    {
+        return false;
+    }
+    if (fnv1a(directory.empty() ? 0 : &directory[0], directory.size()) !=
+                                    getU32(footer + Footer_DirectoryChecksum))
+    {
+        return false;
+    }
+
+    std::size_t position = 0;
+    for (unsigned long long i = 0; i < count; ++i)
+    {
+        if (position + SATELLITE_SIZE > directory.size())
+            return false;
+
+        const unsigned char *p = &directory[position];
+        Satellite satellite;
+        satellite.number.assign(reinterpret_cast<const char*>(p),
+                                strnlen(reinterpret_cast<const char*>(p),
+                                        NUMBER_LENGTH));
+        satellite.blocksCount = getU32(p + Satellite_BlocksCount);
+        satellite.recordsCount = getU32(p + Satellite_RecordsCount);
+        satellite.firstBlock = m_blocks.size();
+        position += SATELLITE_SIZE;
+
+        const std::size_t rest = directory.size() - position;
+        if (satellite.blocksCount > rest / BLOCK_SIZE)
+            return false;
+
+        for (std::size_t j = 0; j < satellite.blocksCount; ++j)
+        {
+            p = &directory[position];
+            Block block;
+            block.offset = getU64(p + Block_Offset);
+            block.firstEpoch = getDouble(p + Block_FirstEpoch);
+            block.lastEpoch = getDouble(p + Block_LastEpoch);
+            // The header of the block must end before the directory
+            if (block.offset < HEADER_SIZE || block.offset >= offset ||
+                offset - block.offset < BLOCK_HEADER_SIZE)
+            {
+                return false;
+            }
+            m_blocks.push_back(block);
+            position += BLOCK_SIZE;
+        }
+        m_numbers[satellite.number] = m_satellites.size();
+        m_satellites.push_back(satellite);
+    }
+
+    m_blocksEnd = offset;
+    m_file.clear();
+    return position == directory.size();
+}
+//------------------------------------------------------------------------------
+
+bool HistoryReader::readBlock(const Block &block)
+{
+    unsigned char header[BLOCK_HEADER_SIZE];
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(block.offset));
+    if (!m_file.read(reinterpret_cast<char*>(header), sizeof(header)))
+        return false;
+
+    const unsigned long long size = getU32(header + BlockHeader_Size);
+    if (size > m_blocksEnd - block.offset - BLOCK_HEADER_SIZE)
+        return false;
+
+    m_buffer.resize(static_cast<std::size_t>(size));
+    if (m_buffer.empty() ||
+        !m_file.read(reinterpret_cast<char*>(&m_buffer[0]), m_buffer.size()))
+    {
+        return false;
+    }
+
+    return fnv1a(&m_buffer[0], m_buffer.size()) ==
+                                    getU32(header + BlockHeader_Checksum);
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
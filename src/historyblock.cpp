@@ -0,0 +1,511 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file historyblock.cpp
+    \brief File contains the realization of methods
+           of quicktle::HistoryBlock class.
+*/
+
+#define SECS_IN_DAY 86400
+#define UNIX_FIRST_YEAR 1970
+#define MANTISSA_DIGITS 5   //!< Digits of mantissa in exponential fields
+#define MAX_POWER 22        //!< Max exactly representable power of 10
+#define EPOCH_LENGTH 14     //!< Length of epoch in TLE format
+#define YEAR_FACTOR 100000000000LL  //!< Epoch code: year * factor + day
+
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <quicktle/func.h>
+#include <quicktle/historyblock.h>
+#include <quicktle/trace.h>
+
+namespace quicktle
+{
+
+namespace
+{
+    enum Column
+    {
+        Column_Epoch = 0,
+        Column_n,
+        Column_dn,
+        Column_d2nMantissa,
+        Column_d2nExponent,
+        Column_bstarMantissa,
+        Column_bstarExponent,
+        Column_i,
+        Column_Omega,
+        Column_omega,
+        Column_M,
+        Column_e,
+        Column_ElementNumber,
+        Column_RevolutionNumber,
+        Column_Classification,
+        Column_EphemerisType,
+        Column_FileType,
+        Column_SatelliteNumber,
+        Column_Name,
+        Column_Designator,
+        ColumnsCount
+    };
+
+    // Scales of the fixed-point fields of TLE text
+    const double EPOCH_SCALE = 1e8;   // fraction of day
+    const double N_SCALE = 1e8;       // revolutions per day
+    const double DN_SCALE = 1e8;
+    const double ANGLE_SCALE = 1e4;   // degrees
+    const double E_SCALE = 1e7;
+
+    //! Powers of 10, which are exact in double
+    const double POWERS_OF_10[MAX_POWER + 1] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    //! Days from Jan 1, 1970 to Jan 1 of the year
+    long long daysBefore(int year)
+    {
+        const long long last = year - 1;
+        const long long first = UNIX_FIRST_YEAR - 1;
+        return 365 * (year - UNIX_FIRST_YEAR)
+             + (last / 4 - last / 100 + last / 400)
+             - (first / 4 - first / 100 + first / 400);
+    }
+
+    //! Epoch code: the year and the day of year as in TLE text
+    long long encodeEpoch(double epoch)
+    {
+        const long long days =
+            static_cast<long long>(floor(epoch / SECS_IN_DAY));
+        int year = UNIX_FIRST_YEAR + static_cast<int>(days / 365);
+        while (daysBefore(year) > days)
+            --year;
+        while (daysBefore(year + 1) <= days)
+            ++year;
+
+        const double start = static_cast<double>(daysBefore(year))
+                           * SECS_IN_DAY;
+        const double day = (epoch - start) / SECS_IN_DAY + 1;
+        return year * YEAR_FACTOR + llround(day * EPOCH_SCALE);
+    }
+
+    //! Parse the epoch the same way as Node does
+    double decodeEpoch(long long code)
+    {
+        const long long day = code % YEAR_FACTOR;
+        char text[32];
+        snprintf(text, sizeof(text), "%02d%03lld.%08lld",
+                 static_cast<int>(code / YEAR_FACTOR % 100),
+                 day / static_cast<long long>(EPOCH_SCALE),
+                 day % static_cast<long long>(EPOCH_SCALE));
+
+        Node::ErrorCode error = Node::NoError;
+        return parseRawDate(text, EPOCH_LENGTH, error);
+    }
+
+    //! Split the value into the mantissa and exponent of TLE text
+    void encodeExponential(double value, long long &mantissa,
+                           long long &exponent)
+    {
+        mantissa = 0;
+        exponent = 0;
+        if (value == 0 || !std::isfinite(value))
+            return;
+
+        int power = static_cast<int>(floor(log10(fabs(value)))) + 1;
+        for (int attempt = 0; attempt < 2; ++attempt)
+        {
+            const int shift = MANTISSA_DIGITS - power;
+            if (shift > MAX_POWER || -shift > MAX_POWER)
+                return;
+            mantissa = llround(shift >= 0 ? value * POWERS_OF_10[shift]
+                                          : value / POWERS_OF_10[-shift]);
+            if (llabs(mantissa) < POWERS_OF_10[MANTISSA_DIGITS])
+                break;
+            ++power;
+        }
+        exponent = power;
+    }
+
+    //! Value of "0.mmmmm e<exponent>", equal to the parsed one
+    double decodeExponential(long long mantissa, long long exponent)
+    {
+        const long long shift = MANTISSA_DIGITS - exponent;
+        if (shift > MAX_POWER || -shift > MAX_POWER)
+            return 0;
+        return shift >= 0 ? mantissa / POWERS_OF_10[shift]
+                          : mantissa * POWERS_OF_10[-shift];
+    }
+
+    long long stringIndex(const std::string &str,
+                          std::vector<std::string> &strings,
+                          std::map<std::string, long long> &indices)
+    {
+        std::map<std::string, long long>::const_iterator it =
+                                                        indices.find(str);
+        if (it != indices.end())
+            return it->second;
+
+        indices[str] = strings.size();
+        strings.push_back(str);
+        return strings.size() - 1;
+    }
+
+    void putVarint(std::vector<unsigned char> &data, unsigned long long value)
+    {
+        while (value >= 0x80)
+        {
+            data.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<unsigned char>(value));
+    }
+
+    bool getVarint(const unsigned char *&p, const unsigned char *end,
+                   unsigned long long &value)
+    {
+        value = 0;
+        for (int shift = 0; p < end && shift < 64; shift += 7)
+        {
+            const unsigned char byte = *p++;
+            value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    unsigned long long zigzag(long long value)
+    {
+        return (static_cast<unsigned long long>(value) << 1) ^
+               static_cast<unsigned long long>(value >> 63);
+    }
+
+    long long unzigzag(unsigned long long value)
+    {
+        return static_cast<long long>(value >> 1) ^
+               -static_cast<long long>(value & 1);
+    }
+
+    //! Column values of the node
+    void encodeNode(const Node &node, long long *values,
+                    std::vector<std::string> &strings,
+                    std::map<std::string, long long> &indices)
+    {
+        values[Column_Epoch] = encodeEpoch(node.preciseEpoch());
+        values[Column_n] = llround(node.n() * SECS_IN_DAY / 2 / M_PI
+                                   * N_SCALE);
+        values[Column_dn] = llround(node.dn() / 2. * SECS_IN_DAY
+                                    * SECS_IN_DAY / 2 / M_PI * DN_SCALE);
+        encodeExponential(node.d2n() / 6. * SECS_IN_DAY * SECS_IN_DAY
+                          * SECS_IN_DAY / 2 / M_PI,
+                          values[Column_d2nMantissa],
+                          values[Column_d2nExponent]);
+        encodeExponential(node.bstar(), values[Column_bstarMantissa],
+                          values[Column_bstarExponent]);
+        values[Column_i] = llround(rad2deg(node.i()) * ANGLE_SCALE);
+        values[Column_Omega] = llround(rad2deg(node.Omega()) * ANGLE_SCALE);
+        values[Column_omega] = llround(rad2deg(node.omega()) * ANGLE_SCALE);
+        values[Column_M] = llround(rad2deg(node.M()) * ANGLE_SCALE);
+        values[Column_e] = llround(node.e() * E_SCALE);
+        values[Column_ElementNumber] = node.elementNumber();
+        values[Column_RevolutionNumber] = node.revolutionNumber();
+        values[Column_Classification] =
+                        static_cast<unsigned char>(node.classification());
+        values[Column_EphemerisType] =
+                        static_cast<unsigned char>(node.ephemerisType());
+        values[Column_FileType] = node.outputFormat();
+        values[Column_SatelliteNumber] =
+                        stringIndex(node.satelliteNumber(), strings, indices);
+        values[Column_Name] =
+                        stringIndex(node.satelliteName(), strings, indices);
+        values[Column_Designator] =
+                        stringIndex(node.designator(), strings, indices);
+    }
+
+    //! Elements, computed the same way as Node does
+    double n(const long long *values)
+    {
+        return values[Column_n] / N_SCALE * 2 * M_PI / SECS_IN_DAY;
+    }
+
+    double dn(const long long *values)
+    {
+        return 2 * (values[Column_dn] / DN_SCALE)
+                                        * 2 * M_PI / SECS_IN_DAY / SECS_IN_DAY;
+    }
+
+    double d2n(const long long *values)
+    {
+        return 6 * decodeExponential(values[Column_d2nMantissa],
+                                     values[Column_d2nExponent])
+                    * 2 * M_PI / SECS_IN_DAY / SECS_IN_DAY / SECS_IN_DAY;
+    }
+
+    double bstar(const long long *values)
+    {
+        return decodeExponential(values[Column_bstarMantissa],
+                                 values[Column_bstarExponent]);
+    }
+
+    double angle(const long long *values, Column column)
+    {
+        return deg2rad(values[column] / ANGLE_SCALE);
+    }
+
+    double e(const long long *values)
+    {
+        return values[Column_e] / E_SCALE;
+    }
+
+    //! Decode the strings and the columns of the block
+    bool decodeValues(const unsigned char *data, std::size_t size,
+                      std::vector<long long> &values,
+                      std::vector<std::string> &strings)
+    {
+        const unsigned char *p = data;
+        const unsigned char *end = data + size;
+        unsigned long long count = 0;
+        unsigned long long stringsCount = 0;
+        if (!getVarint(p, end, count) || !getVarint(p, end, stringsCount) ||
+            count > size || stringsCount > size)
+        {
+            return false;
+        }
+
+        strings.resize(static_cast<std::size_t>(stringsCount));
+        for (std::size_t i = 0; i < strings.size(); ++i)
+        {
+            unsigned long long length = 0;
+            if (!getVarint(p, end, length) ||
+                length > static_cast<unsigned long long>(end - p))
+            {
+                return false;
+            }
+            strings[i].assign(reinterpret_cast<const char*>(p),
+                              static_cast<std::size_t>(length));
+            p += length;
+        }
+
+        values.resize(static_cast<std::size_t>(count) * ColumnsCount);
+        for (std::size_t column = 0; column < ColumnsCount; ++column)
+        {
+            long long previous = 0;
+            std::size_t k = 0;
+            while (k < count)
+            {
+                unsigned long long token = 0;
+                if (!getVarint(p, end, token))
+                    return false;
+
+                unsigned long long repeat = 1;
+                if (!token)
+                {
+                    // Run of equal values
+                    if (!getVarint(p, end, repeat) || repeat >= count - k)
+                        return false;
+                    ++repeat;
+                }
+                else
+                {
+                    previous += unzigzag(token);
+                }
+
+                for (; repeat; --repeat, ++k)
+                    values[k * ColumnsCount + column] = previous;
+            }
+        }
+
+        // Indices of strings
+        const long long limit = static_cast<long long>(stringsCount);
+        const Column stringColumns[] =
+        {
+            Column_SatelliteNumber, Column_Name, Column_Designator
+        };
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                const long long index =
+                            values[k * ColumnsCount + stringColumns[j]];
+                if (index < 0 || index >= limit)
+                    return false;
+            }
+        }
+
+        return p == end;
+    }
+}
+
+void HistoryBlock::Columns::clear()
+{
+    epoch.clear();
+    n.clear();
+    dn.clear();
+    d2n.clear();
+    i.clear();
+    Omega.clear();
+    omega.clear();
+    M.clear();
+    e.clear();
+    bstar.clear();
+    elementNumber.clear();
+    revolutionNumber.clear();
+}
+//------------------------------------------------------------------------------
+
+std::size_t HistoryBlock::Columns::size() const
+{
+    return epoch.size();
+}
+//------------------------------------------------------------------------------
+
+void HistoryBlock::encode(const Node *nodes, std::size_t count,
+                          std::vector<unsigned char> &data)
+{
+    TraceSpan span("HistoryBlock::encode");
+
+    std::vector<long long> values(count * ColumnsCount);
+    std::vector<std::string> strings;
+    std::map<std::string, long long> indices;
+    for (std::size_t k = 0; k < count; ++k)
+        encodeNode(nodes[k], &values[k * ColumnsCount], strings, indices);
+
+    putVarint(data, count);
+    putVarint(data, strings.size());
+    for (std::size_t i = 0; i < strings.size(); ++i)
+    {
+        putVarint(data, strings[i].length());
+        data.insert(data.end(), strings[i].begin(), strings[i].end());
+    }
+
+    for (std::size_t column = 0; column < ColumnsCount; ++column)
+    {
+        long long previous = 0;
+        std::size_t repeat = 0;
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            const long long value = values[k * ColumnsCount + column];
+            if (value == previous)
+            {
+                ++repeat;
+                continue;
+            }
+
+            if (repeat)
+            {
+                putVarint(data, 0);
+                putVarint(data, repeat - 1);
+                repeat = 0;
+            }
+            putVarint(data, zigzag(value - previous));
+            previous = value;
+        }
+
+        if (repeat)
+        {
+            putVarint(data, 0);
+            putVarint(data, repeat - 1);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+bool HistoryBlock::decode(const unsigned char *data, std::size_t size,
+                          std::vector<Node> &nodes)
+{
+    TraceSpan span("HistoryBlock::decode");
+
+    std::vector<long long> values;
+    std::vector<std::string> strings;
+    if (!decodeValues(data, size, values, strings))
+        return false;
+
+    const std::size_t count = values.size() / ColumnsCount;
+    nodes.reserve(nodes.size() + count);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const long long *v = &values[k * ColumnsCount];
+        nodes.push_back(Node());
+        Node &node = nodes.back();
+        node.setPreciseEpoch(decodeEpoch(v[Column_Epoch]));
+        node.set_n(n(v));
+        node.set_dn(dn(v));
+        node.set_d2n(d2n(v));
+        node.set_bstar(bstar(v));
+        node.set_i(angle(v, Column_i));
+        node.set_Omega(angle(v, Column_Omega));
+        node.set_omega(angle(v, Column_omega));
+        node.set_M(angle(v, Column_M));
+        node.set_e(e(v));
+        node.setElementNumber(static_cast<int>(v[Column_ElementNumber]));
+        node.setRevolutionNumber(
+                            static_cast<int>(v[Column_RevolutionNumber]));
+        node.setClassification(static_cast<char>(v[Column_Classification]));
+        node.setEphemerisType(static_cast<char>(v[Column_EphemerisType]));
+        node.setSatelliteNumber(strings[v[Column_SatelliteNumber]]);
+        node.setSatelliteName(strings[v[Column_Name]]);
+        node.setDesignator(strings[v[Column_Designator]]);
+        node.outputFormat(v[Column_FileType] == ThreeLines ? ThreeLines
+                                                           : TwoLines);
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+
+bool HistoryBlock::decode(const unsigned char *data, std::size_t size,
+                          Columns &columns)
+{
+    TraceSpan span("HistoryBlock::decode");
+
+    std::vector<long long> values;
+    std::vector<std::string> strings;
+    if (!decodeValues(data, size, values, strings))
+        return false;
+
+    const std::size_t count = values.size() / ColumnsCount;
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const long long *v = &values[k * ColumnsCount];
+        columns.epoch.push_back(decodeEpoch(v[Column_Epoch]));
+        columns.n.push_back(n(v));
+        columns.dn.push_back(dn(v));
+        columns.d2n.push_back(d2n(v));
+        columns.i.push_back(angle(v, Column_i));
+        columns.Omega.push_back(angle(v, Column_Omega));
+        columns.omega.push_back(angle(v, Column_omega));
+        columns.M.push_back(angle(v, Column_M));
+        columns.e.push_back(e(v));
+        columns.bstar.push_back(bstar(v));
+        columns.elementNumber.push_back(
+                                static_cast<int>(v[Column_ElementNumber]));
+        columns.revolutionNumber.push_back(
+                                static_cast<int>(v[Column_RevolutionNumber]));
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
@@ -34,6 +34,8 @@
 #include <cmath>
 #include <quicktle/node.h>
 #include <quicktle/func.h>
+#include <quicktle/stats.h>
+#include <quicktle/trace.h>
 
 namespace quicktle
 {
@@ -87,6 +89,7 @@ Node::Node(const Node &node)
     m_fileType = node.m_fileType;
     m_lastError = node.m_lastError;
     m_initList = node.m_initList;
+    m_modified = node.m_modified;
 }
 //------------------------------------------------------------------------------
 
@@ -118,6 +121,7 @@ void Node::swap(Node& node)
 
     std::swap(m_lastError, node.m_lastError);
     std::swap(m_initList, node.m_initList);
+    std::swap(m_modified, node.m_modified);
 }
 //------------------------------------------------------------------------------
 
@@ -152,6 +156,7 @@ void Node::init()
     m_date = 0;
     m_lastError = NoError;
     m_initList.reset();
+    m_modified = false;
 }
 //------------------------------------------------------------------------------
 
@@ -170,18 +175,20 @@ void Node::free()
 bool Node::assign(const std::string &line1, const std::string &line2,
                   const std::string &line3, bool forceParsing)
 {
+    TraceSpan span("Node::assign");
+
     // Check checksums
     ErrorCode error = checkLine(line2);
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         return false;
     }
 
     error = checkLine(line3);
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         return false;
     }
 
@@ -202,18 +209,20 @@ bool Node::assign(const std::string &line1, const std::string &line2,
 bool Node::assign(const std::string &line2, const std::string &line3,
                   bool forceParsing)
 {
+    TraceSpan span("Node::assign");
+
     // Check checksums
     ErrorCode error = checkLine(line2);
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         return false;
     }
 
     error = checkLine(line3);
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         return false;
     }
     // Assign
@@ -231,6 +240,8 @@ bool Node::assign(const std::string &line2, const std::string &line3,
 
 void Node::parseAll()
 {
+    TraceSpan span("Node::parseAll");
+
     n();
     dn();
     d2n();
@@ -265,10 +276,39 @@ Node::ErrorCode Node::checkLine(const std::string &str) const
 }
 //------------------------------------------------------------------------------
 
+bool Node::isCached(Field field, const std::string &line) const
+{
+    if (m_initList.test(field))
+    {
+        QUICKTLE_STATS_INC(CacheHits);
+        return true;
+    }
+
+    if (line.empty())
+        return true;
+
+    QUICKTLE_STATS_INC(FieldParses);
+    return false;
+}
+//------------------------------------------------------------------------------
+
+void Node::setError(ErrorCode error) const
+{
+    m_lastError = error;
+    QUICKTLE_STATS_ERROR(error);
+}
+//------------------------------------------------------------------------------
+
 std::string Node::satelliteNumber() const
 {
     if (m_initList.test(Field_SatNumber))
+    {
+        QUICKTLE_STATS_INC(CacheHits);
         return m_satelliteNumber;
+    }
+
+    if (!m_line2.empty() || !m_line3.empty())
+        QUICKTLE_STATS_INC(FieldParses);
 
     if (!m_line2.empty())
     {
@@ -277,7 +317,7 @@ std::string Node::satelliteNumber() const
         m_satelliteNumber = trim(parseString(m_line2, 2, 5, error));
         if (error != NoError)
         {
-            m_lastError = error;
+            setError(error);
             m_satelliteNumber.clear();
         }
         else
@@ -293,7 +333,7 @@ std::string Node::satelliteNumber() const
         m_satelliteNumber = trim(parseString(m_line3, 2, 5, error));
         if (error != NoError)
         {
-            m_lastError = error;
+            setError(error);
             m_satelliteNumber.clear();
         }
         else
@@ -310,12 +350,13 @@ void Node::setSatelliteNumber(const std::string &satelliteNumber)
 {
     m_satelliteNumber = satelliteNumber;
     m_initList.set(Field_SatNumber);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 std::string Node::satelliteName() const
 {
-    if (m_initList.test(Field_SatName) || m_line1.empty())
+    if (isCached(Field_SatName, m_line1))
         return m_satelliteName;
 
     std::size_t l = m_line1.length();
@@ -326,7 +367,7 @@ std::string Node::satelliteName() const
     m_satelliteName = trim(parseString(m_line1, 0, l, error));
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_satelliteName.clear();
     }
     else
@@ -342,19 +383,20 @@ void Node::setSatelliteName(const std::string& satelliteName)
 {
     m_satelliteName = satelliteName;
     m_initList.set(Field_SatName);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 std::string Node::designator() const
 {
-    if (m_initList.test(Field_Designator) || m_line2.empty())
+    if (isCached(Field_Designator, m_line2))
         return m_designator;
 
     ErrorCode error = NoError;
     m_designator = trim(parseString(m_line2, 9, 8, error));
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_designator.clear();
     }
     else
@@ -370,19 +412,20 @@ void Node::setDesignator(const std::string &designator)
 {
     m_designator = designator;
     m_initList.set(Field_Designator);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 double Node::n() const
 {
-    if (m_initList.test(Field_n) || m_line3.empty())
+    if (isCached(Field_n, m_line3))
         return m_n;
 
     ErrorCode error = NoError;
     m_n = parseDouble(m_line3, 52, 11, error) * 2 * M_PI / SECS_IN_DAY;
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_n = 0;
     }
     else
@@ -398,12 +441,13 @@ void Node::set_n(double n)
 {
     m_n = n;
     m_initList.set(Field_n);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 double Node::dn() const
 {
-    if (m_initList.test(Field_dn) || m_line2.empty())
+    if (isCached(Field_dn, m_line2))
         return  m_dn;
 
     ErrorCode error = NoError;
@@ -411,7 +455,7 @@ double Node::dn() const
                                         * 2 * M_PI / SECS_IN_DAY / SECS_IN_DAY;
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_dn = 0;
     }
     else
@@ -427,12 +471,13 @@ void Node::set_dn(double dn)
 {
     m_dn = dn;
     m_initList.set(Field_dn);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 double Node::d2n() const
 {
-    if (m_initList.test(Field_d2n) || m_line2.empty())
+    if (isCached(Field_d2n, m_line2))
         return m_d2n;
 
     ErrorCode error = NoError;
@@ -440,7 +485,7 @@ double Node::d2n() const
                     * 2 * M_PI / SECS_IN_DAY / SECS_IN_DAY / SECS_IN_DAY;
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_d2n = 0;
     }
     else
@@ -456,21 +501,26 @@ void Node::set_d2n(double d2n)
 {
     m_d2n = d2n;
     m_initList.set(Field_d2n);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 double Node::i() const
 {
-    if (m_initList.test(Field_i) || m_line3.empty())
+    if (isCached(Field_i, m_line3))
         return m_i;
 
     ErrorCode error = NoError;
     m_i = deg2rad(parseDouble(m_line3, 8, 8, error));
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_i = 0;
     }
+    else
+    {
+        m_initList.set(Field_i);
+    }
 
     return m_i;
 }
@@ -480,19 +530,20 @@ void Node::set_i(double i)
 {
     m_i = i;
     m_initList.set(Field_i);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 double Node::Omega() const
 {
-    if (m_initList.test(Field_Omega) || m_line3.empty())
+    if (isCached(Field_Omega, m_line3))
         return m_Omega;
 
     ErrorCode error = NoError;
     m_Omega = deg2rad(parseDouble(m_line3, 17, 8, error));
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_Omega = 0;
     }
     else
@@ -508,19 +559,20 @@ void Node::set_Omega(double Omega)
 {
     m_Omega = Omega;
     m_initList.set(Field_Omega);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 double Node::omega() const
 {
-    if (m_initList.test(Field_omega) || m_line3.empty())
+    if (isCached(Field_omega, m_line3))
         return m_omega;
 
     ErrorCode error = NoError;
     m_omega = deg2rad(parseDouble(m_line3, 34, 8, error));
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_omega = 0;
     }
     else
@@ -536,19 +588,20 @@ void Node::set_omega(double omega)
 {
     m_omega = omega;
     m_initList.set(Field_omega);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 double Node::M() const
 {
-    if (m_initList.test(Field_M) || m_line3.empty())
+    if (isCached(Field_M, m_line3))
         return m_M;
 
     ErrorCode error = NoError;
     m_M = deg2rad(parseDouble(m_line3, 43, 8, error));
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_M = 0;
     }
     else
@@ -564,19 +617,20 @@ void Node::set_M(double M)
 {
     m_M = M;
     m_initList.set(Field_M);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 double Node::bstar() const
 {
-    if (m_initList.test(Field_bstar) || m_line2.empty())
+    if (isCached(Field_bstar, m_line2))
         return m_bstar;
 
     ErrorCode error = NoError;
     m_bstar = parseDouble(m_line2, 53, 8, error, true);
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_bstar = 0;
     }
     else
@@ -592,19 +646,20 @@ void Node::set_bstar(double bstar)
 {
     m_bstar = bstar;
     m_initList.set(Field_bstar);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 double Node::e() const
 {
-    if (m_initList.test(Field_e) || m_line3.empty())
+    if (isCached(Field_e, m_line3))
         return m_e;
 
     ErrorCode error = NoError;
     m_e = parseDouble(m_line3, 26, 8, error, true);
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_e = 0;
     }
     else
@@ -620,19 +675,20 @@ void Node::set_e(double e)
 {
     m_e = e;
     m_initList.set(Field_e);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 char Node::classification() const
 {
-    if (m_initList.test(Field_Classification) || m_line2.empty())
+    if (isCached(Field_Classification, m_line2))
         return m_classification;
 
     ErrorCode error = NoError;
     m_classification = parseChar(m_line2, 7, error);
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_classification = '\0';
     }
     else
@@ -648,19 +704,20 @@ void Node::setClassification(char classification)
 {
     m_classification = classification;
     m_initList.set(Field_Classification);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 char Node::ephemerisType() const
 {
-    if (m_initList.test(Field_EphemerisType) || m_line2.empty())
+    if (isCached(Field_EphemerisType, m_line2))
         return m_ephemerisType;
 
     ErrorCode error = NoError;
     m_ephemerisType = parseChar(m_line2, 62, error);
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_ephemerisType = '\0';
     }
     else
@@ -676,19 +733,20 @@ void Node::setEphemerisType(char ephemerisType)
 {
     m_ephemerisType = ephemerisType;
     m_initList.set(Field_EphemerisType);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 int Node::elementNumber() const
 {
-    if (m_initList.test(Field_ElementNumber) || m_line2.empty())
+    if (isCached(Field_ElementNumber, m_line2))
         return m_elementNumber;
 
     ErrorCode error = NoError;
     m_elementNumber = parseInt(m_line2, 64, 4, error);
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_elementNumber = 0;
     }
     else
@@ -704,19 +762,20 @@ void Node::setElementNumber(int elementNumber)
 {
     m_elementNumber = elementNumber;
     m_initList.set(Field_ElementNumber);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 int Node::revolutionNumber() const
 {
-    if (m_initList.test(Field_RevolutionNumber) || m_line3.empty())
+    if (isCached(Field_RevolutionNumber, m_line3))
         return m_revolutionNumber;
 
     ErrorCode error = NoError;
     m_revolutionNumber = parseInt(m_line3, 63, 5, error);
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_revolutionNumber = 0;
     }
     else
@@ -732,19 +791,20 @@ void Node::setRevolutionNumber(int revolutionNumber)
 {
     m_revolutionNumber = revolutionNumber;
     m_initList.set(Field_RevolutionNumber);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
 double Node::preciseEpoch() const
 {
-    if (m_initList.test(Field_date) || m_line2.empty())
+    if (isCached(Field_date, m_line2))
         return m_date;
 
     ErrorCode error = NoError;
     std::string date = parseString(m_line2, 18, 14, error);
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_date = 0;
         return m_date;
     }
@@ -752,7 +812,7 @@ double Node::preciseEpoch() const
     m_date = string2date(date, error);
     if (error != NoError)
     {
-        m_lastError = error;
+        setError(error);
         m_date = 0;
     }
     else
@@ -768,6 +828,7 @@ void Node::setPreciseEpoch(double preciseEpoch)
 {
     m_date = preciseEpoch;
     m_initList.set(Field_date);
+    m_modified = true;
 }
 //------------------------------------------------------------------------------
 
@@ -841,15 +902,29 @@ Node& Node::outputFormat(const FileType format)
 }
 //------------------------------------------------------------------------------
 
+FileType Node::outputFormat() const
+{
+    return m_fileType;
+}
+//------------------------------------------------------------------------------
+
 std::ostream& operator<<(std::ostream& stream, const Node& node)
 {
+    // The lines of unmodified node are written as they have been read
+    const bool verbatim = !node.m_modified && !node.m_line2.empty();
     if (node.m_fileType == ThreeLines)
     {
         // Three lines TLE format
-        stream << node.firstString() << std::endl;
+        if (verbatim && !node.m_line1.empty())
+            stream << node.m_line1 << '\n';
+        else
+            stream << node.firstString() << '\n';
     }
-    stream << node.secondString() << std::endl;
-    stream << node.thirdString() << std::endl;
+
+    if (verbatim)
+        stream << node.m_line2 << '\n' << node.m_line3 << '\n';
+    else
+        stream << node.secondString() << '\n' << node.thirdString() << '\n';
 
     return stream;
 }
@@ -0,0 +1,354 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file nodeview.cpp
+    \brief File contains the realization of methods
+           of quicktle::NodeView class.
+*/
+
+#define CHECKSUM_INDEX 68  //!< Index of checksum symbol in the TLE format line
+#define SECS_IN_DAY 86400
+#define NAME_LENGTH 24     //!< Max length of satellite name
+
+#include <cctype>
+#include <cmath>
+#include <quicktle/func.h>
+#include <quicktle/nodeview.h>
+
+namespace quicktle
+{
+
+NodeView::NodeView()
+    : m_line1(0),
+      m_line2(0),
+      m_line3(0),
+      m_length1(0),
+      m_length2(0),
+      m_length3(0),
+      m_lastError(Node::NoError)
+{
+}
+//------------------------------------------------------------------------------
+
+NodeView::NodeView(const char *line2, std::size_t length2,
+                   const char *line3, std::size_t length3)
+    : m_line1(0),
+      m_line2(line2),
+      m_line3(line3),
+      m_length1(0),
+      m_length2(length2),
+      m_length3(length3),
+      m_lastError(Node::NoError)
+{
+}
+//------------------------------------------------------------------------------
+
+NodeView::NodeView(const char *line1, std::size_t length1,
+                   const char *line2, std::size_t length2,
+                   const char *line3, std::size_t length3)
+    : m_line1(line1),
+      m_line2(line2),
+      m_line3(line3),
+      m_length1(length1),
+      m_length2(length2),
+      m_length3(length3),
+      m_lastError(Node::NoError)
+{
+}
+//------------------------------------------------------------------------------
+
+Node::ErrorCode NodeView::check() const
+{
+    const char *lines[] = {m_line2, m_line3};
+    const std::size_t lengths[] = {m_length2, m_length3};
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        if (!lines[i] || lengths[i] < CHECKSUM_INDEX + 1)
+            return Node::TooShortString;
+
+        const char symbol = lines[i][CHECKSUM_INDEX];
+        const int actualChecksum = isdigit(symbol) ? symbol - '0' : 0;
+        if (checksum(lines[i], CHECKSUM_INDEX) != actualChecksum)
+            return Node::ChecksumError;
+    }
+
+    return Node::NoError;
+}
+//------------------------------------------------------------------------------
+
+std::string NodeView::satelliteNumber() const
+{
+    // Try to obtain the satellite number from the second line...
+    Node::ErrorCode error = Node::NoError;
+    if (m_line2)
+    {
+        std::string number = stringField(m_line2, m_length2, 2, 5, error);
+        if (error == Node::NoError)
+            return trim(number);
+    }
+
+    if (m_line3)
+    {
+        error = Node::NoError;
+        std::string number = stringField(m_line3, m_length3, 2, 5, error);
+        if (error == Node::NoError)
+            return trim(number);
+    }
+
+    if (error != Node::NoError)
+        setError(error);
+    return std::string();
+}
+//------------------------------------------------------------------------------
+
+std::string NodeView::satelliteName() const
+{
+    if (!m_line1)
+        return std::string();
+
+    const std::size_t length = m_length1 > NAME_LENGTH ? NAME_LENGTH
+                                                       : m_length1;
+    Node::ErrorCode error = Node::NoError;
+    return trim(stringField(m_line1, m_length1, 0, length, error));
+}
+//------------------------------------------------------------------------------
+
+std::string NodeView::designator() const
+{
+    if (!m_line2)
+        return std::string();
+
+    Node::ErrorCode error = Node::NoError;
+    std::string designator = stringField(m_line2, m_length2, 9, 8, error);
+    if (error != Node::NoError)
+        setError(error);
+    return trim(designator);
+}
+//------------------------------------------------------------------------------
+
+double NodeView::n() const
+{
+    return field(m_line3, m_length3, 52, 11) * 2 * M_PI / SECS_IN_DAY;
+}
+//------------------------------------------------------------------------------
+
+double NodeView::dn() const
+{
+    return 2 * field(m_line2, m_length2, 33, 10)
+                                        * 2 * M_PI / SECS_IN_DAY / SECS_IN_DAY;
+}
+//------------------------------------------------------------------------------
+
+double NodeView::d2n() const
+{
+    return 6 * field(m_line2, m_length2, 44, 8, true)
+                    * 2 * M_PI / SECS_IN_DAY / SECS_IN_DAY / SECS_IN_DAY;
+}
+//------------------------------------------------------------------------------
+
+double NodeView::i() const
+{
+    return deg2rad(field(m_line3, m_length3, 8, 8));
+}
+//------------------------------------------------------------------------------
+
+double NodeView::Omega() const
+{
+    return deg2rad(field(m_line3, m_length3, 17, 8));
+}
+//------------------------------------------------------------------------------
+
+double NodeView::omega() const
+{
+    return deg2rad(field(m_line3, m_length3, 34, 8));
+}
+//------------------------------------------------------------------------------
+
+double NodeView::M() const
+{
+    return deg2rad(field(m_line3, m_length3, 43, 8));
+}
+//------------------------------------------------------------------------------
+
+double NodeView::bstar() const
+{
+    return field(m_line2, m_length2, 53, 8, true);
+}
+//------------------------------------------------------------------------------
+
+double NodeView::e() const
+{
+    return field(m_line3, m_length3, 26, 8, true);
+}
+//------------------------------------------------------------------------------
+
+char NodeView::classification() const
+{
+    return charField(m_line2, m_length2, 7);
+}
+//------------------------------------------------------------------------------
+
+char NodeView::ephemerisType() const
+{
+    return charField(m_line2, m_length2, 62);
+}
+//------------------------------------------------------------------------------
+
+double NodeView::preciseEpoch() const
+{
+    if (!m_line2)
+        return 0;
+
+    if (m_length2 < 18 + 14)
+    {
+        setError(Node::TooShortString);
+        return 0;
+    }
+
+    Node::ErrorCode error = Node::NoError;
+    const double date = parseRawDate(m_line2 + 18, 14, error);
+    if (error != Node::NoError)
+    {
+        setError(error);
+        return 0;
+    }
+
+    return date;
+}
+//------------------------------------------------------------------------------
+
+std::time_t NodeView::epoch() const
+{
+    return static_cast<std::time_t>(preciseEpoch());
+}
+//------------------------------------------------------------------------------
+
+int NodeView::elementNumber() const
+{
+    return intField(m_line2, m_length2, 64, 4);
+}
+//------------------------------------------------------------------------------
+
+int NodeView::revolutionNumber() const
+{
+    return intField(m_line3, m_length3, 63, 5);
+}
+//------------------------------------------------------------------------------
+
+Node NodeView::toNode() const
+{
+    const std::string line2 = m_line2 ? std::string(m_line2, m_length2)
+                                      : std::string();
+    const std::string line3 = m_line3 ? std::string(m_line3, m_length3)
+                                      : std::string();
+    if (!m_line1)
+        return Node(line2, line3);
+
+    return Node(std::string(m_line1, m_length1), line2, line3);
+}
+//------------------------------------------------------------------------------
+
+double NodeView::field(const char *line, std::size_t length,
+                       std::size_t start, std::size_t fieldLength,
+                       bool decimalPointAssumed) const
+{
+    if (!line)
+        return 0;
+
+    if (length < start + fieldLength)
+    {
+        setError(Node::TooShortString);
+        return 0;
+    }
+
+    Node::ErrorCode error = Node::NoError;
+    const double value = parseRawDouble(line + start, fieldLength, error,
+                                        decimalPointAssumed);
+    if (error != Node::NoError)
+    {
+        setError(error);
+        return 0;
+    }
+
+    return value;
+}
+//------------------------------------------------------------------------------
+
+int NodeView::intField(const char *line, std::size_t length,
+                       std::size_t start, std::size_t fieldLength) const
+{
+    if (!line)
+        return 0;
+
+    if (length < start + fieldLength)
+    {
+        setError(Node::TooShortString);
+        return 0;
+    }
+
+    Node::ErrorCode error = Node::NoError;
+    const int value = parseRawInt(line + start, fieldLength, error);
+    if (error != Node::NoError)
+    {
+        setError(error);
+        return 0;
+    }
+
+    return value;
+}
+//------------------------------------------------------------------------------
+
+char NodeView::charField(const char *line, std::size_t length,
+                         std::size_t index) const
+{
+    if (!line)
+        return '\0';
+
+    if (index >= length)
+    {
+        setError(Node::TooShortString);
+        return '\0';
+    }
+
+    return line[index];
+}
+//------------------------------------------------------------------------------
+
+std::string NodeView::stringField(const char *line, std::size_t length,
+                                  std::size_t start, std::size_t fieldLength,
+                                  Node::ErrorCode &error) const
+{
+    if (length < start + fieldLength)
+    {
+        error = Node::TooShortString;
+        return std::string();
+    }
+
+    return std::string(line + start, fieldLength);
+}
+//------------------------------------------------------------------------------
+
+void NodeView::setError(Node::ErrorCode error) const
+{
+    m_lastError = error;
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
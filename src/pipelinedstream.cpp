@@ -0,0 +1,257 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file pipelinedstream.cpp
+    \brief File contains the realization of methods
+           of quicktle::PipelinedStream class.
+*/
+
+#define PIPELINE_BLOCK_SIZE (1 << 20) //!< Default size of the input block
+#define PIPELINE_BLOCKS_COUNT 4       //!< Capacity of the blocks queue
+
+#include <cstring>
+#include <quicktle/pipelinedstream.h>
+#include <quicktle/stats.h>
+#include <quicktle/trace.h>
+
+namespace quicktle
+{
+
+PipelinedStream::PipelinedStream(std::istream &source,
+                                 const FileType fileType)
+    : m_source(&source),
+      m_fileType(fileType),
+      m_enforceParsing(false),
+      m_blockSize(PIPELINE_BLOCK_SIZE),
+      m_produced(0),
+      m_consumed(0),
+      m_end(false),
+      m_stop(false),
+      m_producerWaits(false),
+      m_consumerWaits(false),
+      m_block(0),
+      m_position(0)
+{
+}
+//------------------------------------------------------------------------------
+
+PipelinedStream::~PipelinedStream()
+{
+    if (!m_thread.joinable())
+        return;
+
+    m_stop = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_condition.notify_all();
+    }
+    m_thread.join();
+}
+//------------------------------------------------------------------------------
+
+void PipelinedStream::setBlockSize(std::size_t size)
+{
+    if (m_blocks.empty() && size)
+        m_blockSize = size;
+}
+//------------------------------------------------------------------------------
+
+PipelinedStream& PipelinedStream::operator>>(Node &node)
+{
+    TraceSpan span("PipelinedStream::read");
+
+    readLine(m_lines[0]);
+    readLine(m_lines[1]);
+
+    if (m_fileType == ThreeLines)
+    {
+        readLine(m_lines[2]);
+        node.assign(m_lines[0], m_lines[1], m_lines[2], m_enforceParsing);
+    }
+    else
+    {
+        node.assign(m_lines[0], m_lines[1], m_enforceParsing);
+    }
+    QUICKTLE_STATS_INC(RecordsRead);
+
+    return *this;
+}
+//------------------------------------------------------------------------------
+
+PipelinedStream& PipelinedStream::operator>>(DataSet &dataSet)
+{
+    Node node;
+    operator>>(node);
+    dataSet.append(node);
+
+    return *this;
+}
+//------------------------------------------------------------------------------
+
+PipelinedStream& PipelinedStream::operator>>(Catalog &catalog)
+{
+    Node node;
+    operator>>(node);
+    catalog.append(node);
+
+    return *this;
+}
+//------------------------------------------------------------------------------
+
+PipelinedStream::operator bool()
+{
+    // The current block is released as soon as it is read to the end,
+    // so any acquired block contains unread data
+    return acquireBlock();
+}
+//------------------------------------------------------------------------------
+
+bool PipelinedStream::enforceParsing(bool parsingMode)
+{
+    bool res = m_enforceParsing;
+    m_enforceParsing = parsingMode;
+    return res;
+}
+//------------------------------------------------------------------------------
+
+void PipelinedStream::start()
+{
+    // The memory of the blocks is allocated by the helper thread,
+    // when the block is used for the first time
+    m_blocks.resize(PIPELINE_BLOCKS_COUNT);
+    m_thread = std::thread(&PipelinedStream::run, this);
+}
+//------------------------------------------------------------------------------
+
+void PipelinedStream::run()
+{
+    while (true)
+    {
+        if (m_produced - m_consumed == PIPELINE_BLOCKS_COUNT)
+        {
+            // The flag is set before the check, so the consumer either
+            // sees it or the check sees the released block
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_producerWaits = true;
+            while (!m_stop &&
+                   m_produced - m_consumed == PIPELINE_BLOCKS_COUNT)
+                m_condition.wait(lock);
+            m_producerWaits = false;
+        }
+        if (m_stop)
+            break;
+
+        Block &block = m_blocks[m_produced % PIPELINE_BLOCKS_COUNT];
+        {
+            TraceSpan span("PipelinedStream::fill");
+            if (block.data.empty())
+                block.data.resize(m_blockSize);
+            m_source->read(&block.data[0], block.data.size());
+            block.size = m_source->gcount();
+        }
+
+        const bool end = (block.size < block.data.size());
+        if (block.size)
+            ++m_produced;
+        if (end)
+            m_end = true;
+
+        if (m_consumerWaits)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_condition.notify_all();
+        }
+        if (end)
+            break;
+    }
+}
+//------------------------------------------------------------------------------
+
+bool PipelinedStream::acquireBlock()
+{
+    if (m_block)
+        return true;
+    if (m_blocks.empty())
+        start();
+
+    if (m_consumed == m_produced)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_consumerWaits = true;
+        while (m_consumed == m_produced && !m_end)
+            m_condition.wait(lock);
+        m_consumerWaits = false;
+
+        // The last block is published before the end flag
+        if (m_consumed == m_produced)
+            return false;
+    }
+
+    m_block = &m_blocks[m_consumed % PIPELINE_BLOCKS_COUNT];
+    m_position = 0;
+    return true;
+}
+//------------------------------------------------------------------------------
+
+void PipelinedStream::releaseBlock()
+{
+    m_block = 0;
+    ++m_consumed;
+
+    if (m_producerWaits)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_condition.notify_all();
+    }
+}
+//------------------------------------------------------------------------------
+
+void PipelinedStream::readLine(std::string &line)
+{
+    line.clear();
+    while (acquireBlock())
+    {
+        const char *data = &m_block->data[0];
+        const char *begin = data + m_position;
+        const char *end = data + m_block->size;
+        const char *eol = static_cast<const char*>(
+            std::memchr(begin, '\n', end - begin));
+
+        if (!eol)
+        {
+            // The line is continued in the next block
+            line.append(begin, end);
+            releaseBlock();
+            continue;
+        }
+
+        line.append(begin, eol);
+        m_position = eol + 1 - data;
+        if (m_position == m_block->size)
+            releaseBlock();
+        break;
+    }
+
+    if (!line.empty() && line[line.size() - 1] == '\r')
+        line.resize(line.size() - 1);
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
@@ -0,0 +1,128 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file recordfilter.cpp
+    \brief File contains the realization of methods
+           of quicktle::RecordFilter class.
+*/
+
+#include <quicktle/func.h>
+#include <quicktle/recordfilter.h>
+
+namespace quicktle
+{
+
+RecordFilter::RecordFilter()
+    : m_hasEpochRange(false),
+      m_firstEpoch(0),
+      m_lastEpoch(0)
+{
+}
+//------------------------------------------------------------------------------
+
+void RecordFilter::addSatellite(const std::string &satelliteNumber)
+{
+    m_satellites.insert(trim(satelliteNumber));
+}
+//------------------------------------------------------------------------------
+
+void RecordFilter::setEpochRange(double first, double last)
+{
+    m_hasEpochRange = true;
+    m_firstEpoch = first;
+    m_lastEpoch = last;
+}
+//------------------------------------------------------------------------------
+
+void RecordFilter::addRange(Element element, double min, double max)
+{
+    Range range;
+    range.element = element;
+    range.min = min;
+    range.max = max;
+    m_ranges.push_back(range);
+}
+//------------------------------------------------------------------------------
+
+void RecordFilter::clear()
+{
+    m_satellites.clear();
+    m_hasEpochRange = false;
+    m_ranges.clear();
+}
+//------------------------------------------------------------------------------
+
+bool RecordFilter::empty() const
+{
+    return m_satellites.empty() && !m_hasEpochRange && m_ranges.empty();
+}
+//------------------------------------------------------------------------------
+
+bool RecordFilter::accept(const NodeView &view) const
+{
+    if (!m_satellites.empty() &&
+        !m_satellites.count(view.satelliteNumber()))
+        return false;
+
+    if (m_hasEpochRange)
+    {
+        const double epoch = view.preciseEpoch();
+        if (view.lastError() != Node::NoError ||
+            epoch < m_firstEpoch || epoch > m_lastEpoch)
+            return false;
+    }
+
+    for (std::size_t i = 0; i < m_ranges.size(); ++i)
+    {
+        const Range &range = m_ranges[i];
+        const double x = value(view, range.element);
+        if (view.lastError() != Node::NoError ||
+            x < range.min || x > range.max)
+            return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+
+double RecordFilter::value(const NodeView &view, Element element)
+{
+    switch (element)
+    {
+    case MeanMotion:
+        return view.n();
+    case Eccentricity:
+        return view.e();
+    case Inclination:
+        return view.i();
+    case RightAscension:
+        return view.Omega();
+    case ArgumentOfPerigee:
+        return view.omega();
+    case MeanAnomaly:
+        return view.M();
+    case Bstar:
+        return view.bstar();
+    }
+    return 0;
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
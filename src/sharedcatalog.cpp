@@ -0,0 +1,327 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file sharedcatalog.cpp
+    \brief File contains the realization of methods
+           of quicktle::SharedCatalogWriter and
+           quicktle::SharedCatalogReader classes.
+*/
+
+#define OPEN_ATTEMPTS 8  //!< Attempts to open the segment, which is replaced
+
+#include <atomic>
+#include <cstring>
+#include <sstream>
+#include <quicktle/sharedcatalog.h>
+#include <quicktle/trace.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace quicktle
+{
+
+namespace
+{
+    const char CONTROL_MAGIC[8] = {'Q', 'T', 'L', 'E', 'S', 'H', 'M', '1'};
+
+    //! Content of the control segment
+    struct Control
+    {
+        char magic[8];
+        std::atomic<unsigned long long> generation;
+    };
+
+    std::string controlName(const std::string &name)
+    {
+        return (!name.empty() && name[0] == '/') ? name : "/" + name;
+    }
+
+    std::string segmentName(const std::string &name,
+                            unsigned long long generation)
+    {
+        std::ostringstream segment;
+        segment << name << "." << generation;
+        return segment.str();
+    }
+
+#ifndef _WIN32
+    //! Map the control segment, the writer creates it if necessary
+    void* mapControl(const std::string &name, bool writable)
+    {
+        int fd = shm_open(name.c_str(), writable ? O_CREAT | O_RDWR : O_RDONLY,
+                          0644);
+        if (fd < 0)
+            return 0;
+
+        struct stat info;
+        bool valid = !fstat(fd, &info);
+        if (valid && writable &&
+            info.st_size < static_cast<off_t>(sizeof(Control)))
+            valid = !ftruncate(fd, sizeof(Control));
+        else if (valid && !writable)
+            valid = info.st_size >= static_cast<off_t>(sizeof(Control));
+
+        void *mapping = MAP_FAILED;
+        if (valid)
+            mapping = mmap(0, sizeof(Control),
+                           writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                           MAP_SHARED, fd, 0);
+        close(fd);
+
+        return (mapping != MAP_FAILED) ? mapping : 0;
+    }
+#endif
+}
+
+SharedCatalogWriter::SharedCatalogWriter(const std::string &name)
+    : m_name(controlName(name)),
+      m_control(0)
+{
+}
+//------------------------------------------------------------------------------
+
+SharedCatalogWriter::~SharedCatalogWriter()
+{
+#ifndef _WIN32
+    if (m_control)
+        munmap(m_control, sizeof(Control));
+#endif
+}
+//------------------------------------------------------------------------------
+
+bool SharedCatalogWriter::publish(const Catalog &catalog)
+{
+#ifndef _WIN32
+    TraceSpan span("SharedCatalogWriter::publish");
+
+    if (!m_control && !openControl())
+        return false;
+
+    std::ostringstream image;
+    if (!Snapshot::write(catalog, image))
+        return false;
+    const std::string data = image.str();
+
+    Control *control = static_cast<Control*>(m_control);
+    const unsigned long long previous = control->generation.load();
+    const unsigned long long generation = previous + 1;
+    const std::string segment = segmentName(m_name, generation);
+
+    // The segment may be left by the crashed writer
+    shm_unlink(segment.c_str());
+    int fd = shm_open(segment.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+        return false;
+
+    void *mapping = MAP_FAILED;
+    if (!ftruncate(fd, data.size()))
+        mapping = mmap(0, data.size(), PROT_READ | PROT_WRITE, MAP_SHARED,
+                       fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        shm_unlink(segment.c_str());
+        return false;
+    }
+
+    memcpy(mapping, data.data(), data.size());
+    munmap(mapping, data.size());
+
+    // The readers see the complete segment after the new generation
+    control->generation.store(generation, std::memory_order_release);
+    if (previous)
+        shm_unlink(segmentName(m_name, previous).c_str());
+
+    return true;
+#else
+    return false;
+#endif
+}
+//------------------------------------------------------------------------------
+
+unsigned long long SharedCatalogWriter::generation() const
+{
+    if (!m_control)
+        return 0;
+
+    return static_cast<Control*>(m_control)->generation.load();
+}
+//------------------------------------------------------------------------------
+
+void SharedCatalogWriter::remove(const std::string &name)
+{
+#ifndef _WIN32
+    const std::string control = controlName(name);
+    void *mapping = mapControl(control, false);
+    if (mapping)
+    {
+        unsigned long long generation =
+            static_cast<Control*>(mapping)->generation.load();
+        munmap(mapping, sizeof(Control));
+        if (generation)
+            shm_unlink(segmentName(control, generation).c_str());
+    }
+    shm_unlink(control.c_str());
+#endif
+}
+//------------------------------------------------------------------------------
+
+bool SharedCatalogWriter::openControl()
+{
+#ifndef _WIN32
+    m_control = mapControl(m_name, true);
+    if (!m_control)
+        return false;
+
+    Control *control = static_cast<Control*>(m_control);
+    if (memcmp(control->magic, CONTROL_MAGIC, sizeof(CONTROL_MAGIC)))
+    {
+        control->generation.store(0);
+        memcpy(control->magic, CONTROL_MAGIC, sizeof(CONTROL_MAGIC));
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+//------------------------------------------------------------------------------
+
+SharedCatalogReader::SharedCatalogReader(const std::string &name)
+    : m_name(controlName(name)),
+      m_control(0),
+      m_mapping(0),
+      m_mappingSize(0),
+      m_generation(0)
+{
+}
+//------------------------------------------------------------------------------
+
+SharedCatalogReader::~SharedCatalogReader()
+{
+    unmap();
+#ifndef _WIN32
+    if (m_control)
+        munmap(m_control, sizeof(Control));
+#endif
+}
+//------------------------------------------------------------------------------
+
+bool SharedCatalogReader::refresh()
+{
+#ifndef _WIN32
+    if (!m_control && !openControl())
+        return false;
+
+    Control *control = static_cast<Control*>(m_control);
+    for (int attempt = 0; attempt < OPEN_ATTEMPTS; ++attempt)
+    {
+        const unsigned long long generation =
+            control->generation.load(std::memory_order_acquire);
+        if (!generation || generation == m_generation)
+            break;
+
+        // The segment is unlinked, if the next one is already published
+        int fd = shm_open(segmentName(m_name, generation).c_str(),
+                          O_RDONLY, 0);
+        if (fd < 0)
+            continue;
+
+        struct stat info;
+        void *mapping = MAP_FAILED;
+        if (!fstat(fd, &info) && info.st_size > 0)
+            mapping = mmap(0, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED)
+            break;
+
+        const std::size_t size = static_cast<std::size_t>(info.st_size);
+        if (!m_snapshot.attach(mapping, size))
+        {
+            munmap(mapping, size);
+            if (m_mapping)
+                m_snapshot.attach(m_mapping, m_mappingSize);
+            break;
+        }
+
+        unmap();
+        m_mapping = mapping;
+        m_mappingSize = size;
+        m_generation = generation;
+        break;
+    }
+
+    return m_mapping != 0;
+#else
+    return false;
+#endif
+}
+//------------------------------------------------------------------------------
+
+unsigned long long SharedCatalogReader::generation() const
+{
+    return m_generation;
+}
+//------------------------------------------------------------------------------
+
+bool SharedCatalogReader::outdated() const
+{
+    if (!m_control)
+        return false;
+
+    return static_cast<Control*>(m_control)->generation.load(
+        std::memory_order_acquire) != m_generation;
+}
+//------------------------------------------------------------------------------
+
+const Snapshot& SharedCatalogReader::snapshot() const
+{
+    return m_snapshot;
+}
+//------------------------------------------------------------------------------
+
+bool SharedCatalogReader::openControl()
+{
+#ifndef _WIN32
+    m_control = mapControl(m_name, false);
+    return m_control != 0;
+#else
+    return false;
+#endif
+}
+//------------------------------------------------------------------------------
+
+void SharedCatalogReader::unmap()
+{
+#ifndef _WIN32
+    if (m_mapping)
+        munmap(m_mapping, m_mappingSize);
+#endif
+    m_mapping = 0;
+    m_mappingSize = 0;
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
@@ -0,0 +1,618 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file snapshot.cpp
+    \brief File contains the realization of methods
+           of quicktle::Snapshot class.
+*/
+
+#define SNAPSHOT_VERSION 1
+#define HEADER_SIZE 72
+#define SATELLITE_SIZE 16
+#define RECORD_SIZE 104
+#define NUMBER_LENGTH 8  //!< Max length of satellite number
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+#include <quicktle/func.h>
+#include <quicktle/snapshot.h>
+#include <quicktle/trace.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace quicktle
+{
+
+namespace
+{
+    const char MAGIC[8] = {'Q', 'T', 'L', 'E', 'S', 'N', 'A', 'P'};
+
+    // Offsets of the header fields
+    enum
+    {
+        Header_Version = 8,
+        Header_RecordSize = 12,
+        Header_SatellitesCount = 16,
+        Header_RecordsCount = 24,
+        Header_SatellitesOffset = 32,
+        Header_RecordsOffset = 40,
+        Header_StringsOffset = 48,
+        Header_Size = 56,
+        Header_PayloadChecksum = 64,
+        Header_HeaderChecksum = 68
+    };
+
+    // Offsets of the satellite fields
+    enum
+    {
+        Satellite_Number = 0,
+        Satellite_FirstRecord = 8,
+        Satellite_RecordsCount = 12
+    };
+
+    // Offsets of the record fields
+    enum
+    {
+        Record_Epoch = 0,
+        Record_n = 8,
+        Record_dn = 16,
+        Record_d2n = 24,
+        Record_i = 32,
+        Record_Omega = 40,
+        Record_omega = 48,
+        Record_M = 56,
+        Record_e = 64,
+        Record_bstar = 72,
+        Record_Name = 80,
+        Record_Designator = 84,
+        Record_ElementNumber = 88,
+        Record_RevolutionNumber = 92,
+        Record_Classification = 96,
+        Record_EphemerisType = 97,
+        Record_FileType = 98
+    };
+
+    //! Table of unique zero-terminated strings
+    class StringTable
+    {
+    public:
+        StringTable()
+        {
+            // Offset 0 is the empty string
+            m_data.push_back('\0');
+            m_offsets[std::string()] = 0;
+        }
+
+        unsigned long offset(const std::string &str)
+        {
+            std::map<std::string, unsigned long>::iterator it =
+                m_offsets.find(str);
+            if (it != m_offsets.end())
+                return it->second;
+
+            const unsigned long offset = m_data.size();
+            m_data.insert(m_data.end(), str.begin(), str.end());
+            m_data.push_back('\0');
+            m_offsets[str] = offset;
+
+            return offset;
+        }
+
+        const std::vector<unsigned char>& data() const
+        {
+            return m_data;
+        }
+
+    private:
+        std::vector<unsigned char> m_data;
+        std::map<std::string, unsigned long> m_offsets;
+    };
+
+    void putRecord(unsigned char *p, const Node &node, StringTable &strings)
+    {
+        memset(p, 0, RECORD_SIZE);
+        putDouble(p + Record_Epoch, node.preciseEpoch());
+        putDouble(p + Record_n, node.n());
+        putDouble(p + Record_dn, node.dn());
+        putDouble(p + Record_d2n, node.d2n());
+        putDouble(p + Record_i, node.i());
+        putDouble(p + Record_Omega, node.Omega());
+        putDouble(p + Record_omega, node.omega());
+        putDouble(p + Record_M, node.M());
+        putDouble(p + Record_e, node.e());
+        putDouble(p + Record_bstar, node.bstar());
+        putU32(p + Record_Name, strings.offset(node.satelliteName()));
+        putU32(p + Record_Designator, strings.offset(node.designator()));
+        putU32(p + Record_ElementNumber, node.elementNumber());
+        putU32(p + Record_RevolutionNumber, node.revolutionNumber());
+        p[Record_Classification] = node.classification();
+        p[Record_EphemerisType] = node.ephemerisType();
+        p[Record_FileType] = static_cast<unsigned char>(node.outputFormat());
+    }
+}
+
+Snapshot::Snapshot()
+    : m_data(0),
+      m_size(0),
+      m_mapping(0),
+      m_mappingSize(0),
+      m_status(NotOpened),
+      m_satellitesCount(0),
+      m_recordsCount(0),
+      m_satellitesOffset(0),
+      m_recordsOffset(0),
+      m_stringsOffset(0)
+{
+}
+//------------------------------------------------------------------------------
+
+Snapshot::~Snapshot()
+{
+    close();
+}
+//------------------------------------------------------------------------------
+
+bool Snapshot::open(const std::string &fileName)
+{
+    TraceSpan span("Snapshot::open");
+
+    close();
+    m_status = FileError;
+
+#ifndef _WIN32
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) || info.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(info.st_size);
+    void *mapping = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+        return false;
+#else
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!file)
+        return false;
+
+    file.seekg(0, std::ios::end);
+    const std::size_t size = static_cast<std::size_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
+    char *mapping = new char[size];
+    if (!file.read(mapping, size))
+    {
+        delete[] mapping;
+        return false;
+    }
+#endif
+
+    if (!attach(mapping, size))
+    {
+        const Status status = m_status;
+        m_mapping = mapping;
+        m_mappingSize = size;
+        close();
+        m_status = status;
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_mappingSize = size;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+
+bool Snapshot::attach(const void *data, std::size_t size)
+{
+    if (m_mapping)
+        close();
+
+    m_data = 0;
+    m_size = 0;
+    m_satellitesCount = 0;
+    m_recordsCount = 0;
+
+    const unsigned char *p = static_cast<const unsigned char*>(data);
+    if (!p || size < HEADER_SIZE || memcmp(p, MAGIC, sizeof(MAGIC)))
+    {
+        m_status = InvalidHeader;
+        return false;
+    }
+
+    if (fnv1a(p, Header_HeaderChecksum) != getU32(p + Header_HeaderChecksum))
+    {
+        m_status = HeaderChecksumError;
+        return false;
+    }
+
+    if (getU32(p + Header_Version) != SNAPSHOT_VERSION)
+    {
+        m_status = UnsupportedVersion;
+        return false;
+    }
+
+    const unsigned long long satellitesCount =
+        getU64(p + Header_SatellitesCount);
+    const unsigned long long recordsCount = getU64(p + Header_RecordsCount);
+    const unsigned long long satellitesOffset =
+        getU64(p + Header_SatellitesOffset);
+    const unsigned long long recordsOffset = getU64(p + Header_RecordsOffset);
+    const unsigned long long stringsOffset = getU64(p + Header_StringsOffset);
+
+    // The sections must follow each other inside the snapshot. The offsets
+    // are ordered first, so the sizes of the sections do not overflow.
+    bool valid = getU32(p + Header_RecordSize) == RECORD_SIZE &&
+                 getU64(p + Header_Size) == size &&
+                 satellitesOffset >= HEADER_SIZE &&
+                 satellitesOffset <= recordsOffset &&
+                 recordsOffset <= stringsOffset &&
+                 stringsOffset < size &&
+                 satellitesCount <= (recordsOffset - satellitesOffset)
+                                    / SATELLITE_SIZE &&
+                 recordsCount <= (stringsOffset - recordsOffset)
+                                 / RECORD_SIZE &&
+                 p[size - 1] == '\0';
+
+    for (unsigned long long i = 0; valid && i < satellitesCount; ++i)
+    {
+        const unsigned char *entry =
+            p + satellitesOffset + i * SATELLITE_SIZE;
+        valid = getU32(entry + Satellite_FirstRecord) +
+                static_cast<unsigned long long>(
+                    getU32(entry + Satellite_RecordsCount)) <= recordsCount;
+    }
+
+    if (!valid)
+    {
+        m_status = InvalidHeader;
+        return false;
+    }
+
+    m_data = p;
+    m_size = size;
+    m_satellitesCount = satellitesCount;
+    m_recordsCount = recordsCount;
+    m_satellitesOffset = satellitesOffset;
+    m_recordsOffset = recordsOffset;
+    m_stringsOffset = stringsOffset;
+    m_status = Ok;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+
+void Snapshot::close()
+{
+    if (m_mapping)
+    {
+#ifndef _WIN32
+        munmap(m_mapping, m_mappingSize);
+#else
+        delete[] static_cast<char*>(m_mapping);
+#endif
+    }
+
+    m_mapping = 0;
+    m_mappingSize = 0;
+    m_data = 0;
+    m_size = 0;
+    m_satellitesCount = 0;
+    m_recordsCount = 0;
+    m_status = NotOpened;
+}
+//------------------------------------------------------------------------------
+
+Snapshot::Status Snapshot::status() const
+{
+    return m_status;
+}
+//------------------------------------------------------------------------------
+
+bool Snapshot::verify() const
+{
+    if (m_status != Ok)
+        return false;
+
+    return fnv1a(m_data + HEADER_SIZE, m_size - HEADER_SIZE) ==
+           getU32(m_data + Header_PayloadChecksum);
+}
+//------------------------------------------------------------------------------
+
+std::size_t Snapshot::satellitesCount() const
+{
+    return m_satellitesCount;
+}
+//------------------------------------------------------------------------------
+
+std::size_t Snapshot::recordsCount() const
+{
+    return m_recordsCount;
+}
+//------------------------------------------------------------------------------
+
+std::size_t Snapshot::find(const std::string &satelliteNumber) const
+{
+    if (satelliteNumber.length() > NUMBER_LENGTH)
+        return m_satellitesCount;
+
+    // The numbers are zero-padded, so they are compared as std::string
+    unsigned char key[NUMBER_LENGTH] = {0};
+    memcpy(key, satelliteNumber.data(), satelliteNumber.length());
+
+    std::size_t begin = 0;
+    std::size_t end = m_satellitesCount;
+    while (begin < end)
+    {
+        const std::size_t middle = begin + (end - begin) / 2;
+        if (memcmp(satelliteEntry(middle) + Satellite_Number,
+                   key, NUMBER_LENGTH) < 0)
+            begin = middle + 1;
+        else
+            end = middle;
+    }
+
+    if (begin < m_satellitesCount &&
+        !memcmp(satelliteEntry(begin) + Satellite_Number, key, NUMBER_LENGTH))
+        return begin;
+
+    return m_satellitesCount;
+}
+//------------------------------------------------------------------------------
+
+std::string Snapshot::satelliteNumber(std::size_t satellite) const
+{
+    const char *number = reinterpret_cast<const char*>(
+        satelliteEntry(satellite) + Satellite_Number);
+    std::size_t length = 0;
+    while (length < NUMBER_LENGTH && number[length])
+        ++length;
+
+    return std::string(number, length);
+}
+//------------------------------------------------------------------------------
+
+std::size_t Snapshot::recordsCount(std::size_t satellite) const
+{
+    return getU32(satelliteEntry(satellite) + Satellite_RecordsCount);
+}
+//------------------------------------------------------------------------------
+
+Node Snapshot::node(std::size_t satellite, std::size_t record) const
+{
+    const unsigned char *p = Snapshot::record(satellite, record);
+    const std::size_t stringsSize = m_size - m_stringsOffset;
+    const char *strings =
+        reinterpret_cast<const char*>(m_data + m_stringsOffset);
+    std::size_t name = getU32(p + Record_Name);
+    std::size_t designator = getU32(p + Record_Designator);
+
+    Node node;
+    node.setSatelliteNumber(satelliteNumber(satellite));
+    node.setSatelliteName(name < stringsSize ? strings + name : "");
+    node.setDesignator(designator < stringsSize ? strings + designator : "");
+    node.setPreciseEpoch(getDouble(p + Record_Epoch));
+    node.set_n(getDouble(p + Record_n));
+    node.set_dn(getDouble(p + Record_dn));
+    node.set_d2n(getDouble(p + Record_d2n));
+    node.set_i(getDouble(p + Record_i));
+    node.set_Omega(getDouble(p + Record_Omega));
+    node.set_omega(getDouble(p + Record_omega));
+    node.set_M(getDouble(p + Record_M));
+    node.set_e(getDouble(p + Record_e));
+    node.set_bstar(getDouble(p + Record_bstar));
+    node.setElementNumber(static_cast<int>(getU32(p + Record_ElementNumber)));
+    node.setRevolutionNumber(
+        static_cast<int>(getU32(p + Record_RevolutionNumber)));
+    node.setClassification(static_cast<char>(p[Record_Classification]));
+    node.setEphemerisType(static_cast<char>(p[Record_EphemerisType]));
+    node.outputFormat(p[Record_FileType] == ThreeLines ? ThreeLines
+                                                       : TwoLines);
+
+    return node;
+}
+//------------------------------------------------------------------------------
+
+std::size_t Snapshot::nearestRecord(std::size_t satellite,
+                                    std::time_t t) const
+{
+    const std::size_t count = recordsCount(satellite);
+    if (!count)
+        return 0;
+
+    // The first record with not less epoch
+    std::size_t begin = 0;
+    std::size_t end = count;
+    while (begin < end)
+    {
+        const std::size_t middle = begin + (end - begin) / 2;
+        if (static_cast<std::time_t>(recordEpoch(satellite, middle)) < t)
+            begin = middle + 1;
+        else
+            end = middle;
+    }
+
+    if (begin == count)
+        return count - 1;
+
+    if (begin > 0)
+    {
+        std::time_t dtLeft =
+            t - static_cast<std::time_t>(recordEpoch(satellite, begin - 1));
+        std::time_t dtRight =
+            static_cast<std::time_t>(recordEpoch(satellite, begin)) - t;
+        if (dtLeft < dtRight)
+            --begin;
+    }
+
+    return begin;
+}
+//------------------------------------------------------------------------------
+
+bool Snapshot::nearestNode(const std::string &satelliteNumber, std::time_t t,
+                           Node &node) const
+{
+    const std::size_t satellite = find(satelliteNumber);
+    if (satellite >= m_satellitesCount || !recordsCount(satellite))
+        return false;
+
+    node = Snapshot::node(satellite, nearestRecord(satellite, t));
+    return true;
+}
+//------------------------------------------------------------------------------
+
+void Snapshot::load(std::size_t satellite, DataSet &dataSet) const
+{
+    const std::size_t count = recordsCount(satellite);
+    for (std::size_t i = 0; i < count; ++i)
+        dataSet.append(node(satellite, i));
+}
+//------------------------------------------------------------------------------
+
+void Snapshot::load(Catalog &catalog) const
+{
+    TraceSpan span("Snapshot::load");
+
+    for (std::size_t satellite = 0; satellite < m_satellitesCount; ++satellite)
+    {
+        const std::size_t count = recordsCount(satellite);
+        for (std::size_t i = 0; i < count; ++i)
+            catalog.append(node(satellite, i));
+    }
+}
+//------------------------------------------------------------------------------
+
+bool Snapshot::write(const Catalog &catalog, std::ostream &stream)
+{
+    TraceSpan span("Snapshot::write");
+
+    const std::size_t satellitesCount = catalog.size();
+    const std::size_t recordsCount = catalog.nodesCount();
+    std::vector<unsigned char> satellites(satellitesCount * SATELLITE_SIZE);
+    std::vector<unsigned char> records(recordsCount * RECORD_SIZE);
+    StringTable strings;
+
+    std::size_t satellite = 0;
+    std::size_t record = 0;
+    for (Catalog::ConstIterator it = catalog.begin(); it != catalog.end();
+         ++it, ++satellite)
+    {
+        const std::string &number = it->first;
+        const DataSet &dataSet = it->second;
+        if (number.length() > NUMBER_LENGTH)
+            return false;
+
+        unsigned char *entry = &satellites[satellite * SATELLITE_SIZE];
+        memcpy(entry + Satellite_Number, number.data(), number.length());
+        putU32(entry + Satellite_FirstRecord, record);
+        putU32(entry + Satellite_RecordsCount, dataSet.size());
+
+        for (DataSet::IndexType i = 0; i < dataSet.size(); ++i, ++record)
+            putRecord(&records[record * RECORD_SIZE], dataSet.node(i), strings);
+    }
+
+    const std::size_t satellitesOffset = HEADER_SIZE;
+    const std::size_t recordsOffset = satellitesOffset + satellites.size();
+    const std::size_t stringsOffset = recordsOffset + records.size();
+    const std::size_t size = stringsOffset + strings.data().size();
+
+    unsigned long payloadChecksum = 2166136261UL;
+    if (!satellites.empty())
+        payloadChecksum = fnv1a(&satellites[0], satellites.size(),
+                                payloadChecksum);
+    if (!records.empty())
+        payloadChecksum = fnv1a(&records[0], records.size(), payloadChecksum);
+    payloadChecksum = fnv1a(&strings.data()[0], strings.data().size(),
+                            payloadChecksum);
+
+    unsigned char header[HEADER_SIZE] = {0};
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    putU32(header + Header_Version, SNAPSHOT_VERSION);
+    putU32(header + Header_RecordSize, RECORD_SIZE);
+    putU64(header + Header_SatellitesCount, satellitesCount);
+    putU64(header + Header_RecordsCount, recordsCount);
+    putU64(header + Header_SatellitesOffset, satellitesOffset);
+    putU64(header + Header_RecordsOffset, recordsOffset);
+    putU64(header + Header_StringsOffset, stringsOffset);
+    putU64(header + Header_Size, size);
+    putU32(header + Header_PayloadChecksum, payloadChecksum);
+    putU32(header + Header_HeaderChecksum,
+           fnv1a(header, Header_HeaderChecksum));
+
+    stream.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+    if (!satellites.empty())
+        stream.write(reinterpret_cast<const char*>(&satellites[0]),
+                     satellites.size());
+    if (!records.empty())
+        stream.write(reinterpret_cast<const char*>(&records[0]),
+                     records.size());
+    stream.write(reinterpret_cast<const char*>(&strings.data()[0]),
+                 strings.data().size());
+
+    return stream.good();
+}
+//------------------------------------------------------------------------------
+
+bool Snapshot::write(const Catalog &catalog, const std::string &fileName)
+{
+    std::ofstream file(fileName.c_str(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    return write(catalog, file) && file.flush();
+}
+//------------------------------------------------------------------------------
+
+const unsigned char* Snapshot::satelliteEntry(std::size_t satellite) const
+{
+    return m_data + m_satellitesOffset + satellite * SATELLITE_SIZE;
+}
+//------------------------------------------------------------------------------
+
+const unsigned char* Snapshot::record(std::size_t satellite,
+                                      std::size_t record) const
+{
+    const std::size_t first =
+        getU32(satelliteEntry(satellite) + Satellite_FirstRecord);
+    return m_data + m_recordsOffset + (first + record) * RECORD_SIZE;
+}
+//------------------------------------------------------------------------------
+
+double Snapshot::recordEpoch(std::size_t satellite, std::size_t record) const
+{
+    return getDouble(Snapshot::record(satellite, record) + Record_Epoch);
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
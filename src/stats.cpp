@@ -0,0 +1,197 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file stats.cpp
+    \brief File contains the realization of methods of quicktle::Stats class.
+*/
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <quicktle/stats.h>
+
+namespace quicktle
+{
+
+namespace
+{
+    const char *const names[Stats::ValuesCount] =
+    {
+        "field_parses",
+        "cache_hits",
+        "records_read",
+        "dataset_searches",
+        "dataset_probes",
+        "dataset_decodes",
+        "errors_none",
+        "errors_too_short_string",
+        "errors_checksum",
+        "errors_invalid_format"
+    };
+
+    //! Counters of one thread
+    struct ThreadCounters
+    {
+        ThreadCounters();
+        ~ThreadCounters();
+
+        std::atomic<unsigned long long> values[Stats::ValuesCount];
+    };
+
+    std::mutex& registryMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    //! Counters of running threads
+    std::vector<ThreadCounters*>& registry()
+    {
+        static std::vector<ThreadCounters*> threads;
+        return threads;
+    }
+
+    //! Sum of the counters of finished threads
+    unsigned long long* retired()
+    {
+        static unsigned long long values[Stats::ValuesCount] = {0};
+        return values;
+    }
+
+    ThreadCounters::ThreadCounters()
+    {
+        for (int i = 0; i < Stats::ValuesCount; ++i)
+            values[i] = 0;
+
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().push_back(this);
+    }
+
+    ThreadCounters::~ThreadCounters()
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        std::vector<ThreadCounters*> &threads = registry();
+        for (std::size_t i = 0; i < threads.size(); ++i)
+        {
+            if (threads[i] == this)
+            {
+                threads.erase(threads.begin() + i);
+                break;
+            }
+        }
+
+        for (int i = 0; i < Stats::ValuesCount; ++i)
+            retired()[i] += values[i];
+    }
+
+    thread_local ThreadCounters t_counters;
+}
+
+Stats::Stats()
+{
+    for (int i = 0; i < ValuesCount; ++i)
+        m_values[i] = 0;
+}
+//------------------------------------------------------------------------------
+
+bool Stats::enabled()
+{
+#ifdef QUICKTLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+//------------------------------------------------------------------------------
+
+Stats Stats::collect()
+{
+    Stats res;
+    std::lock_guard<std::mutex> lock(registryMutex());
+    const std::vector<ThreadCounters*> &threads = registry();
+    for (int i = 0; i < ValuesCount; ++i)
+    {
+        res.m_values[i] = retired()[i];
+        for (std::size_t k = 0; k < threads.size(); ++k)
+            res.m_values[i] += threads[k]->values[i];
+    }
+
+    return res;
+}
+//------------------------------------------------------------------------------
+
+void Stats::reset()
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    const std::vector<ThreadCounters*> &threads = registry();
+    for (int i = 0; i < ValuesCount; ++i)
+    {
+        retired()[i] = 0;
+        for (std::size_t k = 0; k < threads.size(); ++k)
+            threads[k]->values[i] = 0;
+    }
+}
+//------------------------------------------------------------------------------
+
+void Stats::increment(Counter counter)
+{
+    t_counters.values[counter].fetch_add(1, std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+
+void Stats::error(Node::ErrorCode code)
+{
+    t_counters.values[CountersCount + code].fetch_add(
+                                                1, std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+
+unsigned long long Stats::value(Counter counter) const
+{
+    return m_values[counter];
+}
+//------------------------------------------------------------------------------
+
+unsigned long long Stats::errors(Node::ErrorCode code) const
+{
+    return m_values[CountersCount + code];
+}
+//------------------------------------------------------------------------------
+
+void Stats::print(std::ostream &stream) const
+{
+    for (int i = 0; i < ValuesCount; ++i)
+        stream << names[i] << " " << m_values[i] << std::endl;
+}
+//------------------------------------------------------------------------------
+
+void Stats::printJson(std::ostream &stream) const
+{
+    stream << "{";
+    for (int i = 0; i < ValuesCount; ++i)
+    {
+        stream << (i ? ", " : "") << "\"" << names[i] << "\": "
+               << m_values[i];
+    }
+    stream << "}";
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
@@ -26,7 +26,9 @@
 
 #include <string>
 #include <iostream>
+#include <quicktle/stats.h>
 #include <quicktle/stream.h>
+#include <quicktle/trace.h>
 
 namespace quicktle
 {
@@ -41,6 +43,8 @@ Stream::Stream(std::istream &source, const FileType fileType)
 
 Stream& Stream::operator>>(Node &node)
 {
+    TraceSpan span("Stream::read");
+
     char buf[TLE_LINE_LENGTH] = "";
 
     m_source->getline(buf, TLE_LINE_LENGTH);
@@ -58,6 +62,7 @@ Stream& Stream::operator>>(Node &node)
     {
         node.assign(line1, line2, m_enforceParsing);
     }
+    QUICKTLE_STATS_INC(RecordsRead);
 
     return *this;
 }
@@ -73,6 +78,16 @@ Stream& Stream::operator>>(DataSet &dataSet)
 }
 //------------------------------------------------------------------------------
 
+Stream& Stream::operator>>(Catalog &catalog)
+{
+    Node node;
+    operator>>(node);
+    catalog.append(node);
+
+    return *this;
+}
+//------------------------------------------------------------------------------
+
 Stream::operator bool()
 {
     if (!(*m_source) || m_source->eof())
@@ -0,0 +1,286 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file threadpool.cpp
+    \brief File contains the realization of methods
+           of quicktle::ThreadPool class.
+*/
+
+#define TASKS_PER_THREAD 8 //!< Number of ranges per thread in parallelFor
+
+#include <quicktle/threadpool.h>
+#include <quicktle/trace.h>
+
+namespace quicktle
+{
+
+namespace
+{
+    //! Pool, the current thread belongs to
+    thread_local ThreadPool *t_pool = 0;
+    //! Index of the current thread in its pool
+    thread_local std::size_t t_index = 0;
+}
+
+ThreadPool::ThreadPool(std::size_t threadsCount)
+    : m_queued(0),
+      m_pending(0),
+      m_next(0),
+      m_stop(false)
+{
+    if (!threadsCount)
+        threadsCount = std::thread::hardware_concurrency();
+    if (!threadsCount)
+        threadsCount = 1;
+
+    for (std::size_t i = 0; i < threadsCount; ++i)
+        m_queues.push_back(new Queue);
+
+    for (std::size_t i = 0; i < threadsCount; ++i)
+        m_threads.push_back(std::thread(&ThreadPool::run, this, i));
+}
+//------------------------------------------------------------------------------
+
+ThreadPool::~ThreadPool()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_taskCondition.notify_all();
+
+    for (std::size_t i = 0; i < m_threads.size(); ++i)
+        m_threads[i].join();
+
+    for (std::size_t i = 0; i < m_queues.size(); ++i)
+        delete m_queues[i];
+}
+//------------------------------------------------------------------------------
+
+std::size_t ThreadPool::threadsCount() const
+{
+    return m_threads.size();
+}
+//------------------------------------------------------------------------------
+
+std::size_t ThreadPool::currentThread() const
+{
+    return (t_pool == this) ? t_index : m_threads.size();
+}
+//------------------------------------------------------------------------------
+
+void ThreadPool::submit(const Task &task)
+{
+    // The worker puts the new task into its own queue,
+    // other threads distribute the tasks among the workers.
+    Queue *queue = (t_pool == this)
+                 ? m_queues[t_index]
+                 : m_queues[m_next++ % m_queues.size()];
+
+    ++m_pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_queued;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->tasks.push_back(task);
+    }
+    m_taskCondition.notify_one();
+}
+//------------------------------------------------------------------------------
+
+void ThreadPool::wait()
+{
+    Task task;
+    while (m_pending > 0)
+    {
+        if (takeTask(task))
+        {
+            execute(task);
+            continue;
+        }
+
+        if (t_pool == this)
+        {
+            // The worker can not sleep here: the rest tasks
+            // may be in the queues of sleeping workers.
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_pending > 0)
+            m_doneCondition.wait(lock);
+    }
+}
+//------------------------------------------------------------------------------
+
+void ThreadPool::parallelFor(std::size_t begin, std::size_t end,
+                             const Body &body, std::size_t grain)
+{
+    if (begin >= end)
+        return;
+
+    TraceSpan span("ThreadPool::parallelFor");
+
+    if (!grain)
+        grain = (end - begin) / ((threadsCount() + 1) * TASKS_PER_THREAD);
+    if (!grain)
+        grain = 1;
+
+    std::atomic<std::size_t> remaining(end - begin);
+    splitRange(begin, end, grain, body, remaining);
+
+    Task task;
+    while (remaining > 0)
+    {
+        if (takeTask(task))
+            execute(task);
+        else
+            std::this_thread::yield();
+    }
+}
+//------------------------------------------------------------------------------
+
+void ThreadPool::parallelFor(std::size_t rows, std::size_t columns,
+                             const Body2D &body, std::size_t grain)
+{
+    if (!rows || !columns)
+        return;
+
+    parallelFor(0, rows * columns,
+                [&body, columns](std::size_t index)
+                {
+                    body(index / columns, index % columns);
+                },
+                grain);
+}
+//------------------------------------------------------------------------------
+
+void ThreadPool::run(std::size_t index)
+{
+    t_pool = this;
+    t_index = index;
+
+    Task task;
+    while (true)
+    {
+        if (takeTask(task))
+        {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stop && !m_queued)
+            m_taskCondition.wait(lock);
+
+        if (m_stop && !m_queued)
+            break;
+    }
+
+    t_pool = 0;
+}
+//------------------------------------------------------------------------------
+
+bool ThreadPool::takeTask(Task &task)
+{
+    if (t_pool != this)
+        return stealTask(m_queues.size() - 1, task);
+
+    // The newest task of own queue is the most likely to be in cache
+    Queue *queue = m_queues[t_index];
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (!queue->tasks.empty())
+        {
+            task.swap(queue->tasks.back());
+            queue->tasks.pop_back();
+            --m_queued;
+            return true;
+        }
+    }
+
+    return stealTask(t_index, task);
+}
+//------------------------------------------------------------------------------
+
+bool ThreadPool::stealTask(std::size_t index, Task &task)
+{
+    const std::size_t count = m_queues.size();
+    for (std::size_t i = 1; i <= count; ++i)
+    {
+        Queue *queue = m_queues[(index + i) % count];
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (!queue->tasks.empty())
+        {
+            // The oldest task is usually the biggest part of work
+            task.swap(queue->tasks.front());
+            queue->tasks.pop_front();
+            --m_queued;
+            return true;
+        }
+    }
+
+    return false;
+}
+//------------------------------------------------------------------------------
+
+void ThreadPool::execute(Task &task)
+{
+    {
+        TraceSpan span("ThreadPool::task");
+        task();
+    }
+    task = Task();
+
+    if (--m_pending == 0)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_doneCondition.notify_all();
+    }
+}
+//------------------------------------------------------------------------------
+
+void ThreadPool::splitRange(std::size_t begin, std::size_t end,
+                            std::size_t grain, const Body &body,
+                            std::atomic<std::size_t> &remaining)
+{
+    // Leave the first half to itself and offer the second one to others
+    while (end - begin > grain)
+    {
+        const std::size_t middle = begin + (end - begin) / 2;
+        submit([this, middle, end, grain, &body, &remaining]()
+               {
+                   splitRange(middle, end, grain, body, remaining);
+               });
+        end = middle;
+    }
+
+    for (std::size_t i = begin; i < end; ++i)
+        body(i);
+
+    remaining -= end - begin;
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
@@ -0,0 +1,283 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file tolerantstream.cpp
+    \brief File contains the realization of methods
+           of quicktle::TolerantStream class.
+*/
+
+#define CHECKSUM_INDEX 68       //!< Index of checksum symbol in the TLE line
+#define SAT_NUMBER_START 2      //!< Index of the satellite number
+#define SAT_NUMBER_LENGTH 5     //!< Length of the satellite number
+
+#include <cstring>
+#include <quicktle/func.h>
+#include <quicktle/stats.h>
+#include <quicktle/tolerantstream.h>
+#include <quicktle/trace.h>
+
+namespace quicktle
+{
+
+namespace
+{
+    //! Kind of the line, detected by its prefix
+    enum LineKind
+    {
+        NameLine = 0,
+        FirstLine,
+        SecondLine
+    };
+
+    LineKind lineKind(const std::string &line)
+    {
+        if (line.size() < 2 || line[1] != ' ')
+            return NameLine;
+        if (line[0] == '1')
+            return FirstLine;
+        if (line[0] == '2')
+            return SecondLine;
+        return NameLine;
+    }
+
+    bool validLine(const std::string &line)
+    {
+        const char symbol = (line.size() > CHECKSUM_INDEX)
+                          ? line[CHECKSUM_INDEX] : 0;
+        return symbol >= '0' && symbol <= '9' &&
+               checksum(line.data(), CHECKSUM_INDEX) == symbol - '0';
+    }
+
+    bool validRecord(const std::string &first, const std::string &second)
+    {
+        return validLine(first) && validLine(second) &&
+               std::memcmp(first.data() + SAT_NUMBER_START,
+                           second.data() + SAT_NUMBER_START,
+                           SAT_NUMBER_LENGTH) == 0;
+    }
+}
+
+TolerantStream::TolerantStream(std::istream &source)
+    : m_source(&source),
+      m_enforceParsing(false),
+      m_hasLine(false),
+      m_hasName(false),
+      m_ready(false),
+      m_recordsCount(0),
+      m_brokenRecordsCount(0),
+      m_skippedLinesCount(0),
+      m_rejectedRecordsCount(0)
+{
+}
+//------------------------------------------------------------------------------
+
+TolerantStream& TolerantStream::operator>>(Node &node)
+{
+    TraceSpan span("TolerantStream::read");
+
+    if (!m_ready && !findRecord())
+        return *this;
+
+    m_ready = false;
+    if (m_hasName)
+        node.assign(m_name, m_first, m_second, m_enforceParsing);
+    else
+        node.assign(m_first, m_second, m_enforceParsing);
+    ++m_recordsCount;
+    QUICKTLE_STATS_INC(RecordsRead);
+
+    return *this;
+}
+//------------------------------------------------------------------------------
+
+TolerantStream& TolerantStream::operator>>(DataSet &dataSet)
+{
+    if (!*this)
+        return *this;
+
+    Node node;
+    operator>>(node);
+    dataSet.append(node);
+
+    return *this;
+}
+//------------------------------------------------------------------------------
+
+TolerantStream& TolerantStream::operator>>(Catalog &catalog)
+{
+    if (!*this)
+        return *this;
+
+    Node node;
+    operator>>(node);
+    catalog.append(node);
+
+    return *this;
+}
+//------------------------------------------------------------------------------
+
+TolerantStream& TolerantStream::operator>>(ColumnBatch &batch)
+{
+    TraceSpan span("TolerantStream::readColumns");
+
+    if (!m_ready && !findRecord())
+        return *this;
+
+    m_ready = false;
+    if (m_hasName)
+        batch.append(NodeView(m_name.data(), m_name.size(),
+                              m_first.data(), m_first.size(),
+                              m_second.data(), m_second.size()));
+    else
+        batch.append(NodeView(m_first.data(), m_first.size(),
+                              m_second.data(), m_second.size()));
+    ++m_recordsCount;
+    QUICKTLE_STATS_INC(RecordsRead);
+
+    return *this;
+}
+//------------------------------------------------------------------------------
+
+TolerantStream::operator bool()
+{
+    return m_ready || findRecord();
+}
+//------------------------------------------------------------------------------
+
+bool TolerantStream::enforceParsing(bool parsingMode)
+{
+    bool res = m_enforceParsing;
+    m_enforceParsing = parsingMode;
+    return res;
+}
+//------------------------------------------------------------------------------
+
+void TolerantStream::setFilter(const RecordFilter &filter)
+{
+    m_filter = filter;
+}
+//------------------------------------------------------------------------------
+
+std::size_t TolerantStream::recordsCount() const
+{
+    return m_recordsCount;
+}
+//------------------------------------------------------------------------------
+
+std::size_t TolerantStream::brokenRecordsCount() const
+{
+    return m_brokenRecordsCount;
+}
+//------------------------------------------------------------------------------
+
+std::size_t TolerantStream::skippedLinesCount() const
+{
+    return m_skippedLinesCount;
+}
+//------------------------------------------------------------------------------
+
+std::size_t TolerantStream::rejectedRecordsCount() const
+{
+    return m_rejectedRecordsCount;
+}
+//------------------------------------------------------------------------------
+
+bool TolerantStream::readLine(std::string &line)
+{
+    while (std::getline(*m_source, line))
+    {
+        std::size_t length = line.size();
+        while (length && (line[length - 1] == '\r' ||
+                          line[length - 1] == ' ' ||
+                          line[length - 1] == '\t'))
+            --length;
+        if (!length)
+            continue;
+
+        line.resize(length);
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+
+bool TolerantStream::findRecord()
+{
+    m_hasName = false;
+    while (m_hasLine || readLine(m_line))
+    {
+        m_hasLine = false;
+        const LineKind kind = lineKind(m_line);
+        if (kind == NameLine)
+        {
+            // Only the last of several name lines belongs to the record
+            m_skippedLinesCount += (m_hasName ? 1 : 0);
+            m_name.swap(m_line);
+            m_hasName = true;
+            continue;
+        }
+
+        const std::size_t linesCount = (m_hasName ? 2 : 1);
+        m_hasName = false;
+        if (kind == SecondLine)
+        {
+            m_skippedLinesCount += linesCount;
+            continue;
+        }
+
+        m_first.swap(m_line);
+        const bool read = readLine(m_line);
+        if (!read || lineKind(m_line) != SecondLine)
+        {
+            // The line, which breaks the record, may start the next one
+            ++m_brokenRecordsCount;
+            m_skippedLinesCount += linesCount;
+            m_hasLine = read;
+            continue;
+        }
+
+        m_second.swap(m_line);
+        if (!validRecord(m_first, m_second))
+        {
+            ++m_brokenRecordsCount;
+            m_skippedLinesCount += linesCount + 1;
+            continue;
+        }
+
+        if (!m_filter.empty() &&
+            !m_filter.accept(NodeView(m_first.data(), m_first.size(),
+                                      m_second.data(), m_second.size())))
+        {
+            ++m_rejectedRecordsCount;
+            continue;
+        }
+
+        m_hasName = (linesCount == 2);
+        m_ready = true;
+        return true;
+    }
+
+    m_skippedLinesCount += (m_hasName ? 1 : 0);
+    m_hasName = false;
+    return false;
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
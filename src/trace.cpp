@@ -0,0 +1,217 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file trace.cpp
+    \brief File contains the realization of methods
+           of quicktle::Trace and quicktle::TraceSpan classes.
+*/
+
+#define DEFAULT_BUFFER_SIZE (1 << 16) //!< Default number of spans per thread
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <quicktle/trace.h>
+
+namespace quicktle
+{
+
+namespace
+{
+    struct Span
+    {
+        const char *name;
+        long long start;    // ns
+        long long duration; // ns
+    };
+
+    //! Ring buffer of spans of one thread
+    struct ThreadBuffer
+    {
+        std::vector<Span> spans;
+        std::size_t next;
+        std::size_t count;
+        unsigned int threadId;
+        bool finished;
+    };
+
+    std::mutex& registryMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::vector<ThreadBuffer*>& registry()
+    {
+        static std::vector<ThreadBuffer*> buffers;
+        return buffers;
+    }
+
+    std::atomic<std::size_t> g_bufferSize(DEFAULT_BUFFER_SIZE);
+    std::atomic<unsigned int> g_nextThreadId(1);
+
+    //! Buffer of the current thread. The buffer outlives the thread.
+    struct ThreadHandle
+    {
+        ThreadHandle() : buffer(0) {}
+        ~ThreadHandle()
+        {
+            if (!buffer)
+                return;
+
+            std::lock_guard<std::mutex> lock(registryMutex());
+            buffer->finished = true;
+        }
+
+        ThreadBuffer *buffer;
+    };
+
+    thread_local ThreadHandle t_handle;
+
+    ThreadBuffer* threadBuffer()
+    {
+        if (t_handle.buffer)
+            return t_handle.buffer;
+
+        ThreadBuffer *buffer = new ThreadBuffer;
+        buffer->spans.resize(g_bufferSize > 0 ? g_bufferSize.load() : 1);
+        buffer->next = 0;
+        buffer->count = 0;
+        buffer->threadId = g_nextThreadId++;
+        buffer->finished = false;
+
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().push_back(buffer);
+        t_handle.buffer = buffer;
+
+        return buffer;
+    }
+
+    long long now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void writeString(std::ostream &stream, const char *str)
+    {
+        stream << '"';
+        for (; *str; ++str)
+        {
+            if (*str == '"' || *str == '\\')
+                stream << '\\';
+            stream << *str;
+        }
+        stream << '"';
+    }
+}
+
+std::atomic<bool> Trace::s_enabled(false);
+
+void Trace::enable(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+
+void Trace::setBufferSize(std::size_t spansCount)
+{
+    g_bufferSize = spansCount;
+}
+//------------------------------------------------------------------------------
+
+void Trace::clear()
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    std::vector<ThreadBuffer*> &buffers = registry();
+    for (std::size_t i = 0; i < buffers.size(); )
+    {
+        buffers[i]->next = 0;
+        buffers[i]->count = 0;
+        if (buffers[i]->finished)
+        {
+            delete buffers[i];
+            buffers.erase(buffers.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+bool Trace::write(std::ostream &stream)
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    const std::vector<ThreadBuffer*> &buffers = registry();
+
+    stream << "{\"traceEvents\":[";
+    bool first = true;
+    for (std::size_t i = 0; i < buffers.size(); ++i)
+    {
+        const ThreadBuffer &buffer = *buffers[i];
+        const std::size_t size = buffer.spans.size();
+        // The oldest span is the first one until the buffer is full
+        std::size_t index = (buffer.count < size) ? 0 : buffer.next;
+        for (std::size_t k = 0; k < buffer.count;
+             ++k, index = (index + 1) % size)
+        {
+            const Span &span = buffer.spans[index];
+            stream << (first ? "\n" : ",\n") << "{\"name\":";
+            writeString(stream, span.name);
+            stream << ",\"cat\":\"quicktle\",\"ph\":\"X\",\"pid\":1"
+                   << ",\"tid\":" << buffer.threadId
+                   << ",\"ts\":" << span.start / 1000 << "."
+                   << (span.start % 1000) / 100
+                   << ",\"dur\":" << span.duration / 1000 << "."
+                   << (span.duration % 1000) / 100 << "}";
+            first = false;
+        }
+    }
+    stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+    return stream.good();
+}
+//------------------------------------------------------------------------------
+
+void TraceSpan::start(const char *name)
+{
+    m_name = name;
+    m_start = now();
+}
+//------------------------------------------------------------------------------
+
+void TraceSpan::finish()
+{
+    const long long end = now();
+    ThreadBuffer *buffer = threadBuffer();
+    Span &span = buffer->spans[buffer->next];
+    span.name = m_name;
+    span.start = m_start;
+    span.duration = end - m_start;
+
+    buffer->next = (buffer->next + 1) % buffer->spans.size();
+    if (buffer->count < buffer->spans.size())
+        ++buffer->count;
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
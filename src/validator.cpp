@@ -0,0 +1,408 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file validator.cpp
+    \brief File contains the realization of methods
+           of quicktle::Validator class.
+*/
+
+#define CHECKSUM_INDEX 68        //!< Index of checksum symbol in the TLE line
+#define DEFAULT_MAX_ERRORS 1000  //!< Default number of stored errors
+#define READ_BUFFER_SIZE (1 << 20)
+
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <quicktle/func.h>
+#include <quicktle/trace.h>
+#include <quicktle/validator.h>
+
+namespace quicktle
+{
+
+namespace
+{
+    //! Format of a numeric column
+    enum ColumnFormat
+    {
+        Digits,    //!< Digits only, e.g. eccentricity "0012107"
+        Integer,   //!< Right aligned integer, e.g. " 394"
+        Real,      //!< Number with optional point, e.g. "-.00000123"
+        Exponent,  //!< Assumed point and exponent, e.g. " 31166-3"
+        Character  //!< Letter, digit or space
+    };
+
+    struct Column
+    {
+        std::size_t start;
+        std::size_t length;
+        ColumnFormat format;
+    };
+
+    //! Columns of the first line of a record ("1 ...")
+    const Column LINE1_COLUMNS[] =
+    {
+        {2, 5, Integer},   // satellite number
+        {7, 1, Character}, // classification
+        {18, 14, Real},    // epoch
+        {33, 10, Real},    // first derivative of mean motion
+        {44, 8, Exponent}, // second derivative of mean motion
+        {53, 8, Exponent}, // BSTAR drag term
+        {62, 1, Character},// ephemeris type
+        {64, 4, Integer}   // element number
+    };
+
+    //! Columns of the second line of a record ("2 ...")
+    const Column LINE2_COLUMNS[] =
+    {
+        {2, 5, Integer},   // satellite number
+        {8, 8, Real},      // inclination
+        {17, 8, Real},     // right ascension of the ascending node
+        {26, 7, Digits},   // eccentricity
+        {34, 8, Real},     // argument of perigee
+        {43, 8, Real},     // mean anomaly
+        {52, 11, Real},    // mean motion
+        {63, 5, Integer}   // revolution number
+    };
+
+    bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    //! Check the column and return the offset of invalid symbol or -1
+    int checkColumn(const char *str, const Column &column)
+    {
+        const char *begin = str + column.start;
+        const char *end = begin + column.length;
+        const char *p = begin;
+
+        if (column.format == Character)
+            return (*p == ' ' || isDigit(*p) ||
+                    isalpha(static_cast<unsigned char>(*p))) ? -1 : 0;
+
+        if (column.format == Digits)
+        {
+            for (; p < end; ++p)
+            {
+                if (!isDigit(*p))
+                    return p - begin;
+            }
+            return -1;
+        }
+
+        while (p < end && *p == ' ')
+            ++p;
+        if (p < end && (*p == '-' || *p == '+'))
+            ++p;
+
+        std::size_t digits = 0;
+        bool point = false;
+        for (; p < end; ++p)
+        {
+            if (isDigit(*p))
+                ++digits;
+            else if (*p == '.' && column.format == Real && !point)
+                point = true;
+            else
+                break;
+        }
+        if (!digits)
+            return p - begin;
+
+        if (column.format == Exponent)
+        {
+            if (p + 1 >= end || (*p != '-' && *p != '+') || !isDigit(p[1]))
+                return p - begin;
+            p += 2;
+        }
+
+        for (; p < end; ++p)
+        {
+            if (*p != ' ')
+                return p - begin;
+        }
+
+        return -1;
+    }
+}
+
+Validator::Validator(const FileType fileType)
+    : m_fileType(fileType),
+      m_maxErrors(DEFAULT_MAX_ERRORS)
+{
+    reset();
+}
+//------------------------------------------------------------------------------
+
+void Validator::setMaxErrors(std::size_t count)
+{
+    m_maxErrors = count;
+}
+//------------------------------------------------------------------------------
+
+bool Validator::scan(const char *data, std::size_t size)
+{
+    TraceSpan span("Validator::scan");
+
+    reset();
+    feed(data, size);
+    finish();
+
+    return !m_invalidRecordsCount;
+}
+//------------------------------------------------------------------------------
+
+bool Validator::scan(std::istream &stream)
+{
+    TraceSpan span("Validator::scan");
+
+    reset();
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    while (stream)
+    {
+        stream.read(&buffer[0], buffer.size());
+        feed(&buffer[0], static_cast<std::size_t>(stream.gcount()));
+    }
+    finish();
+
+    return !m_invalidRecordsCount && !stream.bad();
+}
+//------------------------------------------------------------------------------
+
+bool Validator::scanFile(const std::string &fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!file)
+    {
+        reset();
+        return false;
+    }
+
+    return scan(file);
+}
+//------------------------------------------------------------------------------
+
+std::size_t Validator::recordsCount() const
+{
+    return m_recordsCount;
+}
+//------------------------------------------------------------------------------
+
+std::size_t Validator::invalidRecordsCount() const
+{
+    return m_invalidRecordsCount;
+}
+//------------------------------------------------------------------------------
+
+const std::vector<Validator::Error>& Validator::errors() const
+{
+    return m_errors;
+}
+//------------------------------------------------------------------------------
+
+const char* Validator::issueName(Issue issue)
+{
+    static const char *names[IssuesCount] =
+    {
+        "too short line",
+        "invalid line number",
+        "checksum mismatch",
+        "invalid field",
+        "satellite number mismatch",
+        "incomplete record",
+        "too long line"
+    };
+
+    return (issue >= 0 && issue < IssuesCount) ? names[issue] : "";
+}
+//------------------------------------------------------------------------------
+
+void Validator::print(std::ostream &stream) const
+{
+    for (std::size_t i = 0; i < m_errors.size(); ++i)
+    {
+        stream << "line " << m_errors[i].line
+               << ", column " << m_errors[i].column
+               << ": " << issueName(m_errors[i].issue) << std::endl;
+    }
+    stream << m_invalidRecordsCount << " of " << m_recordsCount
+           << " records are invalid" << std::endl;
+}
+//------------------------------------------------------------------------------
+
+void Validator::reset()
+{
+    m_errors.clear();
+    m_partialLine.clear();
+    memset(m_satelliteNumber, 0, sizeof(m_satelliteNumber));
+    m_lineNumber = 0;
+    m_position = 0;
+    m_recordsCount = 0;
+    m_invalidRecordsCount = 0;
+    m_recordIsValid = true;
+}
+//------------------------------------------------------------------------------
+
+void Validator::feed(const char *data, std::size_t size)
+{
+    const char *end = data + size;
+    while (data < end)
+    {
+        const char *newline =
+            static_cast<const char*>(memchr(data, '\n', end - data));
+        if (!newline)
+        {
+            // The line is continued in the next block
+            m_partialLine.append(data, end);
+            return;
+        }
+
+        if (m_partialLine.empty())
+        {
+            checkLine(data, newline - data);
+        }
+        else
+        {
+            m_partialLine.append(data, newline);
+            checkLine(m_partialLine.data(), m_partialLine.length());
+            m_partialLine.clear();
+        }
+        data = newline + 1;
+    }
+}
+//------------------------------------------------------------------------------
+
+void Validator::finish()
+{
+    if (!m_partialLine.empty())
+    {
+        checkLine(m_partialLine.data(), m_partialLine.length());
+        m_partialLine.clear();
+    }
+
+    if (m_position)
+    {
+        addError(1, IncompleteRecord);
+        ++m_recordsCount;
+        ++m_invalidRecordsCount;
+        m_position = 0;
+    }
+}
+//------------------------------------------------------------------------------
+
+void Validator::checkLine(const char *line, std::size_t length)
+{
+    ++m_lineNumber;
+    if (length && line[length - 1] == '\r')
+        --length;
+
+    if (!m_position)
+    {
+        // Empty lines between the records are skipped
+        if (!length)
+            return;
+        m_recordIsValid = true;
+    }
+
+    const std::size_t linesCount = (m_fileType == ThreeLines) ? 3 : 2;
+    const std::size_t dataLine = m_position + 2 - linesCount;
+    // The satellite name is not checked
+    if (m_position + 2 >= linesCount)
+        checkDataLine(line, length, dataLine ? '2' : '1');
+
+    if (++m_position == linesCount)
+    {
+        ++m_recordsCount;
+        if (!m_recordIsValid)
+            ++m_invalidRecordsCount;
+        m_position = 0;
+    }
+}
+//------------------------------------------------------------------------------
+
+void Validator::checkDataLine(const char *line, std::size_t length,
+                              char number)
+{
+    if (number == '1')
+        m_satelliteNumber[0] = 0;
+
+    if (length < 2 || line[0] != number || line[1] != ' ')
+    {
+        addError(1, InvalidLineNumber);
+        return;
+    }
+
+    if (length < CHECKSUM_INDEX + 1)
+    {
+        addError(length + 1, TooShortLine);
+        return;
+    }
+
+    if (length > CHECKSUM_INDEX + 1)
+    {
+        addError(CHECKSUM_INDEX + 2, TooLongLine);
+        return;
+    }
+
+    if (!isDigit(line[CHECKSUM_INDEX]) ||
+        checksum(line, CHECKSUM_INDEX) != line[CHECKSUM_INDEX] - '0')
+    {
+        addError(CHECKSUM_INDEX + 1, ChecksumMismatch);
+        return;
+    }
+
+    const Column *columns = (number == '1') ? LINE1_COLUMNS : LINE2_COLUMNS;
+    const std::size_t count = (number == '1')
+                            ? sizeof(LINE1_COLUMNS) / sizeof(Column)
+                            : sizeof(LINE2_COLUMNS) / sizeof(Column);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        int offset = checkColumn(line, columns[i]);
+        if (offset >= 0)
+        {
+            addError(columns[i].start + offset + 1, InvalidField);
+            return;
+        }
+    }
+
+    if (number == '1')
+        memcpy(m_satelliteNumber, line + 2, sizeof(m_satelliteNumber));
+    else if (m_satelliteNumber[0] &&
+             memcmp(m_satelliteNumber, line + 2, sizeof(m_satelliteNumber)))
+        addError(3, SatelliteNumberMismatch);
+}
+//------------------------------------------------------------------------------
+
+void Validator::addError(std::size_t column, Issue issue)
+{
+    m_recordIsValid = false;
+    if (m_errors.size() >= m_maxErrors)
+        return;
+
+    Error error;
+    error.line = m_lineNumber;
+    error.column = column;
+    error.issue = issue;
+    m_errors.push_back(error);
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
@@ -23,6 +23,25 @@
 #include "test_node.h"
 #include "test_stream.h"
 #include "test_dataset.h"
+#include "test_threadpool.h"
+#include "test_generator.h"
+#include "test_stats.h"
+#include "test_trace.h"
+#include "test_validator.h"
+#include "test_catalog.h"
+#include "test_snapshot.h"
+#include "test_sharedcatalog.h"
+#include "test_cataloghandle.h"
+#include "test_nodeview.h"
+#include "test_archiveindex.h"
+#include "test_archivesorter.h"
+#include "test_history.h"
+#include "test_compressedinput.h"
+#include "test_pipelinedstream.h"
+#include "test_bulkreader.h"
+#include "test_tolerantstream.h"
+#include "test_recordfilter.h"
+#include "test_columnbatch.h"
 
 /**
   function: main
@@ -0,0 +1,214 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/archiveindex.h>
+#include <quicktle/archivereader.h>
+#include <quicktle/generator.h>
+#include <utime.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(ArchiveIndexTest, scan)
+{
+    Generator generator(11);
+    generator.setSatellitesCount(30);
+    generator.setEpochsCount(5);
+    generator.setFileType(ThreeLines);
+    std::ostringstream out;
+    generator.write(out);
+    // Windows line endings and empty lines between the records
+    const std::string text = "\r\n" + out.str();
+
+    ArchiveIndex index(ThreeLines);
+    std::istringstream in(text);
+    EXPECT_EQ(150, index.scan(in));
+    EXPECT_EQ(0, index.skippedCount());
+    EXPECT_EQ(text.length(), index.archiveSize());
+
+    for (std::size_t i = 0; i < index.size(); ++i)
+    {
+        const ArchiveIndex::Entry &entry = index.entries()[i];
+        std::istringstream record(text.substr(entry.offset));
+        std::string line1, line2, line3;
+        std::getline(record, line1);
+        std::getline(record, line2);
+        std::getline(record, line3);
+        Node node(line1, line2, line3);
+
+        EXPECT_EQ(node.satelliteNumber(), std::string(entry.satelliteNumber));
+        EXPECT_EQ(node.preciseEpoch(), entry.epoch);
+        if (i)
+        {
+            // Ordered by satellite number, then by epoch
+            const ArchiveIndex::Entry &previous = index.entries()[i - 1];
+            const int order = std::string(previous.satelliteNumber).compare(
+                                                      entry.satelliteNumber);
+            EXPECT_TRUE(order < 0 || (!order && previous.epoch < entry.epoch));
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(ArchiveIndexTest, write)
+{
+    const std::string text =
+        "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927\n"
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537\n"
+        "1 2554\n"
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+
+    ArchiveIndex index;
+    EXPECT_EQ(1, index.scan(text.data(), text.length()));
+    EXPECT_EQ(1, index.skippedCount());
+    EXPECT_EQ("25544", std::string(index.entries()[0].satelliteNumber));
+    EXPECT_EQ(0, index.entries()[0].offset);
+
+    std::ostringstream out;
+    EXPECT_TRUE(index.write(out));
+    EXPECT_EQ(56 + 24, out.str().length());
+    EXPECT_EQ("QTLEINDX", out.str().substr(0, 8));
+    EXPECT_EQ("archive.tle.qtx", ArchiveIndex::fileName("archive.tle"));
+
+    ArchiveIndex copy;
+    std::istringstream in(out.str());
+    EXPECT_TRUE(copy.read(in));
+    EXPECT_EQ(1, copy.size());
+    EXPECT_EQ(TwoLines, copy.fileType());
+    EXPECT_EQ(text.length(), copy.archiveSize());
+    EXPECT_EQ(index.archiveFingerprint(), copy.archiveFingerprint());
+    std::istringstream archive(text);
+    EXPECT_EQ(ArchiveIndex::fingerprint(archive), copy.archiveFingerprint());
+    EXPECT_EQ(index.entries()[0].epoch, copy.entries()[0].epoch);
+
+    // Damaged payload
+    std::string damaged = out.str();
+    damaged[damaged.length() - 1] ^= 1;
+    std::istringstream damagedIn(damaged);
+    EXPECT_FALSE(copy.read(damagedIn));
+    EXPECT_EQ(0, copy.size());
+}
+//------------------------------------------------------------------------------
+
+TEST(ArchiveIndexTest, reader)
+{
+    Generator generator(12);
+    generator.setSatellitesCount(20);
+    generator.setEpochsCount(10);
+    generator.setEpochStep(3600);
+    generator.setFileType(ThreeLines);
+    const std::string archiveName = "test_archive.tle";
+    ASSERT_TRUE(generator.write(archiveName));
+    std::remove(ArchiveIndex::fileName(archiveName).c_str());
+
+    const Node first = generator.node(7, 0);
+    const std::string number = first.satelliteNumber();
+    const double t0 = first.preciseEpoch();
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        // The index is built at the first pass and read at the second one
+        ArchiveReader reader;
+        ASSERT_TRUE(reader.open(archiveName, ThreeLines));
+        EXPECT_EQ(200, reader.index().size());
+
+        DataSet dataSet;
+        EXPECT_EQ(4, reader.read(number, t0 + 2.5 * 3600, t0 + 6.5 * 3600,
+                                 dataSet));
+        ASSERT_EQ(4, dataSet.size());
+        for (std::size_t i = 0; i < dataSet.size(); ++i)
+        {
+            const Node expected = generator.node(7, i + 3);
+            EXPECT_EQ(number, dataSet.node(i).satelliteNumber());
+            EXPECT_EQ(expected.preciseEpoch(), dataSet.node(i).preciseEpoch());
+            EXPECT_EQ(expected.satelliteName(),
+                      dataSet.node(i).satelliteName());
+        }
+
+        DataSet empty;
+        EXPECT_EQ(0, reader.read("99999", 0, 1e10, empty));
+    }
+
+    std::remove(ArchiveIndex::fileName(archiveName).c_str());
+    std::remove(archiveName.c_str());
+}
+//------------------------------------------------------------------------------
+
+TEST(ArchiveIndexTest, editedArchive)
+{
+    Generator generator(13);
+    generator.setSatellitesCount(10);
+    generator.setEpochsCount(3);
+    generator.setFileType(TwoLines);
+    std::ostringstream out;
+    generator.write(out);
+    const std::string text = out.str();
+    const std::string archiveName = "test_edited.tle";
+    std::remove(ArchiveIndex::fileName(archiveName).c_str());
+    {
+        std::ofstream file(archiveName.c_str(), std::ios::binary);
+        file << text;
+    }
+    {
+        ArchiveReader reader;
+        ASSERT_TRUE(reader.open(archiveName, TwoLines));
+        EXPECT_EQ(ArchiveIndex::fileTime(archiveName),
+                  reader.index().archiveTime());
+    }
+
+    // The records of 140 bytes are reversed: the size and the modification
+    // time are kept, the offsets are changed
+    std::vector<std::string> records;
+    for (std::size_t offset = 0; offset < text.length(); offset += 140)
+        records.push_back(text.substr(offset, 140));
+    ASSERT_EQ(30, records.size());
+    std::reverse(records.begin(), records.end());
+    struct utimbuf times;
+    times.actime = times.modtime =
+        static_cast<time_t>(ArchiveIndex::fileTime(archiveName));
+    {
+        std::ofstream file(archiveName.c_str(), std::ios::binary);
+        for (std::size_t i = 0; i < records.size(); ++i)
+            file << records[i];
+    }
+    ASSERT_EQ(0, utime(archiveName.c_str(), &times));
+
+    const Node expected = generator.node(4, 1);
+    ArchiveReader reader;
+    ASSERT_TRUE(reader.open(archiveName, TwoLines));
+    DataSet dataSet;
+    EXPECT_EQ(1, reader.read(expected.satelliteNumber(),
+                             expected.preciseEpoch(), expected.preciseEpoch(),
+                             dataSet));
+    ASSERT_EQ(1, dataSet.size());
+    EXPECT_EQ(expected.satelliteNumber(), dataSet.node(0).satelliteNumber());
+    EXPECT_EQ(expected.preciseEpoch(), dataSet.node(0).preciseEpoch());
+
+    std::remove(ArchiveIndex::fileName(archiveName).c_str());
+    std::remove(archiveName.c_str());
+}
+//------------------------------------------------------------------------------
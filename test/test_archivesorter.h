@@ -0,0 +1,171 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/archivesorter.h>
+#include <quicktle/generator.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(ArchiveSorterTest, sort)
+{
+    Generator generator(13);
+    generator.setSatellitesCount(50);
+    generator.setEpochsCount(20);
+    generator.setFileType(ThreeLines);
+
+    // Records in reverse order, the first 100 ones are duplicated
+    // with other names, one record is broken
+    std::string line1, line2, line3;
+    std::ofstream input1("test_sort1.tle"), input2("test_sort2.tle");
+    for (std::size_t i = 1000; i-- > 0;)
+    {
+        generator.record(i % 50, i / 50, line1, line2, line3);
+        input1 << line1 << "\r\n" << line2 << "\r\n" << line3 << "\r\n";
+        if (i < 100)
+            input2 << "DUPLICATE\n" << line2 << "\n" << line3 << "\n\n";
+    }
+    input2 << "BROKEN\n1 2554\n2 25544\n";
+    input1.close();
+    input2.close();
+
+    std::vector<std::string> inputs;
+    inputs.push_back("test_sort1.tle");
+    inputs.push_back("test_sort2.tle");
+    ArchiveSorter sorter(ThreeLines);
+    sorter.setMemoryLimit(4096);
+    sorter.setThreadsCount(2);
+    sorter.setTemporaryDirectory(".");
+    std::ostringstream output;
+    EXPECT_TRUE(sorter.sort(inputs, output));
+    EXPECT_EQ(1000, sorter.recordsCount());
+    EXPECT_EQ(100, sorter.duplicatesCount());
+    EXPECT_EQ(1, sorter.skippedCount());
+    // Several merge passes are needed
+    EXPECT_LT(64, sorter.runsCount());
+
+    std::ostringstream expected;
+    for (std::size_t satellite = 0; satellite < 50; ++satellite)
+    {
+        for (std::size_t epoch = 0; epoch < 20; ++epoch)
+        {
+            generator.record(satellite, epoch, line1, line2, line3);
+            expected << line1 << "\n" << line2 << "\n" << line3 << "\n";
+        }
+    }
+    EXPECT_EQ(expected.str(), output.str());
+
+    // Nodes
+    std::vector<Node> nodes;
+    EXPECT_TRUE(sorter.sort(inputs,
+                            [&nodes](const Node &node)
+                            {
+                                nodes.push_back(node);
+                            }));
+    ASSERT_EQ(1000, nodes.size());
+    EXPECT_EQ(generator.node(0, 0).satelliteName(), nodes[0].satelliteName());
+    EXPECT_EQ(generator.node(49, 19).preciseEpoch(),
+              nodes[999].preciseEpoch());
+
+    std::remove("test_sort1.tle");
+    std::remove("test_sort2.tle");
+}
+//------------------------------------------------------------------------------
+
+TEST(ArchiveSorterTest, stream)
+{
+    const std::string line2 =
+        "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+    const std::string line3 =
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+    const std::string line4 =
+        "1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753";
+    const std::string line5 =
+        "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667";
+
+    std::istringstream input(line2 + "\n" + line3 + "\n" +
+                             line4 + "\n" + line5 + "\n");
+    std::ostringstream output;
+    ArchiveSorter sorter;
+    EXPECT_TRUE(sorter.sort(input, output));
+    EXPECT_EQ(2, sorter.recordsCount());
+    EXPECT_EQ(1, sorter.runsCount());
+    EXPECT_EQ(line4 + "\n" + line5 + "\n" + line2 + "\n" + line3 + "\n",
+              output.str());
+
+    // Not padded numbers are ordered numerically: "5" < "25544"
+    // (the spaces and the zeros give the same checksum)
+    std::string unpadded4 = line4, unpadded5 = line5;
+    unpadded4.replace(2, 5, "    5");
+    unpadded5.replace(2, 5, "    5");
+    std::istringstream unpadded(line2 + "\n" + line3 + "\n" +
+                                unpadded4 + "\n" + unpadded5 + "\n");
+    output.str(std::string());
+    EXPECT_TRUE(sorter.sort(unpadded, output));
+    EXPECT_EQ(unpadded4 + "\n" + unpadded5 + "\n" +
+              line2 + "\n" + line3 + "\n", output.str());
+
+    std::vector<std::string> missing(1, "missing.tle");
+    EXPECT_FALSE(sorter.sort(missing, output));
+}
+//------------------------------------------------------------------------------
+
+TEST(ArchiveSorterTest, brokenDuplicate)
+{
+    const std::string line2 =
+        "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+    const std::string line3 =
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+    std::string broken = line3;
+    broken[68] = '0';
+
+    // The broken copy goes first, the valid one must be kept
+    {
+        std::ofstream input("test_broken.tle");
+        input << line2 << "\n" << broken << "\n"
+              << line2 << "\n" << line3 << "\n";
+    }
+
+    std::vector<Node> nodes;
+    ArchiveSorter sorter;
+    sorter.setTemporaryDirectory(".");
+    EXPECT_TRUE(sorter.sort(std::vector<std::string>(1, "test_broken.tle"),
+                            [&nodes](const Node &node)
+                            {
+                                nodes.push_back(node);
+                            }));
+    ASSERT_EQ(1, nodes.size());
+    EXPECT_EQ(1, sorter.skippedCount());
+    EXPECT_EQ(0, sorter.duplicatesCount());
+    std::ostringstream out;
+    out << nodes[0];
+    EXPECT_EQ(line2 + "\n" + line3 + "\n", out.str());
+
+    std::remove("test_broken.tle");
+}
+//------------------------------------------------------------------------------
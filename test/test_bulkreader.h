@@ -0,0 +1,212 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/bulkreader.h>
+#include <quicktle/generator.h>
+#include <quicktle/stream.h>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(BulkReaderTest, read)
+{
+    // One file per satellite, the last file is empty
+    std::vector<std::string> fileNames;
+    Catalog expected;
+    for (int satellite = 0; satellite < 30; ++satellite)
+    {
+        Generator generator(satellite);
+        generator.setSatellitesCount(1);
+        generator.setEpochsCount(satellite % 7);
+        generator.setFirstSatelliteNumber(30000 + satellite);
+        generator.setFileType(ThreeLines);
+        std::ostringstream text;
+        generator.write(text);
+
+        std::istringstream source(text.str());
+        Stream stream(source, ThreeLines);
+        while (stream)
+            stream >> expected;
+
+        std::string data = text.str();
+        if (satellite == 3)
+        {
+            // CRLF and empty lines
+            std::string crlf;
+            for (std::size_t i = 0; i < data.size(); ++i)
+                crlf += (data[i] == '\n') ? "\r\n\n" : std::string(1, data[i]);
+            data = crlf;
+        }
+
+        std::ostringstream name;
+        name << "test_bulk_" << satellite << ".tle";
+        fileNames.push_back(name.str());
+        std::ofstream file(name.str().c_str(), std::ios_base::binary);
+        file << data;
+    }
+    ASSERT_EQ(85, expected.nodesCount());
+
+    const BulkReader::Method methods[] = {BulkReader::IoUring,
+                                          BulkReader::Pread};
+    for (std::size_t k = 0; k < 2; ++k)
+    {
+        if (methods[k] == BulkReader::IoUring &&
+            !BulkReader::ioUringAvailable())
+            continue;
+
+        BulkReader reader(ThreeLines);
+        reader.setMethod(methods[k]);
+        reader.setThreadsCount(3);
+        reader.setQueueDepth(4);
+        Catalog catalog;
+        ASSERT_TRUE(reader.read(fileNames, catalog));
+        EXPECT_EQ(methods[k], reader.usedMethod());
+        EXPECT_EQ(85, reader.recordsCount());
+        EXPECT_EQ(0, reader.failedCount());
+
+        ASSERT_EQ(expected.size(), catalog.size());
+        Catalog::ConstIterator it = catalog.begin();
+        for (Catalog::ConstIterator e = expected.begin(); e != expected.end();
+             ++e, ++it)
+        {
+            EXPECT_EQ(e->first, it->first);
+            ASSERT_EQ(e->second.size(), it->second.size());
+            for (DataSet::IndexType i = 0; i < e->second.size(); ++i)
+            {
+                EXPECT_EQ(e->second.node(i).preciseEpoch(),
+                          it->second.node(i).preciseEpoch());
+                EXPECT_EQ(e->second.node(i).M(), it->second.node(i).M());
+                EXPECT_EQ(e->second.node(i).satelliteName(),
+                          it->second.node(i).satelliteName());
+            }
+        }
+    }
+
+    // The missing file is reported, the rest is read
+    fileNames.push_back("test_bulk_absent.tle");
+    BulkReader reader(ThreeLines);
+    Catalog catalog;
+    EXPECT_FALSE(reader.read(fileNames, catalog));
+    EXPECT_EQ(1, reader.failedCount());
+    EXPECT_EQ(85, catalog.nodesCount());
+
+    for (std::size_t i = 0; i < fileNames.size(); ++i)
+        std::remove(fileNames[i].c_str());
+}
+//------------------------------------------------------------------------------
+
+#ifndef _WIN32
+TEST(BulkReaderTest, readDirectory)
+{
+    // The files share the satellites and the epochs: the nodes of the
+    // later files should replace the ones of the earlier files
+    const std::string directory = "test_bulk_dir";
+    mkdir(directory.c_str(), 0755);
+    mkdir((directory + "/subdir").c_str(), 0755);
+    std::ofstream((directory + "/.hidden").c_str()) << "garbage\n";
+
+    std::vector<std::string> fileNames;
+    Catalog expected;
+    std::size_t recordsCount = 0;
+    Generator generator(5);
+    generator.setSatellitesCount(20);
+    generator.setEpochsCount(4);
+    std::ostringstream generated;
+    generator.write(generated);
+
+    for (int k = 0; k < 6; ++k)
+    {
+        // Every file contains the part of the catalog with its own M
+        std::istringstream source(generated.str());
+        Stream stream(source);
+        std::ostringstream text;
+        for (int i = 0; stream; ++i)
+        {
+            Node node;
+            stream >> node;
+            if ((i + k) % 3 == 0)
+                continue;
+
+            node.set_M(0.5 * k + 0.25);
+            text << node;
+            ++recordsCount;
+        }
+
+        std::istringstream written(text.str());
+        Stream check(written);
+        while (check)
+            check >> expected;
+
+        std::ostringstream name;
+        name << directory << "/part_" << k << ".tle";
+        fileNames.push_back(name.str());
+        std::ofstream file(name.str().c_str(), std::ios_base::binary);
+        file << text.str();
+    }
+    ASSERT_LT(expected.nodesCount(), recordsCount);
+
+    std::vector<std::string> listed;
+    ASSERT_TRUE(BulkReader::listDirectory(directory, listed));
+    EXPECT_TRUE(listed == fileNames);
+
+    BulkReader reader;
+    reader.setThreadsCount(4);
+    reader.setMethod(BulkReader::Pread);
+    Catalog catalog;
+    ASSERT_TRUE(reader.readDirectory(directory + "/", catalog));
+    EXPECT_EQ(recordsCount, reader.recordsCount());
+
+    ASSERT_EQ(expected.size(), catalog.size());
+    Catalog::ConstIterator it = catalog.begin();
+    for (Catalog::ConstIterator e = expected.begin(); e != expected.end();
+         ++e, ++it)
+    {
+        EXPECT_EQ(e->first, it->first);
+        ASSERT_EQ(e->second.size(), it->second.size());
+        for (DataSet::IndexType i = 0; i < e->second.size(); ++i)
+        {
+            EXPECT_EQ(e->second.node(i).preciseEpoch(),
+                      it->second.node(i).preciseEpoch());
+            EXPECT_EQ(e->second.node(i).M(), it->second.node(i).M());
+        }
+    }
+
+    EXPECT_FALSE(reader.readDirectory("test_bulk_dir_absent", catalog));
+
+    for (std::size_t i = 0; i < fileNames.size(); ++i)
+        std::remove(fileNames[i].c_str());
+    std::remove((directory + "/.hidden").c_str());
+    rmdir((directory + "/subdir").c_str());
+    rmdir(directory.c_str());
+}
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,123 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include <quicktle/catalog.h>
+#include <quicktle/generator.h>
+#include <quicktle/stream.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(CatalogTest, appendRemove)
+{
+    Generator generator(3);
+    generator.setSatellitesCount(50);
+    generator.setEpochsCount(4);
+    generator.setFirstSatelliteNumber(10000);
+    std::stringstream text;
+    generator.write(text);
+
+    Catalog catalog;
+    Stream tle(text);
+    while (tle)
+        tle >> catalog;
+
+    EXPECT_EQ(50, catalog.size());
+    EXPECT_EQ(200, catalog.nodesCount());
+
+    const DataSet *dataSet = catalog.find("10007");
+    ASSERT_TRUE(dataSet != 0);
+    ASSERT_EQ(4, dataSet->size());
+    EXPECT_LT(dataSet->node(0).epoch(), dataSet->node(3).epoch());
+    EXPECT_EQ("10007", dataSet->node(2).satelliteNumber());
+    EXPECT_TRUE(catalog.find("99999") == 0);
+
+    // The satellites are ordered by number
+    std::string previous;
+    for (Catalog::ConstIterator it = catalog.begin(); it != catalog.end(); ++it)
+    {
+        EXPECT_LT(previous, it->first);
+        previous = it->first;
+    }
+
+    EXPECT_TRUE(catalog.remove("10007"));
+    EXPECT_FALSE(catalog.remove("10007"));
+    EXPECT_EQ(49, catalog.size());
+    EXPECT_EQ(196, catalog.nodesCount());
+
+    catalog.clear();
+    EXPECT_EQ(0, catalog.size());
+}
+//------------------------------------------------------------------------------
+
+TEST(CatalogTest, merge)
+{
+    Generator generator(3);
+    generator.setSatellitesCount(20);
+    generator.setEpochsCount(3);
+
+    Catalog catalog;
+    for (std::size_t i = 0; i < 20; ++i)
+    {
+        for (std::size_t epoch = 0; epoch < 2; ++epoch)
+            catalog.append(generator.node(i, epoch));
+    }
+
+    // Delta: the next epoch of three satellites, one new satellite
+    // and the broken record
+    std::string line1, line2, line3;
+    std::string delta;
+    const std::size_t updated[] = {12, 4, 7};
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        generator.record(updated[i], 2, line1, line2, line3);
+        delta += line2 + "\n" + line3 + "\n";
+    }
+    generator.setFirstSatelliteNumber(500);
+    generator.record(0, 0, line1, line2, line3);
+    delta += line2 + "\n" + line3 + "\n";
+    delta += line2 + "\n" + line3.substr(0, 50) + "\n";
+
+    std::stringstream source(delta);
+    Stream tle(source);
+    std::vector<std::string> changed;
+    EXPECT_EQ(4, catalog.merge(tle, &changed));
+
+    ASSERT_EQ(4, changed.size());
+    EXPECT_EQ("00005", changed[0]);
+    EXPECT_EQ("00008", changed[1]);
+    EXPECT_EQ("00013", changed[2]);
+    EXPECT_EQ("00500", changed[3]);
+    EXPECT_EQ(21, catalog.size());
+    EXPECT_EQ(44, catalog.nodesCount());
+    EXPECT_EQ(3, catalog.find("00013")->size());
+    EXPECT_EQ(2, catalog.find("00014")->size());
+
+    Catalog other;
+    other.append(generator.node(0, 1));
+    EXPECT_EQ(1, catalog.merge(other, &changed));
+    ASSERT_EQ(1, changed.size());
+    EXPECT_EQ("00500", changed[0]);
+    EXPECT_EQ(2, catalog.find("00500")->size());
+}
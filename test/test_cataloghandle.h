@@ -0,0 +1,108 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/cataloghandle.h>
+#include <quicktle/generator.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(CatalogHandleTest, reclamation)
+{
+    Generator generator(9);
+    generator.setSatellitesCount(10);
+    Catalog catalog;
+    for (std::size_t i = 0; i < 10; ++i)
+        catalog.append(generator.node(i, 0));
+
+    CatalogHandle handle(catalog);
+    EXPECT_EQ(1, handle.version());
+    {
+        CatalogHandle::ReadGuard guard = handle.read();
+        EXPECT_EQ(10, guard->size());
+
+        handle.update([](Catalog &catalog) { catalog.remove("00003"); });
+        EXPECT_EQ(2, handle.version());
+        // The old version is still read
+        EXPECT_EQ(10, guard.catalog().size());
+        EXPECT_EQ(1, handle.retiredCount());
+
+        EXPECT_EQ(9, handle.read()->size());
+    }
+    handle.reclaim();
+    EXPECT_EQ(0, handle.retiredCount());
+
+    handle.publish(Catalog());
+    EXPECT_EQ(0, handle.read()->size());
+    EXPECT_EQ(0, handle.retiredCount());
+}
+//------------------------------------------------------------------------------
+
+TEST(CatalogHandleTest, concurrentReaders)
+{
+    Generator generator(9);
+    generator.setSatellitesCount(100);
+    generator.setEpochsCount(100);
+
+    CatalogHandle handle;
+    std::atomic<bool> stop(false);
+    std::atomic<std::size_t> errors(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.push_back(std::thread([&]()
+        {
+            std::size_t previous = 0;
+            while (!stop)
+            {
+                CatalogHandle::ReadGuard guard = handle.read();
+                // Every version has one more node for each satellite
+                const std::size_t size = guard->size();
+                const std::size_t count = guard->nodesCount();
+                if (count != size * (size ? count / size : 0) ||
+                    count < previous)
+                    ++errors;
+                previous = count;
+            }
+        }));
+    }
+
+    for (std::size_t epoch = 0; epoch < 100; ++epoch)
+    {
+        handle.update([&generator, epoch](Catalog &catalog)
+        {
+            for (std::size_t i = 0; i < generator.satellitesCount(); ++i)
+                catalog.append(generator.node(i, epoch));
+        });
+    }
+    stop = true;
+    for (std::size_t i = 0; i < readers.size(); ++i)
+        readers[i].join();
+
+    EXPECT_EQ(0, errors);
+    EXPECT_EQ(10000, handle.read()->nodesCount());
+    handle.reclaim();
+    EXPECT_EQ(0, handle.retiredCount());
+}
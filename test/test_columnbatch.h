@@ -0,0 +1,110 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/columnbatch.h>
+#include <quicktle/generator.h>
+#include <quicktle/tolerantstream.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(ColumnBatchTest, read)
+{
+    Generator generator(51);
+    generator.setSatellitesCount(30);
+    generator.setEpochsCount(3);
+    generator.setFileType(ThreeLines);
+    std::ostringstream output;
+    generator.write(output);
+
+    std::vector<Node> nodes;
+    std::istringstream source(output.str());
+    TolerantStream stream(source);
+    while (stream)
+    {
+        nodes.push_back(Node());
+        stream >> nodes.back();
+    }
+    ASSERT_EQ(90, nodes.size());
+
+    ColumnBatch batch;
+    batch.addField(ColumnBatch::SatelliteName);
+    batch.addField(ColumnBatch::Epoch);
+    batch.addField(ColumnBatch::MeanMotion);
+    batch.addField(ColumnBatch::Eccentricity);
+    batch.addField(ColumnBatch::RevolutionNumber);
+    batch.addField(ColumnBatch::Epoch);
+    EXPECT_TRUE(batch.hasField(ColumnBatch::Epoch));
+    EXPECT_FALSE(batch.hasField(ColumnBatch::Inclination));
+
+    std::istringstream input(output.str());
+    TolerantStream columns(input);
+    while (columns)
+        columns >> batch;
+    ASSERT_EQ(90, batch.size());
+
+    const std::vector<std::string> &names =
+        batch.strings(ColumnBatch::SatelliteName);
+    const std::vector<double> &epochs = batch.values(ColumnBatch::Epoch);
+    const std::vector<double> &n = batch.values(ColumnBatch::MeanMotion);
+    const std::vector<double> &e = batch.values(ColumnBatch::Eccentricity);
+    const std::vector<double> &revolutions =
+        batch.values(ColumnBatch::RevolutionNumber);
+    ASSERT_EQ(90, names.size());
+    ASSERT_EQ(90, epochs.size());
+    ASSERT_EQ(90, revolutions.size());
+    for (std::size_t k = 0; k < nodes.size(); ++k)
+    {
+        EXPECT_EQ(nodes[k].satelliteName(), names[k]);
+        EXPECT_EQ(nodes[k].preciseEpoch(), epochs[k]);
+        EXPECT_EQ(nodes[k].n(), n[k]);
+        EXPECT_EQ(nodes[k].e(), e[k]);
+        EXPECT_EQ(nodes[k].revolutionNumber(), revolutions[k]);
+    }
+
+    // Not declared fields are not stored
+    EXPECT_TRUE(batch.values(ColumnBatch::Inclination).empty());
+    EXPECT_TRUE(batch.strings(ColumnBatch::Designator).empty());
+    EXPECT_TRUE(batch.values(ColumnBatch::SatelliteName).empty());
+
+    batch.clear();
+    EXPECT_EQ(0, batch.size());
+    EXPECT_TRUE(batch.values(ColumnBatch::Epoch).empty());
+    EXPECT_TRUE(batch.hasField(ColumnBatch::Epoch));
+
+    // Two-lines record without the name
+    const Node &node = nodes[0];
+    std::string line2, line3;
+    std::istringstream lines(output.str());
+    std::getline(lines, line2);
+    std::getline(lines, line2);
+    std::getline(lines, line3);
+    EXPECT_TRUE(batch.append(NodeView(line2.data(), line2.size(),
+                                      line3.data(), line3.size())));
+    ASSERT_EQ(1, batch.size());
+    EXPECT_TRUE(batch.strings(ColumnBatch::SatelliteName)[0].empty());
+    EXPECT_EQ(node.preciseEpoch(), batch.values(ColumnBatch::Epoch)[0]);
+}
+//------------------------------------------------------------------------------
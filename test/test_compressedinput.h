@@ -0,0 +1,196 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include <quicktle/compressedinput.h>
+#include <quicktle/generator.h>
+#include <quicktle/stream.h>
+
+#ifdef QUICKTLE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef QUICKTLE_LZMA
+#include <lzma.h>
+#endif
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+namespace
+{
+    //! Catalog of 4000 records, it is longer than several output blocks
+    std::string compressedInputText()
+    {
+        Generator generator(8);
+        generator.setSatellitesCount(200);
+        generator.setEpochsCount(20);
+        generator.setFileType(ThreeLines);
+        std::ostringstream text;
+        generator.write(text);
+        return text.str();
+    }
+
+    void writeCompressedInputFile(const std::string &fileName,
+                                  const std::string &data)
+    {
+        std::ofstream file(fileName.c_str(), std::ios_base::binary);
+        file.write(data.data(), data.size());
+    }
+
+    //! Read the whole stream as text
+    std::string readAll(CompressedInput &input)
+    {
+        std::ostringstream text;
+        text << input.rdbuf();
+        return text.str();
+    }
+
+    std::size_t countRecords(CompressedInput &input)
+    {
+        std::size_t count = 0;
+        Stream stream(input, ThreeLines);
+        Node node;
+        while (stream)
+        {
+            stream >> node;
+            count += (node.satelliteNumber().empty() ? 0 : 1);
+        }
+        return count;
+    }
+
+    //! Check the reading of the compressed file in both modes
+    void checkCompressedInput(const std::string &fileName,
+                              const std::string &data,
+                              const std::string &text,
+                              CompressedInput::Format format)
+    {
+        writeCompressedInputFile(fileName, data);
+        for (int threaded = 0; threaded < 2; ++threaded)
+        {
+            CompressedInput input;
+            input.setThreaded(threaded);
+            ASSERT_TRUE(input.open(fileName));
+            EXPECT_EQ(format, input.format());
+            EXPECT_TRUE(readAll(input) == text);
+            EXPECT_FALSE(input.damaged());
+
+            ASSERT_TRUE(input.open(fileName, format));
+            EXPECT_EQ(4000, countRecords(input));
+            EXPECT_FALSE(input.damaged());
+        }
+
+        // The truncated data are read up to the damaged place
+        writeCompressedInputFile(fileName, data.substr(0, data.size() / 2));
+        for (int threaded = 0; threaded < 2; ++threaded)
+        {
+            CompressedInput input;
+            input.setThreaded(threaded);
+            ASSERT_TRUE(input.open(fileName));
+            const std::string part = readAll(input);
+            EXPECT_TRUE(input.damaged());
+            EXPECT_FALSE(part.empty());
+            EXPECT_TRUE(text.compare(0, part.size(), part) == 0);
+        }
+
+        std::remove(fileName.c_str());
+    }
+}
+
+TEST(CompressedInputTest, plain)
+{
+    const std::string text = compressedInputText();
+    const std::string fileName = "test_compressed.tle";
+    writeCompressedInputFile(fileName, text);
+
+    CompressedInput input(fileName);
+    ASSERT_TRUE(input.isOpen());
+    EXPECT_EQ(CompressedInput::Plain, input.format());
+    EXPECT_EQ(4000, countRecords(input));
+
+    input.close();
+    EXPECT_FALSE(input.isOpen());
+    EXPECT_FALSE(input);
+    EXPECT_FALSE(input.open("test_compressed_absent.tle"));
+
+    std::istringstream source(text);
+    ASSERT_TRUE(input.open(source));
+    EXPECT_TRUE(readAll(input) == text);
+
+    std::remove(fileName.c_str());
+}
+//------------------------------------------------------------------------------
+
+#ifdef QUICKTLE_ZLIB
+TEST(CompressedInputTest, gzip)
+{
+    ASSERT_TRUE(CompressedInput::supported(CompressedInput::Gzip));
+    const std::string text = compressedInputText();
+
+    // Two gzip members: the first and the second half of the text
+    std::string data;
+    const std::size_t half = text.size() / 2;
+    for (std::size_t first = 0; first < text.size(); first += half)
+    {
+        const std::string part = text.substr(first, half);
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+        ASSERT_EQ(Z_OK, deflateInit2(&stream, 6, Z_DEFLATED, 16 + MAX_WBITS,
+                                     8, Z_DEFAULT_STRATEGY));
+        std::string buffer(deflateBound(&stream, part.size()), '\0');
+        stream.next_in = (Bytef*)part.data();
+        stream.avail_in = part.size();
+        stream.next_out = (Bytef*)&buffer[0];
+        stream.avail_out = buffer.size();
+        ASSERT_EQ(Z_STREAM_END, deflate(&stream, Z_FINISH));
+        data.append(buffer, 0, stream.total_out);
+        deflateEnd(&stream);
+    }
+
+    checkCompressedInput("test_compressed.tle.gz", data, text,
+                         CompressedInput::Gzip);
+}
+//------------------------------------------------------------------------------
+#endif
+
+#ifdef QUICKTLE_LZMA
+TEST(CompressedInputTest, xz)
+{
+    ASSERT_TRUE(CompressedInput::supported(CompressedInput::Xz));
+    const std::string text = compressedInputText();
+
+    std::string data(lzma_stream_buffer_bound(text.size()), '\0');
+    std::size_t size = 0;
+    ASSERT_EQ(LZMA_OK, lzma_easy_buffer_encode(
+                  6, LZMA_CHECK_CRC64, 0, (const uint8_t*)text.data(),
+                  text.size(), (uint8_t*)&data[0], &size, data.size()));
+    data.resize(size);
+
+    checkCompressedInput("test_compressed.tle.xz", data, text,
+                         CompressedInput::Xz);
+}
+//------------------------------------------------------------------------------
+#endif
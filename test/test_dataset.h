@@ -20,6 +20,7 @@
 
 #include <gtest/gtest.h>
 #include <quicktle/dataset.h>
+#include <quicktle/generator.h>
 
 using namespace quicktle;
 
@@ -225,3 +226,65 @@ TEST(DataSetTest, nearestNode)
     EXPECT_EQ(0, dataSet.size());
 }
 //------------------------------------------------------------------------------
+
+TEST(DataSetTest, compression)
+{
+    Generator generator(5);
+    generator.setSatellitesCount(1);
+    generator.setEpochsCount(100);
+    generator.setEpochStep(6 * 3600);
+
+    DataSet plain;
+    DataSet dataSet;
+    dataSet.setCompression(8, 10, 2);
+    for (std::size_t k = 0; k < 100; ++k)
+    {
+        plain.append(generator.node(0, k));
+        dataSet.append(generator.node(0, k));
+    }
+
+    ASSERT_EQ(100, dataSet.size());
+    EXPECT_EQ(88, dataSet.compressedSize());
+    EXPECT_GT(88 * sizeof(Node), 4 * dataSet.compressedBytes());
+    for (DataSet::IndexType k = 0; k < 100; ++k)
+    {
+        EXPECT_EQ(plain.node(k).epoch(), dataSet.node(k).epoch());
+        EXPECT_EQ(plain.node(k).n(), dataSet.node(k).n());
+        EXPECT_EQ(plain.node(k).M(), dataSet.node(k).M());
+    }
+
+    const time_t start = plain.node(0).epoch();
+    for (time_t t = start - 86400; t < start + 26 * 86400; t += 3571)
+        EXPECT_EQ(plain.nearestNode(t).epoch(), dataSet.nearestNode(t).epoch());
+
+    // Insertion into the history and removal
+    Node node = generator.node(0, 20);
+    node.setPreciseEpoch(node.preciseEpoch() + 3600);
+    plain.append(node);
+    dataSet.append(node);
+    ASSERT_EQ(101, dataSet.size());
+    EXPECT_EQ(plain.node(21).epoch(), dataSet.node(21).epoch());
+    EXPECT_TRUE(dataSet.remove(node));
+    EXPECT_TRUE(dataSet.remove(generator.node(0, 3)));
+    EXPECT_FALSE(dataSet.remove(generator.node(0, 3)));
+    ASSERT_EQ(99, dataSet.size());
+    EXPECT_EQ(plain.node(4).epoch(), dataSet.node(3).epoch());
+
+    dataSet.setCompression(0, 0);
+    EXPECT_EQ(0, dataSet.compressedSize());
+    ASSERT_EQ(99, dataSet.size());
+    EXPECT_EQ(plain.node(100).epoch(), dataSet.node(98).epoch());
+
+    // The block, grown by insertions, is split
+    dataSet.setCompression(8, 10, 2);
+    for (int k = 1; k <= 12; ++k)
+    {
+        node.setPreciseEpoch(generator.node(0, 40).preciseEpoch() + k * 600);
+        dataSet.append(node);
+    }
+    ASSERT_EQ(111, dataSet.size());
+    EXPECT_EQ(100, dataSet.compressedSize());
+    for (DataSet::IndexType k = 1; k < dataSet.size(); ++k)
+        EXPECT_LT(dataSet.node(k - 1).epoch(), dataSet.node(k).epoch());
+}
+//------------------------------------------------------------------------------
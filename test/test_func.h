@@ -52,6 +52,7 @@ TEST(Functions, double2string)
     EXPECT_TRUE(double2string(0, 1, 0) == "0");
     EXPECT_TRUE(double2string(0, 4, 1, true) == "000-0");
     EXPECT_TRUE(double2string(0, 8, 3, true, true, false) == " 00000-0");
+    EXPECT_TRUE(double2string(-1.1606e-5, 8, 3, true, true, false) == "-11606-4");
 }
 //------------------------------------------------------------------------------
 
@@ -66,8 +67,10 @@ TEST(Functions, string2string)
 
 TEST(Functions, date2string)
 {
-    // Prepare date
-    struct tm t0;
+    // Prepare date. Not set fields of tm must not be garbage:
+    // tm_isdst > 0 makes mktime() shift the time by an hour.
+    struct tm t0 = tm();
+    t0.tm_isdst = -1;
     t0.tm_year = 111;
     t0.tm_mon = 3;
     t0.tm_mday = 6;
@@ -78,7 +81,8 @@ TEST(Functions, date2string)
     std::string s = date2string(mktime(&t0), 14);
     // Convert string to date
     Node::ErrorCode error = Node::NoError;
-    std::time_t dt = static_cast<std::time_t>(string2date(s, error));
+    // The day fraction keeps 8 digits only, so round to the nearest second
+    std::time_t dt = static_cast<std::time_t>(string2date(s, error) + 0.5);
     struct tm *t1 = localtime(&dt);
     // Comparison
     EXPECT_EQ(Node::NoError, error);
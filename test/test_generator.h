@@ -0,0 +1,121 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include <quicktle/func.h>
+#include <quicktle/generator.h>
+#include <quicktle/stream.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(GeneratorTest, validRecords)
+{
+    Generator generator(42);
+    generator.setSatellitesCount(200);
+    generator.setEpochsCount(3);
+    generator.setFileType(ThreeLines);
+
+    std::stringstream lines(std::stringstream::in | std::stringstream::out);
+    EXPECT_EQ(600, generator.write(lines));
+
+    Stream tle(lines, ThreeLines);
+    tle.enforceParsing(true);
+    std::size_t count = 0;
+    while (tle)
+    {
+        Node node;
+        tle >> node;
+        ASSERT_EQ(Node::NoError, node.lastError()) << "record " << count;
+
+        // Regenerated lines must be the same
+        const std::size_t satellite = count % 200;
+        const std::size_t epoch = count / 200;
+        std::string line1;
+        std::string line2;
+        std::string line3;
+        generator.record(satellite, epoch, line1, line2, line3);
+        EXPECT_EQ(line2, node.secondString());
+        EXPECT_EQ(trim(line1), node.satelliteName());
+
+        // Node writes angles less than 1 degree without leading zero
+        Node copy(node.secondString(), node.thirdString(), true);
+        ASSERT_EQ(Node::NoError, copy.lastError());
+        EXPECT_DOUBLE_EQ(node.i(), copy.i());
+        EXPECT_DOUBLE_EQ(node.Omega(), copy.Omega());
+        EXPECT_DOUBLE_EQ(node.omega(), copy.omega());
+        EXPECT_DOUBLE_EQ(node.M(), copy.M());
+        EXPECT_DOUBLE_EQ(node.e(), copy.e());
+        EXPECT_DOUBLE_EQ(node.n(), copy.n());
+        EXPECT_EQ(node.revolutionNumber(), copy.revolutionNumber());
+        ++count;
+    }
+    EXPECT_EQ(600, count);
+}
+//------------------------------------------------------------------------------
+
+TEST(GeneratorTest, orbitClasses)
+{
+    Generator generator(7);
+    generator.setSatellitesCount(1000);
+    generator.setOrbitMix(0, 0, 1, 1);
+
+    for (std::size_t satellite = 0; satellite < 1000; ++satellite)
+    {
+        Node node = generator.node(satellite, 0);
+        const double revs = node.n() * 86400 / 2 / M_PI;
+        if (generator.orbitClass(satellite) == Generator::GEO)
+        {
+            EXPECT_NEAR(1.0027, revs, 0.001);
+            EXPECT_LT(node.e(), 0.001);
+        }
+        else
+        {
+            ASSERT_EQ(Generator::HEO, generator.orbitClass(satellite));
+            EXPECT_GT(node.e(), 0.6);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(GeneratorTest, epochs)
+{
+    Generator generator;
+    generator.setSatellitesCount(3);
+    generator.setEpochsCount(10);
+    generator.setFirstSatelliteNumber(25544);
+    generator.setEpochStep(3600);
+
+    EXPECT_EQ("25544", generator.node(0, 0).satelliteNumber());
+    EXPECT_EQ("25546", generator.node(2, 0).satelliteNumber());
+    for (std::size_t epoch = 1; epoch < 10; ++epoch)
+    {
+        const double dt = generator.node(1, epoch).preciseEpoch()
+                        - generator.node(1, epoch - 1).preciseEpoch();
+        EXPECT_GT(dt, 0.7 * 3600);
+        EXPECT_LT(dt, 1.3 * 3600);
+    }
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,213 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/func.h>
+#include <quicktle/generator.h>
+#include <quicktle/historyarchive.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(HistoryTest, writeRead)
+{
+    Generator generator(14);
+    generator.setSatellitesCount(30);
+    generator.setEpochsCount(50);
+    generator.setFileType(ThreeLines);
+
+    const std::string fileName = "test_history.qth";
+    HistoryWriter writer;
+    ASSERT_TRUE(writer.open(fileName));
+    writer.setBlockSize(16);
+    std::string line1, line2, line3;
+    std::size_t textSize = 0;
+    for (std::size_t satellite = 0; satellite < 30; ++satellite)
+    {
+        for (std::size_t epoch = 0; epoch < 50; ++epoch)
+        {
+            generator.record(satellite, epoch, line1, line2, line3);
+            textSize += line1.length() + line2.length() + line3.length() + 3;
+            EXPECT_TRUE(writer.append(Node(line1, line2, line3)));
+        }
+    }
+    // The epochs must not decrease, the satellites must not repeat
+    generator.record(29, 10, line1, line2, line3);
+    EXPECT_FALSE(writer.append(Node(line1, line2, line3)));
+    generator.record(3, 10, line1, line2, line3);
+    EXPECT_FALSE(writer.append(Node(line1, line2, line3)));
+    EXPECT_EQ(1500, writer.recordsCount());
+    EXPECT_TRUE(writer.close());
+
+    std::ifstream file(fileName.c_str(), std::ios::binary | std::ios::ate);
+    EXPECT_LT(static_cast<std::size_t>(file.tellg()) * 4, textSize);
+
+    HistoryReader reader;
+    ASSERT_TRUE(reader.open(fileName));
+    ASSERT_EQ(30, reader.satellitesCount());
+    for (std::size_t satellite = 0; satellite < 30; ++satellite)
+    {
+        generator.record(satellite, 0, line1, line2, line3);
+        const std::size_t index =
+                            reader.find(Node(line2, line3).satelliteNumber());
+        ASSERT_EQ(satellite, index);
+        EXPECT_EQ(50, reader.recordsCount(index));
+
+        DataSet dataSet;
+        ASSERT_TRUE(reader.read(index, dataSet));
+        ASSERT_EQ(50, dataSet.size());
+        HistoryBlock::Columns columns;
+        ASSERT_TRUE(reader.read(index, columns));
+        ASSERT_EQ(50, columns.size());
+
+        for (std::size_t epoch = 0; epoch < 50; ++epoch)
+        {
+            generator.record(satellite, epoch, line1, line2, line3);
+            const Node expected(line1, line2, line3);
+            const Node &node = dataSet.node(epoch);
+            // The values are equal to the parsed ones
+            EXPECT_EQ(expected.satelliteNumber(), node.satelliteNumber());
+            EXPECT_EQ(expected.satelliteName(), node.satelliteName());
+            EXPECT_EQ(expected.designator(), node.designator());
+            EXPECT_EQ(expected.preciseEpoch(), node.preciseEpoch());
+            EXPECT_EQ(expected.n(), node.n());
+            EXPECT_EQ(expected.dn(), node.dn());
+            EXPECT_EQ(expected.d2n(), node.d2n());
+            EXPECT_EQ(expected.i(), node.i());
+            EXPECT_EQ(expected.Omega(), node.Omega());
+            EXPECT_EQ(expected.omega(), node.omega());
+            EXPECT_EQ(expected.M(), node.M());
+            EXPECT_EQ(expected.e(), node.e());
+            EXPECT_EQ(expected.bstar(), node.bstar());
+            EXPECT_EQ(expected.classification(), node.classification());
+            EXPECT_EQ(expected.ephemerisType(), node.ephemerisType());
+            EXPECT_EQ(expected.elementNumber(), node.elementNumber());
+            EXPECT_EQ(expected.revolutionNumber(), node.revolutionNumber());
+            EXPECT_EQ(ThreeLines, node.outputFormat());
+
+            EXPECT_EQ(expected.preciseEpoch(), columns.epoch[epoch]);
+            EXPECT_EQ(expected.n(), columns.n[epoch]);
+            EXPECT_EQ(expected.e(), columns.e[epoch]);
+            EXPECT_EQ(expected.bstar(), columns.bstar[epoch]);
+        }
+    }
+
+    // Period
+    const double t1 = generator.node(5, 20).preciseEpoch();
+    const double t2 = generator.node(5, 29).preciseEpoch();
+    std::vector<Node> nodes;
+    EXPECT_TRUE(reader.read(5, t1, t2,
+                            [&nodes](const Node &node)
+                            {
+                                nodes.push_back(node);
+                            }));
+    ASSERT_EQ(10, nodes.size());
+    EXPECT_EQ(t1, nodes.front().preciseEpoch());
+    EXPECT_EQ(t2, nodes.back().preciseEpoch());
+
+    EXPECT_EQ(30, reader.find("99999"));
+    reader.close();
+    std::remove(fileName.c_str());
+}
+//------------------------------------------------------------------------------
+
+TEST(HistoryTest, damaged)
+{
+    const std::string line2 =
+        "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+    const std::string line3 =
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+
+    const std::string fileName = "test_history.qth";
+    HistoryWriter writer;
+    ASSERT_TRUE(writer.open(fileName));
+    EXPECT_TRUE(writer.append(Node(line2, line3)));
+    EXPECT_TRUE(writer.close());
+
+    std::string data;
+    {
+        std::ifstream file(fileName.c_str(), std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+    }
+    const std::string original = data;
+
+    HistoryReader reader;
+    ASSERT_TRUE(reader.open(fileName));
+    DataSet dataSet;
+    EXPECT_TRUE(reader.read(0, dataSet));
+    ASSERT_EQ(1, dataSet.size());
+    EXPECT_EQ(TwoLines, dataSet.node(0).outputFormat());
+    std::ostringstream out;
+    out << dataSet.node(0);
+    EXPECT_EQ(line2 + "\n" + line3 + "\n", out.str());
+
+    // Damaged block
+    data[20] ^= 1;
+    {
+        std::ofstream file(fileName.c_str(), std::ios::binary);
+        file << data;
+    }
+    ASSERT_TRUE(reader.open(fileName));
+    EXPECT_FALSE(reader.read(0, dataSet));
+
+    // Damaged directory
+    data[data.length() - 30] ^= 1;
+    {
+        std::ofstream file(fileName.c_str(), std::ios::binary);
+        file << data;
+    }
+    EXPECT_FALSE(reader.open(fileName));
+
+    // The header of the block overlaps the directory, the checksums of
+    // the directory and the footer are valid
+    data = original;
+    const std::size_t footer = data.length() - 24;
+    unsigned long long directory = 0;
+    for (int i = 7; i >= 0; --i)
+        directory = (directory << 8) | static_cast<unsigned char>(
+                                                    data[footer + i]);
+    const unsigned long long offset = directory - 4;
+    for (int i = 0; i < 8; ++i)
+        data[directory + 16 + i] =
+                            static_cast<char>((offset >> (8 * i)) & 0xff);
+    unsigned long checksum = fnv1a(
+        reinterpret_cast<const unsigned char*>(&data[directory]),
+        footer - directory);
+    for (int i = 0; i < 4; ++i)
+        data[footer + 16 + i] = static_cast<char>((checksum >> (8 * i)) & 0xff);
+    checksum = fnv1a(reinterpret_cast<const unsigned char*>(&data[footer]), 20);
+    for (int i = 0; i < 4; ++i)
+        data[footer + 20 + i] = static_cast<char>((checksum >> (8 * i)) & 0xff);
+    {
+        std::ofstream file(fileName.c_str(), std::ios::binary);
+        file << data;
+    }
+    EXPECT_FALSE(reader.open(fileName));
+
+    std::remove(fileName.c_str());
+}
+//------------------------------------------------------------------------------
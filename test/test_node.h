@@ -18,6 +18,7 @@
  | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
  +----------------------------------------------------------------------------*/
 
+#include <sstream>
 #include <string>
 #include <iostream>
 #include <ctime>
@@ -205,6 +206,41 @@ TEST_F(NodeTest, output)
 }
 //------------------------------------------------------------------------------
 
+TEST_F(NodeTest, verbatimOutput)
+{
+    // Unpadded name and explicit sign of BSTAR are not regenerated
+    std::string line1 = "Mir";
+    std::string line2 = "1 16609U 86017A   86053.30522506  .00057349  00000-0"
+                                                            " +31166-3 0   112";
+    std::string line3 = "2 16609  51.6129 108.0599 0012107 160.8295 196.0076"
+                                                           " 15.79438158   394";
+    Node node(line1, line2, line3);
+    EXPECT_FALSE(node.modified());
+
+    std::stringstream out;
+    out << node;
+    EXPECT_EQ(line1 + "\n" + line2 + "\n" + line3 + "\n", out.str());
+
+    // The copy is still unmodified, the output format can be changed
+    Node copy(node);
+    EXPECT_FALSE(copy.modified());
+    out.str("");
+    out << copy.outputFormat(TwoLines);
+    EXPECT_EQ(line2 + "\n" + line3 + "\n", out.str());
+
+    node.set_n(node.n());
+    EXPECT_TRUE(node.modified());
+    out.str("");
+    out << node;
+    EXPECT_EQ(node.firstString() + "\n" + node.secondString() + "\n" +
+              node.thirdString() + "\n", out.str());
+    EXPECT_NE(std::string::npos, out.str().find("  31166-3"));
+
+    node.assign(line2, line3);
+    EXPECT_FALSE(node.modified());
+}
+//------------------------------------------------------------------------------
+
 TEST_F(NodeTest, swap)
 {
     std::string line1 = "Mir                     ";
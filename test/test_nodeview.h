@@ -0,0 +1,138 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <string>
+#include <gtest/gtest.h>
+#include <quicktle/func.h>
+#include <quicktle/generator.h>
+#include <quicktle/nodeview.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(NodeViewTest, getters)
+{
+    Generator generator(5);
+    generator.setSatellitesCount(50);
+    generator.setEpochsCount(4);
+
+    std::string line1, line2, line3;
+    for (std::size_t i = 0; i < 50; ++i)
+    {
+        generator.record(i, i % 4, line1, line2, line3);
+        Node node(line1, line2, line3);
+        // The lines are not terminated by zero in a big buffer
+        const std::string buffer = line1 + line2 + line3;
+        NodeView view(buffer.data(), line1.length(),
+                      buffer.data() + line1.length(), line2.length(),
+                      buffer.data() + line1.length() + line2.length(),
+                      line3.length());
+
+        EXPECT_EQ(Node::NoError, view.check());
+        EXPECT_EQ(node.satelliteNumber(), view.satelliteNumber());
+        EXPECT_EQ(node.satelliteName(), view.satelliteName());
+        EXPECT_EQ(node.designator(), view.designator());
+        EXPECT_EQ(node.n(), view.n());
+        EXPECT_EQ(node.dn(), view.dn());
+        EXPECT_EQ(node.d2n(), view.d2n());
+        EXPECT_EQ(node.i(), view.i());
+        EXPECT_EQ(node.Omega(), view.Omega());
+        EXPECT_EQ(node.omega(), view.omega());
+        EXPECT_EQ(node.M(), view.M());
+        EXPECT_EQ(node.bstar(), view.bstar());
+        EXPECT_EQ(node.e(), view.e());
+        EXPECT_EQ(node.classification(), view.classification());
+        EXPECT_EQ(node.ephemerisType(), view.ephemerisType());
+        EXPECT_EQ(node.preciseEpoch(), view.preciseEpoch());
+        EXPECT_EQ(node.epoch(), view.epoch());
+        EXPECT_EQ(node.elementNumber(), view.elementNumber());
+        EXPECT_EQ(node.revolutionNumber(), view.revolutionNumber());
+        EXPECT_EQ(Node::NoError, view.lastError());
+
+        Node copy = view.toNode();
+        EXPECT_EQ(node.x(), copy.x());
+        EXPECT_EQ(node.satelliteName(), copy.satelliteName());
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(NodeViewTest, errors)
+{
+    const std::string line2 =
+        "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+    const std::string line3 =
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+
+    NodeView view(line2.data(), line2.length(), line3.data(), line3.length());
+    EXPECT_EQ(Node::NoError, view.check());
+    EXPECT_EQ("25544", view.satelliteNumber());
+    EXPECT_EQ("", view.satelliteName());
+    EXPECT_EQ(Node::NoError, view.lastError());
+
+    NodeView shortView(line2.data(), 40, line3.data(), line3.length());
+    EXPECT_EQ(Node::TooShortString, shortView.check());
+    EXPECT_EQ(0, shortView.bstar());
+    EXPECT_EQ(Node::TooShortString, shortView.lastError());
+
+    std::string wrong = line3;
+    wrong[10] = 'x';
+    NodeView wrongView(line2.data(), line2.length(),
+                       wrong.data(), wrong.length());
+    EXPECT_EQ(Node::ChecksumError, wrongView.check());
+    EXPECT_EQ(0, wrongView.i());
+    EXPECT_EQ(Node::InvalidFormat, wrongView.lastError());
+}
+//------------------------------------------------------------------------------
+
+TEST(NodeViewTest, epochYears)
+{
+    // Two-digit years below 70 belong to 2000-2069, the others
+    // to 1970-1999; the epoch is counted from Jan 1, 1970
+    const std::string line3 =
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+    const char *epochs[] = {"57001.00000000", "60123.50000000",
+                            "69365.25000000", "70001.00000000",
+                            "99365.75000000", "00060.00000000"};
+    const int years[] = {2057, 2060, 2069, 1970, 1999, 2000};
+    const double days[] = {0, 122.5, 364.25, 0, 364.75, 59};
+    for (std::size_t k = 0; k < 6; ++k)
+    {
+        std::string line2 =
+            "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+        line2.replace(18, 14, epochs[k]);
+        line2[68] = '0' + checksum(line2.substr(0, 68));
+
+        double expected = days[k];
+        for (int year = 1970; year < years[k]; ++year)
+            expected += (!(year % 4) && ((year % 100) || !(year % 400)))
+                      ? 366 : 365;
+        expected *= 86400;
+
+        NodeView view(line2.data(), line2.length(),
+                      line3.data(), line3.length());
+        Node node(line2, line3);
+        EXPECT_EQ(Node::NoError, view.check());
+        EXPECT_DOUBLE_EQ(expected, view.preciseEpoch()) << epochs[k];
+        EXPECT_EQ(node.preciseEpoch(), view.preciseEpoch());
+        EXPECT_LE(0, view.preciseEpoch());
+    }
+}
+//------------------------------------------------------------------------------
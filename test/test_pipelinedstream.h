@@ -0,0 +1,119 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/generator.h>
+#include <quicktle/pipelinedstream.h>
+#include <quicktle/stream.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(PipelinedStreamTest, read)
+{
+    for (int fileType = TwoLines; fileType <= ThreeLines; ++fileType)
+    {
+        Generator generator(21);
+        generator.setSatellitesCount(50);
+        generator.setEpochsCount(4);
+        generator.setFileType(static_cast<FileType>(fileType));
+        std::ostringstream output;
+        generator.write(output);
+        const std::string text = output.str();
+
+        std::vector<Node> nodes;
+        std::istringstream source(text);
+        Stream stream(source, static_cast<FileType>(fileType));
+        while (stream)
+        {
+            nodes.push_back(Node());
+            stream >> nodes.back();
+        }
+        ASSERT_EQ(200, nodes.size());
+
+        // The records and the lines cross the borders of the blocks
+        const std::size_t blockSizes[] = {1, 7, 69, 4096, 0};
+        for (std::size_t k = 0; k < 5; ++k)
+        {
+            std::istringstream input(text);
+            PipelinedStream pipeline(input, static_cast<FileType>(fileType));
+            pipeline.setBlockSize(blockSizes[k]);
+            pipeline.enforceParsing(true);
+            std::size_t count = 0;
+            Node node;
+            while (pipeline)
+            {
+                pipeline >> node;
+                ASSERT_LT(count, nodes.size());
+                EXPECT_EQ(nodes[count].satelliteName(), node.satelliteName());
+                EXPECT_EQ(nodes[count].satelliteNumber(),
+                          node.satelliteNumber());
+                EXPECT_EQ(nodes[count].preciseEpoch(), node.preciseEpoch());
+                EXPECT_EQ(nodes[count].M(), node.M());
+                ++count;
+            }
+            EXPECT_EQ(nodes.size(), count);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(PipelinedStreamTest, lineEnds)
+{
+    const std::string line2 = "1 16609U 86017A   86053.30522506  .00057349"
+                              "  00000-0  31166-3 0   112";
+    const std::string line3 = "2 16609  51.6129 108.0599 0012107 160.8295"
+                              " 196.0076 15.79438158   394";
+
+    // CRLF and no line end after the last record
+    std::istringstream input("Mir\r\n" + line2 + "\r\n" + line3 + "\r\n" +
+                             "Mir-2\n" + line2 + "\n" + line3);
+    PipelinedStream pipeline(input, ThreeLines);
+    pipeline.setBlockSize(16);
+
+    Catalog catalog;
+    DataSet dataSet;
+    ASSERT_TRUE(static_cast<bool>(pipeline));
+    pipeline >> catalog;
+    ASSERT_TRUE(static_cast<bool>(pipeline));
+    pipeline >> dataSet;
+    EXPECT_FALSE(static_cast<bool>(pipeline));
+
+    ASSERT_EQ(1, catalog.size());
+    ASSERT_EQ(1, dataSet.size());
+    EXPECT_EQ("Mir", catalog.find("16609")->node(0).satelliteName());
+    EXPECT_EQ("Mir-2", dataSet.node(0).satelliteName());
+    EXPECT_EQ(Node::NoError, dataSet.node(0).lastError());
+
+    std::istringstream empty("");
+    PipelinedStream emptyPipeline(empty, TwoLines);
+    EXPECT_FALSE(static_cast<bool>(emptyPipeline));
+
+    // The reading thread is stopped before the end of the input
+    std::istringstream big(std::string(1 << 16, '\n'));
+    PipelinedStream stopped(big, TwoLines);
+    stopped.setBlockSize(64);
+    EXPECT_TRUE(static_cast<bool>(stopped));
+}
+//------------------------------------------------------------------------------
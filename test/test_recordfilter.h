@@ -0,0 +1,132 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/bulkreader.h>
+#include <quicktle/generator.h>
+#include <quicktle/recordfilter.h>
+#include <quicktle/tolerantstream.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+namespace
+{
+    std::string recordFilterText()
+    {
+        Generator generator(41);
+        generator.setSatellitesCount(100);
+        generator.setEpochsCount(5);
+        generator.setFirstSatelliteNumber(20000);
+        generator.setFileType(ThreeLines);
+        std::ostringstream text;
+        generator.write(text);
+        return text.str();
+    }
+
+    std::vector<Node> readFiltered(const std::string &text,
+                                   const RecordFilter &filter,
+                                   std::size_t &rejected)
+    {
+        std::vector<Node> nodes;
+        std::istringstream source(text);
+        TolerantStream stream(source);
+        stream.setFilter(filter);
+        while (stream)
+        {
+            nodes.push_back(Node());
+            stream >> nodes.back();
+        }
+        rejected = stream.rejectedRecordsCount();
+        return nodes;
+    }
+}
+
+TEST(RecordFilterTest, accept)
+{
+    const std::string text = recordFilterText();
+    std::size_t rejected = 0;
+    const std::vector<Node> all = readFiltered(text, RecordFilter(), rejected);
+    ASSERT_EQ(500, all.size());
+    EXPECT_EQ(0, rejected);
+
+    const double minN = 11 * 2 * M_PI / 86400;
+    const double firstEpoch = all[1].preciseEpoch();
+    const double lastEpoch = all[3].preciseEpoch();
+
+    RecordFilter filter;
+    EXPECT_TRUE(filter.empty());
+    filter.addSatellite("20003");
+    filter.addSatellite(" 20050");
+    filter.addSatellite("20099");
+    filter.setEpochRange(firstEpoch, lastEpoch);
+    EXPECT_FALSE(filter.empty());
+
+    std::vector<Node> nodes = readFiltered(text, filter, rejected);
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i < all.size(); ++i)
+    {
+        const std::string number = all[i].satelliteNumber();
+        const double epoch = all[i].preciseEpoch();
+        expected += ((number == "20003" || number == "20050" ||
+                      number == "20099") &&
+                     epoch >= firstEpoch && epoch <= lastEpoch) ? 1 : 0;
+    }
+    EXPECT_LT(0, expected);
+    EXPECT_EQ(expected, nodes.size());
+    EXPECT_EQ(500, nodes.size() + rejected);
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+        EXPECT_LE(firstEpoch, nodes[i].preciseEpoch());
+
+    // Low orbits only
+    filter.clear();
+    EXPECT_TRUE(filter.empty());
+    filter.addRange(RecordFilter::MeanMotion, minN, 1);
+    filter.addRange(RecordFilter::Eccentricity, 0, 0.1);
+    nodes = readFiltered(text, filter, rejected);
+    expected = 0;
+    for (std::size_t i = 0; i < all.size(); ++i)
+        expected += (all[i].n() >= minN && all[i].e() <= 0.1) ? 1 : 0;
+    EXPECT_LT(0, expected);
+    EXPECT_GT(500, expected);
+    EXPECT_EQ(expected, nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+        EXPECT_LE(minN, nodes[i].n());
+
+    // The same filter for the bulk reader
+    const std::string fileName = "test_record_filter.tle";
+    std::ofstream(fileName.c_str(), std::ios_base::binary) << text;
+    BulkReader reader(ThreeLines);
+    reader.setFilter(filter);
+    Catalog catalog;
+    ASSERT_TRUE(reader.read(std::vector<std::string>(1, fileName), catalog));
+    EXPECT_EQ(expected, reader.recordsCount());
+    EXPECT_EQ(500 - expected, reader.rejectedCount());
+    EXPECT_EQ(expected, catalog.nodesCount());
+    std::remove(fileName.c_str());
+}
+//------------------------------------------------------------------------------
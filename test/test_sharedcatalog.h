@@ -0,0 +1,94 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <quicktle/generator.h>
+#include <quicktle/sharedcatalog.h>
+#include <quicktle/stream.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+namespace
+{
+    Catalog sharedCatalog(std::size_t satellitesCount)
+    {
+        Generator generator(5);
+        generator.setSatellitesCount(satellitesCount);
+        generator.setEpochsCount(3);
+        std::stringstream text;
+        generator.write(text);
+
+        Catalog catalog;
+        Stream tle(text);
+        while (tle)
+            tle >> catalog;
+
+        return catalog;
+    }
+}
+
+TEST(SharedCatalogTest, publishRefresh)
+{
+    std::ostringstream name;
+    name << "/quicktle_test_" << getpid();
+    SharedCatalogWriter::remove(name.str());
+
+    SharedCatalogReader reader(name.str());
+    EXPECT_FALSE(reader.refresh());
+    EXPECT_EQ(0, reader.generation());
+
+    SharedCatalogWriter writer(name.str());
+    ASSERT_TRUE(writer.publish(sharedCatalog(20)));
+    EXPECT_EQ(1, writer.generation());
+
+    ASSERT_TRUE(reader.refresh());
+    EXPECT_EQ(1, reader.generation());
+    EXPECT_FALSE(reader.outdated());
+    EXPECT_EQ(20, reader.snapshot().satellitesCount());
+    EXPECT_EQ(60, reader.snapshot().recordsCount());
+
+    Node node;
+    EXPECT_TRUE(reader.snapshot().nearestNode("00007", 0, node));
+    EXPECT_EQ("00007", node.satelliteNumber());
+
+    // The reader uses the old version until it refreshes
+    ASSERT_TRUE(writer.publish(sharedCatalog(30)));
+    EXPECT_TRUE(reader.outdated());
+    EXPECT_EQ(20, reader.snapshot().satellitesCount());
+    EXPECT_TRUE(reader.snapshot().nearestNode("00007", 0, node));
+
+    ASSERT_TRUE(reader.refresh());
+    EXPECT_EQ(2, reader.generation());
+    EXPECT_EQ(30, reader.snapshot().satellitesCount());
+
+    SharedCatalogReader another(name.str());
+    ASSERT_TRUE(another.refresh());
+    EXPECT_EQ(2, another.generation());
+    EXPECT_EQ(90, another.snapshot().recordsCount());
+
+    SharedCatalogWriter::remove(name.str());
+    SharedCatalogReader removed(name.str());
+    EXPECT_FALSE(removed.refresh());
+}
@@ -0,0 +1,170 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include <quicktle/func.h>
+#include <quicktle/generator.h>
+#include <quicktle/snapshot.h>
+#include <quicktle/stream.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+namespace
+{
+    Catalog snapshotCatalog()
+    {
+        Generator generator(11);
+        generator.setSatellitesCount(40);
+        generator.setEpochsCount(5);
+        generator.setFirstSatelliteNumber(25000);
+        generator.setFileType(ThreeLines);
+        std::stringstream text;
+        generator.write(text);
+
+        Catalog catalog;
+        Stream tle(text, ThreeLines);
+        while (tle)
+            tle >> catalog;
+
+        return catalog;
+    }
+}
+
+TEST(SnapshotTest, writeRead)
+{
+    const Catalog catalog = snapshotCatalog();
+    std::stringstream image;
+    ASSERT_TRUE(Snapshot::write(catalog, image));
+    const std::string data = image.str();
+
+    Snapshot snapshot;
+    EXPECT_EQ(Snapshot::NotOpened, snapshot.status());
+    ASSERT_TRUE(snapshot.attach(data.data(), data.size()));
+    EXPECT_TRUE(snapshot.verify());
+    EXPECT_EQ(40, snapshot.satellitesCount());
+    EXPECT_EQ(200, snapshot.recordsCount());
+
+    const std::size_t satellite = snapshot.find("25013");
+    ASSERT_LT(satellite, snapshot.satellitesCount());
+    EXPECT_EQ("25013", snapshot.satelliteNumber(satellite));
+    EXPECT_EQ(5, snapshot.recordsCount(satellite));
+    EXPECT_EQ(snapshot.satellitesCount(), snapshot.find("12345"));
+
+    const DataSet &dataSet = *catalog.find("25013");
+    for (std::size_t i = 0; i < dataSet.size(); ++i)
+    {
+        const Node &expected = dataSet.node(i);
+        Node node = snapshot.node(satellite, i);
+        EXPECT_EQ(expected.satelliteName(), node.satelliteName());
+        EXPECT_EQ(expected.designator(), node.designator());
+        EXPECT_EQ(expected.preciseEpoch(), node.preciseEpoch());
+        EXPECT_EQ(expected.n(), node.n());
+        EXPECT_EQ(expected.e(), node.e());
+        EXPECT_EQ(expected.M(), node.M());
+        EXPECT_EQ(expected.bstar(), node.bstar());
+        EXPECT_EQ(expected.revolutionNumber(), node.revolutionNumber());
+        EXPECT_EQ(expected.thirdString(), node.thirdString());
+        EXPECT_EQ(ThreeLines, node.outputFormat());
+    }
+
+    Node node;
+    const std::time_t t = dataSet.node(2).epoch() + 1000;
+    ASSERT_TRUE(snapshot.nearestNode("25013", t, node));
+    EXPECT_EQ(dataSet.nearestNode(t).preciseEpoch(), node.preciseEpoch());
+    EXPECT_FALSE(snapshot.nearestNode("12345", t, node));
+
+    Catalog loaded;
+    snapshot.load(loaded);
+    EXPECT_EQ(catalog.size(), loaded.size());
+    EXPECT_EQ(catalog.nodesCount(), loaded.nodesCount());
+}
+//------------------------------------------------------------------------------
+
+TEST(SnapshotTest, file)
+{
+    const Catalog catalog = snapshotCatalog();
+    const std::string fileName = "snapshot_test.bin";
+    ASSERT_TRUE(Snapshot::write(catalog, fileName));
+
+    Snapshot snapshot;
+    ASSERT_TRUE(snapshot.open(fileName));
+    EXPECT_EQ(Snapshot::Ok, snapshot.status());
+    EXPECT_EQ(200, snapshot.recordsCount());
+    DataSet dataSet;
+    snapshot.load(snapshot.find("25001"), dataSet);
+    EXPECT_EQ(5, dataSet.size());
+    snapshot.close();
+    EXPECT_EQ(0, snapshot.recordsCount());
+    std::remove(fileName.c_str());
+
+    EXPECT_FALSE(snapshot.open(fileName));
+    EXPECT_EQ(Snapshot::FileError, snapshot.status());
+}
+//------------------------------------------------------------------------------
+
+TEST(SnapshotTest, corrupted)
+{
+    std::stringstream image;
+    ASSERT_TRUE(Snapshot::write(snapshotCatalog(), image));
+    const std::string data = image.str();
+    Snapshot snapshot;
+
+    std::string damaged = data;
+    damaged[20] ^= 1;
+    EXPECT_FALSE(snapshot.attach(damaged.data(), damaged.size()));
+    EXPECT_EQ(Snapshot::HeaderChecksumError, snapshot.status());
+
+    damaged = data;
+    damaged[0] = 'X';
+    EXPECT_FALSE(snapshot.attach(damaged.data(), damaged.size()));
+    EXPECT_EQ(Snapshot::InvalidHeader, snapshot.status());
+
+    EXPECT_FALSE(snapshot.attach(data.data(), data.size() - 1));
+    EXPECT_EQ(Snapshot::InvalidHeader, snapshot.status());
+
+    // The offset near 2^64 must not wrap the end of the section: the
+    // records "end" at 0 and pass the check of the sum
+    damaged = data;
+    unsigned long long recordsSize = 0;
+    for (int i = 7; i >= 0; --i)
+        recordsSize = (recordsSize << 8) | static_cast<unsigned char>(
+                                                        damaged[24 + i]);
+    recordsSize *= static_cast<unsigned char>(damaged[12]);
+    const unsigned long long recordsOffset = 0 - recordsSize;
+    for (int i = 0; i < 8; ++i)
+        damaged[40 + i] = static_cast<char>((recordsOffset >> (8 * i)) & 0xff);
+    const unsigned long checksum = fnv1a(
+        reinterpret_cast<const unsigned char*>(damaged.data()), 68);
+    for (int i = 0; i < 4; ++i)
+        damaged[68 + i] = static_cast<char>((checksum >> (8 * i)) & 0xff);
+    EXPECT_FALSE(snapshot.attach(damaged.data(), damaged.size()));
+    EXPECT_EQ(Snapshot::InvalidHeader, snapshot.status());
+
+    // The payload is checked on demand only
+    damaged = data;
+    damaged[200] ^= 1;
+    EXPECT_TRUE(snapshot.attach(damaged.data(), damaged.size()));
+    EXPECT_FALSE(snapshot.verify());
+}
@@ -0,0 +1,81 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <gtest/gtest.h>
+#include <quicktle/dataset.h>
+#include <quicktle/stats.h>
+#include <quicktle/stream.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(StatsTest, counters)
+{
+    std::string line2 = "1 16609U 86017A   86053.30522506  .00057349"
+            "  00000-0  31166-3 0   112";
+    std::string line3 = "2 16609  51.6129 108.0599 0012107 160.8295"
+            " 196.0076 15.79438158   394";
+
+    Stats::reset();
+    Node node(line2, line3);
+    node.n();
+    node.n();
+    node.i();
+    node.i();
+    Node invalid(line2, line3.substr(0, 60));
+    // Counters of finished threads are kept
+    std::thread thread([&node]() { node.e(); });
+    thread.join();
+
+    Stats stats = Stats::collect();
+    if (!Stats::enabled())
+    {
+        EXPECT_EQ(0, stats.value(Stats::FieldParses));
+        return;
+    }
+
+    EXPECT_EQ(3, stats.value(Stats::FieldParses));
+    EXPECT_EQ(2, stats.value(Stats::CacheHits));
+    EXPECT_EQ(1, stats.errors(Node::TooShortString));
+
+    std::stringstream lines(line2 + "\n" + line3 + "\n");
+    Stream tle(lines);
+    DataSet dataSet;
+    tle >> dataSet;
+    dataSet.nearestNode(0);
+
+    stats = Stats::collect();
+    EXPECT_EQ(1, stats.value(Stats::RecordsRead));
+    EXPECT_EQ(2, stats.value(Stats::DataSetSearches));
+    EXPECT_EQ(2, stats.value(Stats::DataSetProbes));
+
+    std::stringstream json;
+    stats.printJson(json);
+    EXPECT_NE(std::string::npos, json.str().find("\"records_read\": 1"));
+
+    Stats::reset();
+    EXPECT_EQ(0, Stats::collect().value(Stats::FieldParses));
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <atomic>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/threadpool.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(ThreadPoolTest, submit)
+{
+    ThreadPool pool(4);
+    EXPECT_EQ(4, pool.threadsCount());
+
+    std::atomic<int> counter(0);
+    for (int i = 0; i < 1000; ++i)
+        pool.submit([&counter]() { ++counter; });
+    pool.wait();
+
+    EXPECT_EQ(1000, counter);
+}
+//------------------------------------------------------------------------------
+
+TEST(ThreadPoolTest, parallelFor)
+{
+    ThreadPool pool(3);
+    std::vector<int> values(10007, 0);
+    pool.parallelFor(0, values.size(),
+                     [&values](std::size_t i) { values[i] += i; });
+
+    for (std::size_t i = 0; i < values.size(); ++i)
+        ASSERT_EQ(i, values[i]);
+
+    // Empty range
+    pool.parallelFor(5, 5, [&values](std::size_t i) { values[i] = -1; });
+    EXPECT_EQ(5, values[5]);
+}
+//------------------------------------------------------------------------------
+
+TEST(ThreadPoolTest, parallelFor2D)
+{
+    // Uneven cost of rows: every cell must be processed exactly once
+    const std::size_t rows = 37;
+    const std::size_t columns = 101;
+    std::vector<std::atomic<int> > cells(rows * columns);
+    for (std::size_t i = 0; i < cells.size(); ++i)
+        cells[i] = 0;
+
+    ThreadPool pool(4);
+    pool.parallelFor(rows, columns,
+                     [&cells, columns](std::size_t row, std::size_t column)
+                     {
+                         volatile double sum = 0;
+                         for (std::size_t k = 0; k < (row % 5) * 100; ++k)
+                             sum += k;
+                         ++cells[row * columns + column];
+                     },
+                     7);
+
+    for (std::size_t i = 0; i < cells.size(); ++i)
+        ASSERT_EQ(1, cells[i]);
+}
+//------------------------------------------------------------------------------
+
+TEST(ThreadPoolTest, nested)
+{
+    ThreadPool pool(2);
+    std::atomic<int> counter(0);
+    pool.parallelFor(0, 8,
+                     [&pool, &counter](std::size_t)
+                     {
+                         pool.parallelFor(0, 100,
+                                          [&counter](std::size_t)
+                                          {
+                                              ++counter;
+                                          });
+                     },
+                     1);
+
+    EXPECT_EQ(800, counter);
+}
+//------------------------------------------------------------------------------
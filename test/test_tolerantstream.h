@@ -0,0 +1,106 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/generator.h>
+#include <quicktle/tolerantstream.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(TolerantStreamTest, read)
+{
+    Generator generator(31);
+    generator.setSatellitesCount(10);
+    generator.setFileType(ThreeLines);
+    std::ostringstream output;
+    generator.write(output);
+
+    std::vector<std::string> lines;
+    std::istringstream generated(output.str());
+    for (std::string line; std::getline(generated, line);)
+        lines.push_back(line);
+    ASSERT_EQ(30, lines.size());
+
+    std::string broken = lines[7];
+    broken[68] = (broken[68] == '0') ? '1' : '0';
+
+    std::ostringstream text;
+    // Valid record with CRLF and trailing spaces
+    text << lines[0] << " \r\n" << lines[1] << "\t\r\n"
+         << lines[2] << "  \r\n\r\n";
+    // Valid 2-lines record
+    text << lines[4] << '\n' << lines[5] << "\n\n\n";
+    // Checksum error, then the valid record
+    text << lines[6] << '\n' << broken << '\n' << lines[8] << '\n';
+    text << lines[9] << '\n' << lines[10] << '\n' << lines[11] << '\n';
+    // Truncated line
+    text << lines[12] << '\n' << lines[13].substr(0, 40) << '\n'
+         << lines[14] << '\n';
+    // Missing line, the next record should be found
+    text << lines[15] << '\n' << lines[16] << '\n';
+    text << lines[18] << '\n' << lines[19] << '\n' << lines[20] << '\n';
+    // Orphan line
+    text << lines[23] << '\n';
+    text << lines[24] << '\n' << lines[25] << '\n' << lines[26] << '\n';
+    // Long name, no line feed at the end
+    text << std::string(100, 'X') << '\n' << lines[28] << '\n' << lines[29];
+
+    const std::size_t expected[] = {0, 1, 3, 6, 8, 9};
+    std::istringstream source(text.str());
+    TolerantStream stream(source);
+    stream.enforceParsing(true);
+    Node node;
+    std::size_t count = 0;
+    while (stream)
+    {
+        stream >> node;
+        ASSERT_LT(count, 6);
+        const std::size_t k = expected[count++];
+        EXPECT_EQ(Node::NoError, node.lastError());
+        EXPECT_EQ(lines[3 * k + 1].substr(2, 5), node.satelliteNumber());
+        if (k == 1)
+            EXPECT_TRUE(node.satelliteName().empty());
+        else if (k == 9)
+            EXPECT_EQ(std::string(24, 'X'), node.satelliteName());
+        else
+            EXPECT_EQ(0, lines[3 * k].find(node.satelliteName()));
+    }
+    EXPECT_EQ(6, count);
+    EXPECT_EQ(6, stream.recordsCount());
+    EXPECT_EQ(3, stream.brokenRecordsCount());
+    EXPECT_EQ(9, stream.skippedLinesCount());
+
+    // No more records: the node is not changed
+    stream >> node;
+    EXPECT_EQ(lines[28].substr(2, 5), node.satelliteNumber());
+
+    Catalog catalog;
+    std::istringstream again(text.str());
+    TolerantStream reader(again);
+    while (reader)
+        reader >> catalog;
+    EXPECT_EQ(6, catalog.nodesCount());
+}
+//------------------------------------------------------------------------------
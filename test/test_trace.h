@@ -0,0 +1,79 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <sstream>
+#include <string>
+#include <thread>
+#include <gtest/gtest.h>
+#include <quicktle/dataset.h>
+#include <quicktle/stream.h>
+#include <quicktle/trace.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(TraceTest, spans)
+{
+    std::string line2 = "1 16609U 86017A   86053.30522506  .00057349"
+            "  00000-0  31166-3 0   112";
+    std::string line3 = "2 16609  51.6129 108.0599 0012107 160.8295"
+            " 196.0076 15.79438158   394";
+    std::string lines = line2 + "\n" + line3 + "\n";
+
+    // Nothing is recorded while the tracing is disabled
+    Trace::clear();
+    {
+        std::stringstream source(lines);
+        Stream tle(source);
+        DataSet dataSet;
+        tle >> dataSet;
+    }
+    std::stringstream json;
+    EXPECT_TRUE(Trace::write(json));
+    EXPECT_EQ(std::string::npos, json.str().find("Stream::read"));
+
+    Trace::enable();
+    {
+        std::stringstream source(lines);
+        Stream tle(source);
+        DataSet dataSet;
+        tle >> dataSet;
+        // Spans of finished threads are kept
+        std::thread thread([]() { TraceSpan span("worker"); });
+        thread.join();
+    }
+    Trace::enable(false);
+
+    json.str("");
+    EXPECT_TRUE(Trace::write(json));
+    const std::string trace = json.str();
+    EXPECT_EQ(0, trace.find("{\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"Stream::read\""));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"Node::assign\""));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"DataSet::append\""));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"worker\""));
+    EXPECT_NE(std::string::npos, trace.find("\"ph\":\"X\""));
+
+    Trace::clear();
+    json.str("");
+    Trace::write(json);
+    EXPECT_EQ(std::string::npos, json.str().find("\"name\":"));
+}
@@ -0,0 +1,127 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include <quicktle/func.h>
+#include <quicktle/generator.h>
+#include <quicktle/validator.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+namespace
+{
+    //! Replace the part of the line and correct the checksum
+    std::string patchLine(std::string line, std::size_t index,
+                          const std::string &text)
+    {
+        line.replace(index, text.length(), text);
+        line[68] = '0' + checksum(line.substr(0, 68));
+        return line;
+    }
+}
+
+TEST(ValidatorTest, validCatalog)
+{
+    Generator generator(7);
+    generator.setSatellitesCount(300);
+    generator.setEpochsCount(2);
+    generator.setFileType(ThreeLines);
+    std::stringstream catalog;
+    generator.write(catalog);
+    const std::string text = catalog.str();
+
+    Validator validator(ThreeLines);
+    EXPECT_TRUE(validator.scan(text.data(), text.length()));
+    EXPECT_EQ(600, validator.recordsCount());
+    EXPECT_EQ(0, validator.invalidRecordsCount());
+    EXPECT_TRUE(validator.errors().empty());
+
+    // Block boundaries of the stream fall inside the lines
+    std::stringstream stream(text + "\r\n");
+    EXPECT_TRUE(validator.scan(stream));
+    EXPECT_EQ(600, validator.recordsCount());
+}
+//------------------------------------------------------------------------------
+
+TEST(ValidatorTest, issues)
+{
+    std::string line2 = "1 16609U 86017A   86053.30522506  .00057349"
+            "  00000-0  31166-3 0   112";
+    std::string line3 = "2 16609  51.6129 108.0599 0012107 160.8295"
+            " 196.0076 15.79438158   394";
+    std::string record = line2 + "\n" + line3 + "\n";
+
+    std::string badChecksum = line3;
+    badChecksum[68] = '5';
+    std::string text = record
+                     + patchLine(line2, 20, "x") + "\n" + line3 + "\n"
+                     + line2 + "\n" + badChecksum + "\n"
+                     + line2 + "\n" + patchLine(line3, 2, "16610") + "\n"
+                     + line2.substr(0, 40) + "\n" + line3 + "\n"
+                     + line3 + "\n" + line3 + "\n"
+                     + "\n" + record
+                     + line2 + " \xe9\n" + line3 + "\n"
+                     + patchLine(line2, 7, "\xc3") + "\n" + line3 + "\n"
+                     + line2;
+
+    Validator validator;
+    EXPECT_FALSE(validator.scan(text.data(), text.length()));
+    EXPECT_EQ(10, validator.recordsCount());
+    EXPECT_EQ(8, validator.invalidRecordsCount());
+
+    const std::vector<Validator::Error> &errors = validator.errors();
+    ASSERT_EQ(8, errors.size());
+    EXPECT_EQ(3, errors[0].line);
+    EXPECT_EQ(21, errors[0].column);
+    EXPECT_EQ(Validator::InvalidField, errors[0].issue);
+    EXPECT_EQ(6, errors[1].line);
+    EXPECT_EQ(Validator::ChecksumMismatch, errors[1].issue);
+    EXPECT_EQ(8, errors[2].line);
+    EXPECT_EQ(Validator::SatelliteNumberMismatch, errors[2].issue);
+    EXPECT_EQ(9, errors[3].line);
+    EXPECT_EQ(Validator::TooShortLine, errors[3].issue);
+    EXPECT_EQ(11, errors[4].line);
+    EXPECT_EQ(Validator::InvalidLineNumber, errors[4].issue);
+    EXPECT_EQ(16, errors[5].line);
+    EXPECT_EQ(70, errors[5].column);
+    EXPECT_EQ(Validator::TooLongLine, errors[5].issue);
+    // Non-ASCII classification
+    EXPECT_EQ(18, errors[6].line);
+    EXPECT_EQ(8, errors[6].column);
+    EXPECT_EQ(Validator::InvalidField, errors[6].issue);
+    EXPECT_EQ(20, errors[7].line);
+    EXPECT_EQ(Validator::IncompleteRecord, errors[7].issue);
+
+    std::stringstream report;
+    validator.print(report);
+    EXPECT_NE(std::string::npos,
+              report.str().find("line 6, column 69: checksum mismatch"));
+
+    validator.setMaxErrors(2);
+    validator.scan(text.data(), text.length());
+    EXPECT_EQ(2, validator.errors().size());
+    EXPECT_EQ(8, validator.invalidRecordsCount());
+
+    EXPECT_FALSE(validator.scanFile("nonexistent.tle"));
+}
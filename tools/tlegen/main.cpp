@@ -0,0 +1,71 @@
+/*
+  Generator of synthetic TLE catalogs for load testing.
+
+  Usage:
+      tlegen [-n satellites] [-e epochs] [-s seed] [-t step_hours] [-3]
+             [-o file]
+
+  The catalog is written into the standard output if the output file
+  is not specified.
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <quicktle/generator.h>
+
+using namespace std;
+
+static void usage()
+{
+    cerr << "Usage: tlegen [-n satellites] [-e epochs] [-s seed]"
+            " [-t step_hours] [-3] [-o file]" << endl;
+}
+
+int main(int argc, char** argv)
+{
+    quicktle::Generator generator;
+    string fileName;
+    for (int i = 1; i < argc; ++i)
+    {
+        const string arg = argv[i];
+        if (arg == "-3")
+        {
+            generator.setFileType(quicktle::ThreeLines);
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            usage();
+            return 1;
+        }
+
+        const char *value = argv[++i];
+        if (arg == "-n")
+            generator.setSatellitesCount(strtoull(value, 0, 10));
+        else if (arg == "-e")
+            generator.setEpochsCount(strtoull(value, 0, 10));
+        else if (arg == "-t")
+            generator.setEpochStep(atof(value) * 3600);
+        else if (arg == "-s")
+            generator.setSeed(strtoull(value, 0, 10));
+        else if (arg == "-o")
+            fileName = value;
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (fileName.empty())
+    {
+        std::ios::sync_with_stdio(false);
+        generator.write(cout);
+        return cout.good() ? 0 : 2;
+    }
+
+    return generator.write(fileName) ? 0 : 2;
+}
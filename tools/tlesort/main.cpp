@@ -0,0 +1,100 @@
+/*
+  Sorting of TLE archives, which do not fit in memory.
+
+  Usage:
+      tlesort [-3] [-m memory_mb] [-j threads] [-T temp_dir] [-o file]
+              input...
+
+  The records of the input files are sorted by satellite number and
+  epoch, the duplicates are removed. The result is written into the
+  standard output if the output file is not specified.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <quicktle/archivesorter.h>
+
+using namespace std;
+
+static void usage()
+{
+    cerr << "Usage: tlesort [-3] [-m memory_mb] [-j threads] [-T temp_dir]"
+            " [-o file] input..." << endl;
+}
+
+int main(int argc, char** argv)
+{
+    quicktle::FileType fileType = quicktle::TwoLines;
+    size_t memoryLimit = 0;
+    size_t threadsCount = 0;
+    string directory;
+    string fileName;
+    vector<string> inputs;
+    for (int i = 1; i < argc; ++i)
+    {
+        const string arg = argv[i];
+        if (arg == "-3")
+        {
+            fileType = quicktle::ThreeLines;
+            continue;
+        }
+
+        if (arg.empty() || arg[0] != '-')
+        {
+            inputs.push_back(arg);
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            usage();
+            return 1;
+        }
+
+        const char *value = argv[++i];
+        if (arg == "-m")
+            memoryLimit = strtoull(value, 0, 10) << 20;
+        else if (arg == "-j")
+            threadsCount = strtoull(value, 0, 10);
+        else if (arg == "-T")
+            directory = value;
+        else if (arg == "-o")
+            fileName = value;
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (inputs.empty())
+    {
+        usage();
+        return 1;
+    }
+
+    quicktle::ArchiveSorter sorter(fileType);
+    if (memoryLimit)
+        sorter.setMemoryLimit(memoryLimit);
+    if (!directory.empty())
+        sorter.setTemporaryDirectory(directory);
+    sorter.setThreadsCount(threadsCount);
+
+    bool ok;
+    if (fileName.empty())
+    {
+        std::ios::sync_with_stdio(false);
+        ok = sorter.sort(inputs, cout);
+    }
+    else
+    {
+        ok = sorter.sort(inputs, fileName);
+    }
+
+    cerr << sorter.recordsCount() << " records, "
+         << sorter.duplicatesCount() << " duplicates, "
+         << sorter.skippedCount() << " skipped" << endl;
+    return ok ? 0 : 2;
+}